@@ -3,27 +3,70 @@
 // embedded_resources.h - Interface para recursos embarcados
 // =============================================================================
 // Este header é gerado manualmente e provê a interface.
-// Os dados são gerados automaticamente pelo CMake (EmbedFile.cmake).
+// Os dados são gerados pelo tool pack_resources (tools/pack_resources.cpp),
+// que empacota toda a árvore ui/dist num único arquivo: cada asset é
+// armazenado comprimido (Brotli) quando compensa, e o índice de paths é
+// gerado já ordenado para busca binária.
 // =============================================================================
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
 #include <string_view>
 
 namespace embedded {
 
-// Declarações - definições estão no .cpp gerado pelo CMake
-extern const unsigned char index_html_data[];
-[[maybe_unused]] extern const std::size_t index_html_size;
-const char *index_html_str();
+enum class Encoding : std::uint8_t { Identity = 0, Brotli = 1 };
 
-// Wrapper conveniente para C++17+
-inline std::string_view index_html_view() {
-    return {index_html_str(), index_html_size};
+struct AssetEntry {
+    std::string_view path;     // ex: "/assets/index-abc123.js"
+    const unsigned char *data; // bytes armazenados (comprimidos ou não)
+    std::size_t stored_size;
+    std::size_t raw_size;
+    Encoding encoding;
+    std::string_view etag; // ETag forte do conteúdo descomprimido
+};
+
+// Declarações - definições estão no .cpp gerado pelo pack_resources
+// (asset_entries é ordenado por path)
+extern const AssetEntry asset_entries[];
+extern const std::size_t asset_count;
+
+inline std::span<const AssetEntry> assets() {
+    return {asset_entries, asset_count};
 }
 
-} // namespace embedded
+// Busca binária no índice ordenado; nullptr se o path não existe
+inline const AssetEntry *find_asset(std::string_view path) {
+    const auto all = assets();
+    const auto it = std::lower_bound(
+        all.begin(), all.end(), path,
+        [](const AssetEntry &entry, std::string_view key) {
+            return entry.path < key;
+        });
+    if (it == all.end() || it->path != path) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+// Bytes exatamente como armazenados (ex: para repassar Brotli adiante)
+inline std::string_view stored_bytes(const AssetEntry &entry) {
+    return {reinterpret_cast<const char *>(entry.data), entry.stored_size};
+}
+
+// Conteúdo descomprimido. A descompressão acontece uma vez por asset e o
+// resultado fica num cache do processo compartilhado por todas as janelas,
+// então a view retornada vive até o fim do programa.
+// Implementado em src/embedded_resources.cpp.
+std::string_view contents(const AssetEntry &entry);
 
-// Alias para compatibilidade com código existente
-// Antes: INDEX_HTML (string literal)
-// Agora: INDEX_HTML (const char*)
-#define INDEX_HTML (::embedded::index_html_str())
+// Wrapper conveniente para o fallback set_html
+inline std::string index_html() {
+    const AssetEntry *entry = find_asset("/index.html");
+    return entry ? std::string(contents(*entry)) : std::string();
+}
+
+} // namespace embedded
@@ -3,21 +3,45 @@
 // Application - Classe principal que encapsula a lógica do app
 // =============================================================================
 
+#include "app/base64.h"
+#include "app/binary_channel.h"
+#include "app/blob_store.h"
 #include "app/cli_options.h"
 #include "app/config.h"
+#include "app/executor.h"
 #include "app/handlers.h"
-#include "app/shutdown_monitor.h"
+#include "app/job_manager.h"
+#include "app/log.h"
+#include "app/main_loop.h"
+#include "app/metrics.h"
+#include "app/resource_server.h"
+#include "app/scheme_handler.h"
+#include "app/shutdown_coordinator.h"
+#include "app/signal_watcher.h"
+#include "app/splash.h"
+#include "app/stack_sampler.h"
+#include "app/stall_watchdog.h"
+#include "app/startup_profiler.h"
+#include "app/state_store.h"
+#include "app/tracing.h"
 #include "app/window_manager.h"
 #include "dev_server.h"
 #include "webview/webview.h"
+#include <algorithm>
+#include <array>
 #include <atomic>
-#include <condition_variable>
-#include <csignal>
-#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <stop_token>
 #include <string>
+#include <unordered_set>
 
 // Em produção, inclui o header com o HTML embutido
 #if !defined(APP_DEV_MODE) && !defined(APP_NO_EMBEDDED_UI)
@@ -34,7 +58,38 @@ class Application {
     // Construtor com opções da CLI
     explicit Application(const Options &opts)
         : options_(opts), dev_mode_(resolve_dev_mode(opts)),
-          verbose_(opts.verbose) {}
+          profiler_(opts.profile_startup), blobs_(blob_options(opts)) {
+        log::set_level(opts.verbose ? log::Level::Debug : log::Level::Info);
+        trace::set_enabled(opts.trace);
+        if (opts.stall_threshold_ms >= 0) {
+            watchdog_.set_threshold(
+                std::chrono::milliseconds(opts.stall_threshold_ms));
+        }
+        if (opts.shutdown_timeout_ms > 0) {
+            shutdown_.set_deadline(
+                std::chrono::milliseconds(opts.shutdown_timeout_ms));
+        }
+        register_jobs(jobs_, handlers_, blobs_);
+        jobs_.set_sink([this](const std::string &window_id, std::string event) {
+            executor().post_to_ui(
+                [this, window_id, event = std::move(event)]() mutable {
+                    if (window_manager_) {
+                        window_manager_->post_raw_event(window_id,
+                                                        std::move(event));
+                    }
+                });
+        });
+        state_.set_sink([this](const std::string &window_id,
+                               std::string event) {
+            executor().post_to_ui(
+                [this, window_id, event = std::move(event)]() mutable {
+                    if (window_manager_) {
+                        window_manager_->post_raw_event(window_id,
+                                                        std::move(event));
+                    }
+                });
+        });
+    }
 
     ~Application() { cleanup(); }
 
@@ -49,15 +104,26 @@ class Application {
     // =========================================================================
     bool initialize() {
         log_mode();
+        startup_begin_ = profiler_.origin();
+        trace::set_thread_name("ui");
 
         // Configura signal handlers para graceful shutdown
-        setup_signal_handlers();
+        {
+            StartupProfiler::Scope span(&profiler_, "signal-handlers");
+            setup_signal_handlers();
+        }
 
-        if (dev_mode_ && !start_dev_server()) {
-            return false;
+        // O Vite sobe em segundo plano enquanto a webview é criada; a janela
+        // mostra um splash até ele ficar pronto (ver load_content)
+        if (dev_mode_) {
+            start_dev_server();
         }
 
-        return create_window();
+        load_persisted_state();
+        const bool created = create_window();
+        webview_ms_ = elapsed_ms(startup_begin_);
+        APP_LOG_DEBUG("APP", "Startup: webview criada em ", webview_ms_, "ms");
+        return created;
     }
 
     // =========================================================================
@@ -65,35 +131,39 @@ class Application {
     // =========================================================================
     int run() {
         if (!window_) {
-            std::cerr << "[APP] Erro: janela não inicializada" << std::endl;
+            APP_LOG_ERROR("APP", "Erro: janela não inicializada");
             return 1;
         }
 
+        int status = 0;
         try {
-            load_content();
-            std::cout << "[APP] Iniciando event loop..." << std::endl;
-
-            // Inicia ShutdownMonitor (classe separada)
-            ShutdownMonitor shutdown_monitor(
-                [this]() { return should_shutdown(); },
-                [this]() {
-                    if (window_) {
-                        window_->terminate();
-                    }
-                });
+            {
+                StartupProfiler::Scope span(&profiler_, "load-content");
+                load_content();
+            }
+            APP_LOG_INFO("APP", "Iniciando event loop...");
+            profiler_.mark("event-loop");
+            start_metrics_dump();
+            start_watchdog();
 
-            // Executa o loop principal da webview
-            window_->run();
+            // Sinal durante a inicialização: pula direto para o fim do
+            // shutdown. A partir daqui on_shutdown_signal conduz as fases
+            // com o loop rodando (sem thread de monitoramento).
+            if (!shutdown_requested_.load() && !dev_server_failed_) {
+                window_->run();
+            }
+            if (dev_server_failed_) {
+                status = 1;
+            }
         } catch (const webview::exception &e) {
-            std::cerr << "[APP] Erro WebView: " << e.what() << std::endl;
-            shutdown_cv_.notify_all();
-            return 1;
+            APP_LOG_ERROR("APP", "Erro WebView: ", e.what());
+            status = 1;
         } catch (const std::exception &e) {
-            std::cerr << "[APP] Erro inesperado: " << e.what() << std::endl;
-            shutdown_cv_.notify_all();
+            APP_LOG_ERROR("APP", "Erro inesperado: ", e.what());
         }
 
-        return 0;
+        finish_shutdown();
+        return status;
     }
 
   private:
@@ -102,27 +172,307 @@ class Application {
     // =========================================================================
 
     void log_mode() const {
-        std::cout << "[APP] Modo: "
-                  << (dev_mode_ ? "DEVELOPMENT" : "PRODUCTION") << std::endl;
+        APP_LOG_INFO("APP", "Modo: ",
+                     dev_mode_ ? "DEVELOPMENT" : "PRODUCTION");
     }
 
-    bool start_dev_server() {
+    // =========================================================================
+    // Dev server em segundo plano
+    // =========================================================================
+    // Tarefa Background do executor (a espera observa o stop_token). Só mexe
+    // em dev_server_ e no estado sob dev_mu_. Se o splash já está na tela
+    // quando o Vite fica pronto (ou falha), devolve on_dev_server_settled
+    // para a UI; senão load_content chama direto.
+
+    enum class DevServerStatus { Pending, Ready, Failed };
+
+    void start_dev_server() {
         dev::ServerConfig cfg = dev::get_default_config();
         dev_url_ = cfg.dev_url;
+        if (options_.cross_origin_isolated) {
+            // Lido pelo vite.config.js para enviar COOP/COEP no dev server
+            cfg.environment.emplace_back("APP_CROSS_ORIGIN_ISOLATED", "1");
+        }
 
-        if (!dev::ensure_server_running(cfg, dev_server_)) {
-            std::cerr << "[APP] Falha ao iniciar dev server. Abortando."
-                      << std::endl;
-            return false;
+        dev_task_ = executor().submit(
+            Lane::Background, "dev-server",
+            [this, cfg = std::move(cfg)](std::stop_token stop) {
+                const auto begin = std::chrono::steady_clock::now();
+                const bool ready =
+                    dev::ensure_server_running(cfg, dev_server_, stop);
+                profiler_.span("dev-server", begin,
+                               std::chrono::steady_clock::now(),
+                               StartupProfiler::DevServer);
+                bool dispatch = false;
+                {
+                    std::lock_guard<std::mutex> lock(dev_mu_);
+                    dev_status_ = ready ? DevServerStatus::Ready
+                                        : DevServerStatus::Failed;
+                    dev_server_ms_ = elapsed_ms(startup_begin_);
+                    dispatch = splash_shown_ && !stop.stop_requested();
+                }
+                if (dispatch) {
+                    executor().post_to_ui([this] { on_dev_server_settled(); });
+                }
+            });
+    }
+
+    // Cancela a espera (encerrando o Vite que iniciamos) e aguarda a tarefa
+    void stop_dev_server_task() {
+        dev_task_.cancel();
+        dev_task_.wait();
+    }
+
+    // Thread da UI, uma única vez por execução
+    void on_dev_server_settled() {
+        DevServerStatus status = DevServerStatus::Pending;
+        long long server_ms = 0;
+        {
+            std::lock_guard<std::mutex> lock(dev_mu_);
+            status = dev_status_;
+            server_ms = dev_server_ms_;
+        }
+        if (status != DevServerStatus::Ready) {
+            APP_LOG_ERROR("APP", "Falha ao iniciar dev server. Abortando.");
+            dev_server_failed_ = true;
+            if (splash_shown_) {
+                window_->terminate();
+            }
+            return;
+        }
+
+        // O Vite pode ter subido em outra porta (lida da saída dele)
+        if (!dev_server_.url.empty()) {
+            dev_url_ = dev_server_.url;
+        }
+        if (window_manager_) {
+            window_manager_->set_dev_url(dev_url_);
+        }
+        APP_LOG_INFO("APP", "Startup: dev server ", server_ms, "ms, webview ",
+                     webview_ms_, "ms, navegando após ",
+                     elapsed_ms(startup_begin_), "ms");
+        APP_LOG_INFO("APP", "Navegando para ", dev_url_);
+        profiler_.mark("navigate");
+        window_->navigate(dev_url_);
+        showing_splash_ = false;
+    }
+
+    // =========================================================================
+    // Blobs (putBlob/getBlob)
+    // =========================================================================
+
+    static BlobStore::Options blob_options(const Options &opts) {
+        BlobStore::Options out;
+        out.memory_cap =
+            static_cast<std::size_t>(config::BLOB_MEMORY_CAP_MB) * 1024 * 1024;
+        out.spill_dir = opts.blob_spill_dir;
+        return out;
+    }
+
+    // `options`: {encoding: "utf8" | "base64", type: MIME}. A URL app:// só
+    // existe com a UI servida pelo esquema.
+    app::bindings::json put_blob(const std::string &window_id,
+                                 const std::string &data,
+                                 const app::bindings::json &options) {
+        std::string encoding = "utf8";
+        std::string mime;
+        if (options.is_object()) {
+            encoding = options.value("encoding", encoding);
+            mime = options.value("type", mime);
+        }
+        std::string bytes;
+        if (encoding == "base64") {
+            auto decoded = base64_decode(data);
+            if (!decoded) {
+                throw app::bindings::BindingError(
+                    "Invalid base64 data",
+                    app::bindings::ErrorCode::InvalidArgs);
+            }
+            bytes = std::move(*decoded);
+        } else if (encoding == "utf8") {
+            bytes = data;
+        } else {
+            throw app::bindings::BindingError(
+                "Unknown encoding: " + encoding,
+                app::bindings::ErrorCode::InvalidArgs);
+        }
+        const std::size_t size = bytes.size();
+        // "type" é o guardado: conteúdo repetido mantém o do primeiro put
+        const auto blob =
+            blobs_.put(window_id, std::move(bytes), std::move(mime));
+        const std::string &handle = blob.handle;
+        return {{"handle", handle},
+                {"type", blob.mime},
+                {"size", size},
+                {"url", scheme_registered_
+                            ? app::bindings::json(std::string(BLOB_URL_BASE) +
+                                                  handle)
+                            : app::bindings::json(nullptr)}};
+    }
+
+    // Resposta montada por concatenação: o conteúdo é serializado uma vez
+    app::bindings::RawJson get_blob(const std::string &handle,
+                                    const std::string &encoding) {
+        auto blob = blobs_.get(handle);
+        if (!blob) {
+            throw app::bindings::BindingError(
+                "Blob not found: " + handle,
+                app::bindings::ErrorCode::MissingArg);
+        }
+        const bool base64 = encoding == "base64";
+        auto text = std::make_shared<std::string>();
+        *text += app::bindings::json{{"handle", blob->handle},
+                                     {"type", blob->mime},
+                                     {"size", blob->data->size()},
+                                     {"encoding", base64 ? "base64" : "utf8"}}
+                     .dump();
+        text->pop_back();
+        *text += R"(,"data":)";
+        *text += base64
+                     ? '"' + base64_encode(*blob->data) + '"'
+                     : app::bindings::json(*blob->data)
+                           .dump(-1, ' ', false,
+                                 app::bindings::json::error_handler_t::replace);
+        *text += '}';
+        return app::bindings::RawJson{std::move(text)};
+    }
+
+    // =========================================================================
+    // --profile-startup
+    // =========================================================================
+
+    // Fecha o span `name` iniciado em `begin`; devolve o início do próximo
+    std::chrono::steady_clock::time_point
+    profile_phase(std::string name,
+                  std::chrono::steady_clock::time_point begin) {
+        const auto now = std::chrono::steady_clock::now();
+        profiler_.span(std::move(name), begin, now);
+        return now;
+    }
+
+    // Marcos do JS (DOMContentLoaded, first paint): o timestamp é o da
+    // chegada no nativo; o performance.now() da página vai nos args
+    void on_startup_mark(const std::string &window_id, const std::string &name,
+                         double js_ms) {
+        profiler_.mark("js " + window_id + ": " + name, StartupProfiler::Js,
+                       {{"windowId", window_id}, {"performanceNowMs", js_ms}});
+        if (window_id == "main" && name == "first-paint") {
+            report_startup_profile();
+        }
+    }
+
+    // Imprime o breakdown e grava o trace. Chamado no first paint da janela
+    // principal e de novo no shutdown se chegaram eventos depois (janelas
+    // filhas, ou a UI nunca pintou).
+    void report_startup_profile() {
+        const std::size_t count = profiler_.size();
+        if (!profiler_.enabled() || count == reported_events_) {
+            return;
+        }
+        reported_events_ = count;
+        APP_LOG_INFO("PROFILE", "Startup:\n", profiler_.breakdown());
+        if (trace::write_chrome_trace(config::STARTUP_TRACE_FILE,
+                                      profiler_.chrome_events(),
+                                      StartupProfiler::thread_names())) {
+            APP_LOG_INFO("PROFILE", "Trace gravado em ",
+                         config::STARTUP_TRACE_FILE);
+        } else {
+            APP_LOG_ERROR("PROFILE", "Falha ao gravar ",
+                          config::STARTUP_TRACE_FILE);
+        }
+    }
+
+    // --metrics-interval: reescreve config::METRICS_FILE periodicamente numa
+    // tarefa Background (o registro só lê atomics; o I/O fica fora da UI)
+    void start_metrics_dump() {
+        if (options_.metrics_interval_s <= 0) {
+            return;
+        }
+        const std::chrono::milliseconds interval =
+            std::chrono::seconds(options_.metrics_interval_s);
+        metrics_task_ = executor().schedule_periodic(
+            interval, Lane::Background, "metrics-dump",
+            [interval](std::stop_token)
+                -> std::optional<std::chrono::milliseconds> {
+                dump_metrics();
+                return interval;
+            });
+    }
+
+    // Heartbeat no main loop + thread de vigia. Sem main loop (timer 0) não
+    // há o que vigiar.
+    void start_watchdog() {
+        if (watchdog_.threshold().count() <= 0) {
+            return;
+        }
+        const auto interval =
+            std::chrono::milliseconds(config::STALL_HEARTBEAT_MS);
+        heartbeat_timer_ = add_ui_timer(interval, [this] {
+            watchdog_.heartbeat();
+            return true;
+        });
+        if (heartbeat_timer_ == 0) {
+            return;
+        }
+        if (install_stack_sampler()) {
+            watchdog_.set_stack_sampler(
+                [] { return sample_target_stack(STACK_SAMPLE_TIMEOUT); });
+        }
+        watchdog_.set_listener(log_stall);
+        watchdog_.heartbeat();
+        watchdog_.start(interval);
+    }
+
+    static void log_stall(const StallReport &report) {
+        const std::string task =
+            report.task.empty() ? "tarefa não instrumentada" : report.task;
+        if (!report.ongoing) {
+            APP_LOG_WARN("WATCHDOG", "Main loop liberado após ",
+                         report.duration.count(), "ms (", task, ")");
+            return;
         }
+        std::string stack;
+        const std::size_t frames =
+            std::min(report.stack.size(), STALL_LOG_FRAMES);
+        for (std::size_t i = 0; i < frames; ++i) {
+            stack += "\n    ";
+            stack += report.stack[i];
+        }
+        APP_LOG_WARN("WATCHDOG", "Main loop travado há ",
+                     report.duration.count(), "ms em ", task, stack);
+    }
+
+    static void dump_metrics() {
+        if (!metrics::registry().write_text(config::METRICS_FILE)) {
+            APP_LOG_ERROR("METRICS", "Falha ao gravar ", config::METRICS_FILE);
+        }
+    }
+
+    // Grava os anéis do tracing (--trace) em config::TRACE_FILE
+    static bool dump_native_trace() {
+        if (trace::dump(config::TRACE_FILE)) {
+            APP_LOG_INFO("TRACE", "Trace gravado em ", config::TRACE_FILE);
+            return true;
+        }
+        APP_LOG_ERROR("TRACE", "Falha ao gravar ", config::TRACE_FILE);
+        return false;
+    }
 
-        return true;
+    static long long elapsed_ms(std::chrono::steady_clock::time_point since) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now() - since)
+            .count();
     }
 
     bool create_window() {
         try {
             // DevTools habilitado apenas em dev
+            auto phase = std::chrono::steady_clock::now();
             window_ = std::make_unique<webview::webview>(dev_mode_, nullptr);
+            executor().set_ui_dispatcher(
+                [w = window_.get()](std::function<void()> fn) {
+                    w->dispatch(std::move(fn));
+                });
             window_->set_title(config::WINDOW_TITLE);
 
             // Usa tamanho das opções CLI ou padrão do config
@@ -132,19 +482,38 @@ class Application {
                 options_.height > 0 ? options_.height : config::WINDOW_HEIGHT;
             window_->set_size(width, height, WEBVIEW_HINT_NONE);
             window_->init("window.__APP_WINDOW_ID__ = \"main\";");
+            phase = profile_phase("create-webview", phase);
+            setup_resource_scheme();
+            phase = profile_phase("resource-scheme", phase);
 
             // Setup window manager and bindings
             window_manager_ = std::make_unique<WindowManager>(
                 *window_, dev_mode_, dev_url_, options_.url, width, height,
                 config::WINDOW_TITLE);
+            if (scheme_registered_) {
+                window_manager_->set_embedded_url(
+                    std::string(resources::ENTRY_URL));
+            }
             window_manager_->set_bindings_setup(
                 [this](webview::webview &w) { setup_bindings(w); });
+            window_manager_->set_startup_profiler(&profiler_);
+            window_manager_->set_closed_listener(
+                [this](const std::string &window_id) {
+                    jobs_.cancel_window(window_id);
+                    blobs_.release_owner(window_id);
+                    state_.remove_window(window_id);
+                    // Layout publicado por ela e movimentos de painéis que
+                    // não chegou a consumir
+                    state_.erase("layout/" + window_id);
+                    state_.erase_prefix("dock/inbox/" + window_id + "/");
+                });
+            phase = profile_phase("window-manager", phase);
             setup_bindings(*window_);
+            profile_phase("register-bindings", phase);
 
             return true;
         } catch (const webview::exception &e) {
-            std::cerr << "[APP] Erro ao criar janela: " << e.what()
-                      << std::endl;
+            APP_LOG_ERROR("APP", "Erro ao criar janela: ", e.what());
             return false;
         }
     }
@@ -152,42 +521,93 @@ class Application {
     void load_content() {
         // URL customizada tem prioridade
         if (!options_.url.empty()) {
-            std::cout << "[APP] Navegando para URL customizada: "
-                      << options_.url << std::endl;
+            APP_LOG_INFO("APP", "Navegando para URL customizada: ",
+                         options_.url);
             window_->navigate(options_.url);
             return;
         }
 
         if (dev_mode_) {
-            std::cout << "[APP] Navegando para " << dev_url_ << std::endl;
-            window_->navigate(dev_url_);
+            {
+                std::lock_guard<std::mutex> lock(dev_mu_);
+                splash_shown_ = dev_status_ == DevServerStatus::Pending;
+            }
+            if (splash_shown_) {
+                APP_LOG_DEBUG("APP",
+                              "Dev server ainda subindo, exibindo splash");
+                window_->set_html(std::string(splash::DEV_SERVER_HTML));
+                showing_splash_ = true;
+                return;
+            }
+            on_dev_server_settled();
         } else {
 #if defined(APP_DEV_MODE)
             throw std::runtime_error("Build de dev sem Vite server!");
 #elif defined(APP_NO_EMBEDDED_UI)
-            std::cout << "[APP] UI embutida indisponível, usando HTML vazio."
-                      << std::endl;
+            APP_LOG_INFO("APP", "UI embutida indisponível, usando HTML vazio.");
             window_->set_html("<!doctype html><html><body></body></html>");
 #else
-            std::cout << "[APP] Carregando HTML embutido..." << std::endl;
-            window_->set_html(INDEX_HTML);
+            if (scheme_registered_) {
+                APP_LOG_INFO("APP", "Carregando UI embutida via ",
+                             resources::ENTRY_URL);
+                window_->navigate(std::string(resources::ENTRY_URL));
+                return;
+            }
+            APP_LOG_INFO("APP", "Carregando HTML embutido...");
+            window_->set_html(embedded_fallback_html());
 #endif
         }
     }
 
-    void cleanup() {
-        if (dev_mode_ && dev_server_.owned) {
-            dev::stop_server(dev_server_);
+    // Registra app:// para servir a UI embarcada (apenas produção). Em
+    // plataformas sem suporte, load_content cai para set_html.
+    void setup_resource_scheme() {
+#if !defined(APP_DEV_MODE) && !defined(APP_NO_EMBEDDED_UI)
+        if (dev_mode_ || !options_.url.empty()) {
+            return;
         }
-        log("[APP] Encerrado.");
+        resources::ServerOptions server_options;
+        server_options.cross_origin_isolated = options_.cross_origin_isolated;
+        server_options.dynamic = &bindings::serve_binary;
+        auto server = std::make_shared<const resources::ResourceServer>(
+            [this](std::string_view path) {
+                if (auto blob = blob_asset(blobs_, path)) {
+                    return blob;
+                }
+                return lookup_embedded_asset(path);
+            },
+            server_options);
+        auto controller = window_->browser_controller();
+        scheme_registered_ =
+            controller.ok() &&
+            register_resource_scheme(controller.value(), std::move(server));
+        APP_LOG_DEBUG("APP", scheme_registered_
+                                 ? "Esquema app:// registrado"
+                                 : "app:// indisponível, usando set_html");
+#endif
     }
 
-    void log(std::string_view msg) const { std::cout << msg << std::endl; }
+#if !defined(APP_DEV_MODE) && !defined(APP_NO_EMBEDDED_UI)
+    static std::optional<resources::Asset>
+    lookup_embedded_asset(std::string_view path) {
+        const embedded::AssetEntry *entry = embedded::find_asset(path);
+        if (!entry) {
+            return std::nullopt;
+        }
+        // contents() descomprime uma única vez e mantém no cache do
+        // processo, compartilhado por todas as janelas.
+        return resources::Asset{entry->path, embedded::contents(*entry),
+                                entry->etag};
+    }
+#endif
 
-    void log_verbose(std::string_view msg) const {
-        if (verbose_) {
-            std::cout << msg << std::endl;
+    void cleanup() {
+        signal_watcher_.stop();
+        stop_dev_server_task();
+        if (dev_mode_ && dev_server_.owned) {
+            dev::stop_server(dev_server_);
         }
+        APP_LOG_INFO("APP", "Encerrado.");
     }
 
     // Resolve modo dev baseado nas opções e compile-time flags
@@ -204,38 +624,257 @@ class Application {
     // =========================================================================
     // Signal handling para graceful shutdown
     // =========================================================================
-    static std::atomic<bool> shutdown_requested_;
-    static std::mutex shutdown_mutex_;
-    static std::condition_variable shutdown_cv_;
-
-    static void signal_handler(int signal) {
-        // Evita múltiplas impressões do mesmo sinal
-        static std::atomic<bool> signal_printed{false};
-        if (!signal_printed.exchange(true)) {
-            std::cout << "\n[APP] Sinal " << signal
-                      << " recebido, iniciando shutdown graceful..."
-                      << std::endl;
+    void setup_signal_handlers() {
+        // No POSIX os sinais ficam bloqueados e são entregues como evento no
+        // main loop. As threads criadas daqui em diante (dev server, WebKit)
+        // herdam a máscara; as que já existem (executor, escrita do log)
+        // bloqueiam tudo ao começar (thread_signals.h).
+        if (!signal_watcher_.start(
+                [this](int signal) { on_shutdown_signal(signal); })) {
+            APP_LOG_WARN("APP", "Aviso: falha ao configurar signal handlers");
+            return;
         }
+        APP_LOG_INFO("APP", "Signal handlers configurados para graceful "
+                            "shutdown");
+    }
+
+    // Fora de contexto de sinal: roda no main loop (Linux) ou numa thread
+    // dedicada (demais plataformas), então pode logar e despachar.
+    void on_shutdown_signal(int signal) {
+        APP_LOG_INFO("APP", "Sinal ", signal,
+                     " recebido, iniciando shutdown graceful...");
         shutdown_requested_.store(true);
-        shutdown_cv_.notify_all(); // Notifica todas as threads esperando
+        executor().post_to_ui([this] { begin_shutdown(); });
     }
 
-    void setup_signal_handlers() {
-        // Configura handlers para sinais comuns
-        std::signal(SIGINT, signal_handler);  // Ctrl+C
-        std::signal(SIGTERM, signal_handler); // kill ou systemd
+    // =========================================================================
+    // Shutdown em fases (ShutdownCoordinator)
+    // =========================================================================
+    // Com o loop rodando: pede a cada janela que grave o estado
+    // (app.beforeShutdown -> syncNativeState -> acknowledgeShutdown), salva
+    // o que persiste em --state-file, fecha o gate dos bindings e espera as
+    // chamadas em andamento. Depois do loop, em finish_shutdown: drena a
+    // fila da UI, destrói as janelas (filhas antes da principal) e
+    // descarrega os logs. Tudo dentro do prazo de --shutdown-timeout.
 
-        // No Windows, SIGBREAK também pode ser útil
-#ifdef _WIN32
-        std::signal(SIGBREAK, signal_handler);
-#endif
+    static constexpr auto SHUTDOWN_POLL_INTERVAL = std::chrono::milliseconds(5);
+    static constexpr auto STACK_SAMPLE_TIMEOUT = std::chrono::milliseconds(50);
+    static constexpr std::size_t STALL_LOG_FRAMES = 12;
+    static constexpr auto DRAIN_SLICE = std::chrono::milliseconds(5);
+
+    // Thread da UI
+    void begin_shutdown() {
+        if (shutdown_started_ || loop_exited_) {
+            return;
+        }
+        shutdown_started_ = true;
+        add_persist_phases(true);
+        add_stop_calls_phase();
+        if (shutdown_.step()) {
+            window_->terminate();
+            return;
+        }
+        if (has_ui_main_loop()) {
+            shutdown_timer_ = add_ui_timer(SHUTDOWN_POLL_INTERVAL, [this] {
+                if (!shutdown_.step()) {
+                    return true;
+                }
+                shutdown_timer_ = 0;
+                window_->terminate();
+                return false;
+            });
+        } else {
+            pump_shutdown();
+        }
+    }
+
+    // Sem timer no main loop: re-despacha a si mesmo, deixando os acks das
+    // janelas rodarem entre um passo e outro
+    void pump_shutdown() {
+        window_->dispatch([this] {
+            if (loop_exited_) {
+                return;
+            }
+            if (shutdown_.step()) {
+                window_->terminate();
+            } else {
+                pump_shutdown();
+            }
+        });
+    }
+
+    // Antes de stop-calls: as janelas gravam o estado por bindings que
+    // passam pelo gate, e só confirmam depois da gravação. Com o loop já
+    // encerrado (ex: janela principal fechada) a principal fica de fora e
+    // os acks das filhas só chegam drenando a fila da UI na espera.
+    void add_persist_phases(bool loop_running) {
+        shutdown_.add_phase(
+            {"persist-state",
+             [this, loop_running] { request_state_flush(loop_running); },
+             [this, loop_running] {
+                 if (!loop_running) {
+                     drain_ui_queue(std::chrono::steady_clock::now() +
+                                    DRAIN_SLICE);
+                 }
+                 return pending_flush_.empty();
+             }});
+        shutdown_.add_phase(
+            {"save-state", [this] { save_persisted_state(); }});
+    }
+
+    void add_stop_calls_phase() {
+        shutdown_.add_phase(
+            {"stop-calls",
+             [this] {
+                 bindings::call_gate().close();
+                 if (window_manager_) {
+                     window_manager_->begin_shutdown();
+                 }
+             },
+             [] { return bindings::call_gate().in_flight() == 0; }});
+        // Jobs observam o stop_token; os que ignorarem estouram o orçamento
+        shutdown_.add_phase({"cancel-jobs", [this] { jobs_.cancel_all(); },
+                             [this] { return jobs_.active() == 0; }});
+    }
+
+    // include_main = false depois do loop: a principal pode já ter sido
+    // destruída (foi o fechamento dela que encerrou o loop)
+    void request_state_flush(bool include_main = true) {
+        if (!window_manager_) {
+            return;
+        }
+        for (const auto &entry : window_manager_->list_windows()) {
+            auto window_id = entry["id"].get<std::string>();
+            if (window_id == "main" && (showing_splash_ || !include_main)) {
+                continue; // splash ou já destruída: ninguém responde
+            }
+            if (window_manager_->post_raw_event(
+                    window_id, R"({"type":"app.beforeShutdown"})")) {
+                pending_flush_.insert(std::move(window_id));
+            }
+        }
+    }
+
+    // Depois que o loop saiu (sinal, fechamento da janela ou erro)
+    void finish_shutdown() {
+        loop_exited_ = true;
+        shutdown_requested_.store(true);
+        if (shutdown_timer_ != 0) {
+            remove_ui_timer(shutdown_timer_);
+            shutdown_timer_ = 0;
+        }
+        metrics_task_.cancel();
+        metrics_task_.wait();
+        // O encerramento bloqueia a thread da UI de propósito (drenagem)
+        remove_ui_timer(heartbeat_timer_);
+        heartbeat_timer_ = 0;
+        watchdog_.stop();
+        if (!shutdown_started_) {
+            // Loop encerrado sem begin_shutdown (ex: janela principal
+            // fechada)
+            shutdown_started_ = true;
+            add_persist_phases(false);
+            add_stop_calls_phase();
+        }
+        shutdown_.add_phase({"drain-ui-queue", {}, [] {
+                                 return drain_ui_queue(
+                                     std::chrono::steady_clock::now() +
+                                     DRAIN_SLICE);
+                             }});
+        shutdown_.add_phase({"destroy-windows", [this] { destroy_windows(); }});
+        if (trace::enabled()) {
+            shutdown_.add_phase({"dump-trace", [] { dump_native_trace(); }});
+        }
+        if (options_.metrics_interval_s > 0) {
+            shutdown_.add_phase({"dump-metrics", [] { dump_metrics(); }});
+        }
+        // Depois de destroy-windows: nada mais volta para a UI
+        shutdown_.add_phase({"stop-executor", [] { executor().shutdown(); }});
+        shutdown_.add_phase({"flush-logs", [] { log::flush(); }});
+        shutdown_.run();
+        APP_LOG_INFO("APP", "Shutdown: ", shutdown_.summary());
+        report_startup_profile();
+    }
+
+    // =========================================================================
+    // Estado persistido (--state-file)
+    // =========================================================================
+    // Só o layout da janela principal sobrevive a reinícios (as filhas não
+    // são recriadas). Gravado pela fase save-state, depois das confirmações
+    // das janelas, num temporário renomeado por cima: um encerramento no
+    // meio deixa o arquivo anterior inteiro. Lido antes da UI carregar; o
+    // layout que a UI não conseguir aplicar ela mesma apaga.
+
+    static constexpr std::array<const char *, 1> PERSISTED_STATE_KEYS = {
+        "layout/main"};
+
+    std::filesystem::path persisted_state_path() const {
+        return options_.state_file.empty()
+                   ? std::filesystem::path(config::STATE_FILE)
+                   : std::filesystem::path(options_.state_file);
+    }
+
+    void load_persisted_state() {
+        std::ifstream file(persisted_state_path(), std::ios::binary);
+        if (!file) {
+            return; // primeira execução
+        }
+        auto saved = app::bindings::json::parse(file, nullptr, false);
+        if (!saved.is_object()) {
+            APP_LOG_WARN("APP", "Estado salvo ilegível, ignorado: ",
+                         persisted_state_path().string());
+            return;
+        }
+        for (const char *key : PERSISTED_STATE_KEYS) {
+            auto it = saved.find(key);
+            if (it != saved.end()) {
+                state_.set(key, std::move(*it));
+            }
+        }
+    }
 
-        shutdown_requested_.store(false);
-        std::cout << "[APP] Signal handlers configurados para graceful shutdown"
-                  << std::endl;
+    void save_persisted_state() {
+        auto out = app::bindings::json::object();
+        for (const char *key : PERSISTED_STATE_KEYS) {
+            if (auto value = state_.get(key)) {
+                out[key] = std::move(*value);
+            }
+        }
+        if (out.empty()) {
+            return; // nada publicado (ex: só o splash): mantém o anterior
+        }
+        const auto path = persisted_state_path();
+        auto temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            file << out.dump();
+            file.close();
+            if (!file) {
+                APP_LOG_WARN("APP", "Falha ao gravar estado: ", temp.string());
+                return;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+        if (ec) {
+            APP_LOG_WARN("APP", "Falha ao gravar estado: ", ec.message());
+        }
     }
 
-    bool should_shutdown() const { return shutdown_requested_.load(); }
+    void destroy_windows() {
+        // Nenhum callback de sinal ou do dev server pode tocar window_ a
+        // partir daqui
+        signal_watcher_.stop();
+        stop_dev_server_task();
+        if (window_manager_) {
+            const std::size_t closed = window_manager_->close_all_windows();
+            APP_LOG_DEBUG("APP", "Janelas filhas fechadas: ", closed);
+        }
+        window_manager_.reset();
+        executor().set_ui_dispatcher(nullptr);
+        window_.reset();
+    }
 
     void setup_bindings(webview::webview &w) {
         app::setup(w, handlers_);
@@ -243,6 +882,70 @@ class Application {
             return;
         }
 
+        if (profiler_.enabled()) {
+            APP_BIND_TYPED(w, "reportStartupMark",
+                           [this](const std::string &window_id,
+                                  const std::string &name, double js_ms) {
+                               on_startup_mark(window_id, name, js_ms);
+                           });
+        }
+
+        if (trace::enabled()) {
+            // main.js encaminha performance.mark/measure quando vê a flag
+            w.init("window.__APP_TRACING__ = true;");
+            // [{name, start (ms desde a epoch), duration (ms, < 0 = marco)}]
+            APP_BIND_TYPED(
+                w, "addTraceEvents", [](app::bindings::json entries) {
+                    if (!entries.is_array()) {
+                        throw app::bindings::BindingError(
+                            "Expected an array of entries",
+                            app::bindings::ErrorCode::InvalidArgs);
+                    }
+                    for (const auto &entry : entries) {
+                        const double ms = entry.value("duration", -1.0);
+                        trace::add_js_event(
+                            entry.value("name", std::string("mark")),
+                            trace::from_epoch_ms(entry.value("start", 0.0)),
+                            ms < 0 ? -1 : static_cast<std::int64_t>(ms * 1e6));
+                    }
+                });
+        }
+        if (watchdog_.threshold().count() > 0 && has_ui_main_loop()) {
+            // main.js mede os gaps de requestAnimationFrame quando existe
+            APP_BIND_TYPED(w, "reportFrameGap",
+                           [this](const std::string &window_id, double gap_ms) {
+                               watchdog_.record_frame_gap(window_id, gap_ms);
+                           });
+        }
+        APP_BIND_TYPED(w, "getStallReports",
+                       [this] { return watchdog_.to_json(); });
+        APP_BIND_TYPED(w, "getNativeMetrics",
+                       [] { return metrics::registry().to_json(); });
+        APP_BIND_TYPED(w, "dumpNativeTrace", [] {
+            if (!trace::enabled()) {
+                throw app::bindings::BindingError(
+                    "Tracing is disabled (run with --trace)",
+                    app::bindings::ErrorCode::Unavailable);
+            }
+            if (!dump_native_trace()) {
+                throw app::bindings::BindingError(
+                    std::string("Could not write ") + config::TRACE_FILE,
+                    app::bindings::ErrorCode::InternalError);
+            }
+            return std::string(config::TRACE_FILE);
+        });
+
+        // bind_raw fica fora do gate: o ack chega depois que ele fechou
+        app::bindings::bind_raw(
+            w, "acknowledgeShutdown", [this](const std::string &args_str) {
+                const auto args =
+                    app::bindings::json::parse(args_str, nullptr, false);
+                if (args.is_array() && !args.empty() && args[0].is_string()) {
+                    pending_flush_.erase(args[0].get<std::string>());
+                }
+                return app::bindings::ok().dump();
+            });
+
         APP_BIND_TYPED(w, "createNativeWindow",
                        [this](app::bindings::json bootstrap) {
                            return window_manager_->create_window(bootstrap);
@@ -265,6 +968,30 @@ class Application {
                         app::bindings::ErrorCode::MissingArg);
                 }
             });
+        // Fluxo dos eventos nativos: o JS confirma o maior seq consumido.
+        // Controle, como o acknowledgeShutdown: fora do gate, senão um ack
+        // recusado no encerramento deixa a fila da janela parada.
+        app::bindings::bind_raw(
+            w, "ackNativeEvents", [this](const std::string &args_str) {
+                const auto args =
+                    app::bindings::json::parse(args_str, nullptr, false);
+                if (!args.is_array() || args.size() < 2 ||
+                    !args[0].is_string() || !args[1].is_number_unsigned()) {
+                    return app::bindings::error(
+                               "Expected (windowId, seq)",
+                               app::bindings::ErrorCode::InvalidArgs)
+                        .dump();
+                }
+                return app::bindings::ok(
+                           window_manager_->ack_events(
+                               args[0].get<std::string>(),
+                               args[1].get<std::uint64_t>()))
+                    .dump();
+            });
+        APP_BIND_TYPED(w, "getNativeEventStats",
+                       [this](const std::string &window_id) {
+                           return window_manager_->event_stats(window_id);
+                       });
         APP_BIND_TYPED(w, "closeNativeWindow",
                        [this](const std::string &window_id) {
                            if (!window_manager_->close_window(window_id)) {
@@ -277,8 +1004,10 @@ class Application {
                        [this]() { return window_manager_->list_windows(); });
         APP_BIND_TYPED(
             w, "startNativeDrag",
-            [this](const std::string &window_id, app::bindings::json payload) {
-                window_manager_->start_drag_tracking(window_id, payload);
+            [this](const std::string &window_id,
+                   const app::bindings::json &payload) {
+                return window_manager_->start_drag_tracking(window_id,
+                                                            payload);
             });
         APP_BIND_TYPED(w, "completeNativeDrag",
                        [this](const std::string &target_window_id) {
@@ -292,6 +1021,136 @@ class Application {
                            return window_manager_->complete_drag_outside(
                                window_id);
                        });
+        APP_BIND_TYPED(w, "registerDropTargets",
+                       [this](const std::string &window_id,
+                              const app::bindings::json &targets) {
+                           window_manager_->register_drop_targets(window_id,
+                                                                  targets);
+                       });
+        APP_BIND_TYPED(w, "getNativeWindowGeometry",
+                       [this](const std::string &window_id) {
+                           return window_manager_->window_geometry(window_id);
+                       });
+        APP_BIND_TYPED(w, "getNativeDragStats",
+                       [this]() { return window_manager_->drag_stats(); });
+
+        // Jobs: progresso e fim chegam no evento jobs.update da janela
+        APP_BIND_TYPED(w, "startJob",
+                       [this](const std::string &window_id,
+                              const std::string &kind,
+                              app::bindings::json params) {
+                           auto id = jobs_.start(window_id, kind,
+                                                 std::move(params));
+                           if (!id) {
+                               throw app::bindings::BindingError(
+                                   "Unknown job kind: " + kind,
+                                   app::bindings::ErrorCode::InvalidArgs);
+                           }
+                           return *id;
+                       });
+        APP_BIND_TYPED(w, "cancelJob", [this](const std::string &job_id) {
+            return jobs_.cancel(job_id);
+        });
+        APP_BIND_TYPED(w, "listJobs", [this]() { return jobs_.list(); });
+
+        // Blobs: as janelas passam handles em vez dos payloads
+        APP_BIND_TYPED(w, "putBlob",
+                       [this](const std::string &window_id,
+                              const std::string &data,
+                              app::bindings::json options) {
+                           return put_blob(window_id, data, options);
+                       });
+        APP_BIND_TYPED(w, "getBlob",
+                       [this](const std::string &handle,
+                              std::optional<std::string> encoding) {
+                           return get_blob(handle, encoding.value_or("utf8"));
+                       });
+        APP_BIND_TYPED(w, "retainBlob",
+                       [this](const std::string &window_id,
+                              const std::string &handle) {
+                           return blobs_.retain(window_id, handle);
+                       });
+        APP_BIND_TYPED(w, "releaseBlob",
+                       [this](const std::string &window_id,
+                              const std::string &handle) {
+                           return blobs_.release(window_id, handle);
+                       });
+        APP_BIND_TYPED(w, "getBlobStats", ([this]() {
+                           const auto stats = blobs_.stats();
+                           return app::bindings::json{
+                               {"blobs", stats.blobs},
+                               {"memoryBytes", stats.memory_bytes},
+                               {"spilledBlobs", stats.spilled_blobs},
+                               {"spilledBytes", stats.spilled_bytes},
+                               {"evictions", stats.evictions},
+                               {"spills", stats.spills},
+                               {"loads", stats.loads}};
+                       }));
+
+        // Estado compartilhado: snapshot ao assinar, depois só deltas
+        // (evento state.delta); a escrita sempre passa pelo nativo
+        APP_BIND_TYPED(w, "subscribeState",
+                       [this](const std::string &window_id,
+                              const std::string &prefix) {
+                           return raw_json(state_.subscribe(window_id, prefix));
+                       });
+        APP_BIND_TYPED(w, "unsubscribeState",
+                       [this](const std::string &window_id,
+                              const std::string &prefix) {
+                           return state_.unsubscribe(window_id, prefix);
+                       });
+        APP_BIND_TYPED(w, "getStateSince",
+                       [this](std::uint64_t version,
+                              const std::string &prefix) {
+                           return raw_json(state_.since(version, prefix));
+                       });
+        APP_BIND_TYPED(w, "setState",
+                       [this](const std::string &key,
+                              app::bindings::json value) {
+                           if (key.empty()) {
+                               throw app::bindings::BindingError(
+                                   "State key must not be empty",
+                                   app::bindings::ErrorCode::InvalidArgs);
+                           }
+                           return state_.set(key, std::move(value));
+                       });
+        // Escrita incremental: patch contra a versão que o JS conhece
+        APP_BIND_TYPED(w, "patchState",
+                       [this](const std::string &key, std::uint64_t base,
+                              app::bindings::json patch) {
+                           std::optional<std::uint64_t> version;
+                           try {
+                               version = state_.patch(key, base, patch);
+                           } catch (const JsonPatchError &e) {
+                               throw app::bindings::BindingError(
+                                   e.what(),
+                                   app::bindings::ErrorCode::InvalidArgs);
+                           }
+                           if (!version) {
+                               throw app::bindings::BindingError(
+                                   "State version conflict: " + key,
+                                   app::bindings::ErrorCode::Conflict);
+                           }
+                           return *version;
+                       });
+        APP_BIND_TYPED(w, "deleteState", [this](const std::string &key) {
+            return state_.erase(key);
+        });
+        APP_BIND_TYPED(w, "getStateStats", ([this]() {
+                           const auto stats = state_.stats();
+                           return app::bindings::json{
+                               {"version", stats.version},
+                               {"keys", stats.keys},
+                               {"subscribers", stats.subscribers},
+                               {"logEntries", stats.log_entries},
+                               {"logBytes", stats.log_bytes},
+                               {"deltasSent", stats.deltas_sent},
+                               {"resyncs", stats.resyncs}};
+                       }));
+    }
+
+    static app::bindings::RawJson raw_json(std::string text) {
+        return {std::make_shared<const std::string>(std::move(text))};
     }
 
     // =========================================================================
@@ -299,12 +1158,40 @@ class Application {
     // =========================================================================
     Options options_;
     bool dev_mode_;
-    bool verbose_ = false;
+    StartupProfiler profiler_;
+    std::size_t reported_events_ = 0;
+    bool scheme_registered_ = false;
     std::string dev_url_;
     dev::ServerProcess dev_server_;
+    // Startup: dev server em paralelo com a criação da webview
+    std::chrono::steady_clock::time_point startup_begin_;
+    long long webview_ms_ = 0;
+    std::mutex dev_mu_;
+    DevServerStatus dev_status_ = DevServerStatus::Pending;
+    long long dev_server_ms_ = 0;
+    bool splash_shown_ = false; // escrito sob dev_mu_ na thread da UI
+    bool showing_splash_ = false; // thread da UI
+    bool dev_server_failed_ = false;
+    Task dev_task_;
     app::HandlerRegistry handlers_;
+    BlobStore blobs_; // antes de jobs_: o job "openFile" guarda nele
+    JobManager jobs_;
+    StateStore state_;
     std::unique_ptr<webview::webview> window_;
     std::unique_ptr<WindowManager> window_manager_;
+    std::atomic<bool> shutdown_requested_{false};
+    SignalWatcher signal_watcher_;
+    // Estado do shutdown (somente thread da UI)
+    ShutdownCoordinator shutdown_{
+        std::chrono::milliseconds(config::SHUTDOWN_TIMEOUT_MS)};
+    bool shutdown_started_ = false;
+    bool loop_exited_ = false;
+    UiTimerId shutdown_timer_ = 0;
+    Task metrics_task_;
+    StallWatchdog watchdog_{
+        std::chrono::milliseconds(config::STALL_THRESHOLD_MS)};
+    UiTimerId heartbeat_timer_ = 0;
+    std::unordered_set<std::string> pending_flush_;
 };
 
 } // namespace app
@@ -0,0 +1,110 @@
+#pragma once
+// =============================================================================
+// Base64 - Binário pelo bridge do webview (que só leva texto)
+// =============================================================================
+// Usado onde o caminho sem cópia (app://) não existe: putBlob/getBlob e o
+// fallback do canal binário. Tabelas de 256 entradas, 3 bytes <-> 4
+// caracteres por passo, sem desvios no laço principal: ~1.33x o tamanho do
+// dado, contra ~4x de um array JSON de números.
+// =============================================================================
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace app {
+
+namespace detail {
+
+inline constexpr char BASE64_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Valor de cada caractere; 0xFF = inválido
+inline constexpr std::array<std::uint8_t, 256> BASE64_VALUES = [] {
+    std::array<std::uint8_t, 256> table{};
+    table.fill(0xFF);
+    for (std::uint8_t i = 0; i < 64; ++i) {
+        table[static_cast<unsigned char>(BASE64_ALPHABET[i])] = i;
+    }
+    return table;
+}();
+
+} // namespace detail
+
+[[nodiscard]] inline std::string base64_encode(std::string_view bytes) {
+    const auto *in = reinterpret_cast<const unsigned char *>(bytes.data());
+    const std::size_t size = bytes.size();
+    std::string out((size + 2) / 3 * 4, '=');
+    char *dst = out.data();
+    std::size_t i = 0;
+    for (; i + 3 <= size; i += 3) {
+        const std::uint32_t n = std::uint32_t{in[i]} << 16 |
+                                std::uint32_t{in[i + 1]} << 8 | in[i + 2];
+        *dst++ = detail::BASE64_ALPHABET[n >> 18];
+        *dst++ = detail::BASE64_ALPHABET[(n >> 12) & 63];
+        *dst++ = detail::BASE64_ALPHABET[(n >> 6) & 63];
+        *dst++ = detail::BASE64_ALPHABET[n & 63];
+    }
+    if (i < size) {
+        std::uint32_t n = std::uint32_t{in[i]} << 16;
+        if (i + 1 < size) {
+            n |= std::uint32_t{in[i + 1]} << 8;
+        }
+        *dst++ = detail::BASE64_ALPHABET[n >> 18];
+        *dst++ = detail::BASE64_ALPHABET[(n >> 12) & 63];
+        if (i + 1 < size) {
+            *dst = detail::BASE64_ALPHABET[(n >> 6) & 63];
+        }
+    }
+    return out;
+}
+
+// nullopt se não é base64 válido (padding opcional)
+[[nodiscard]] inline std::optional<std::string>
+base64_decode(std::string_view text) {
+    while (!text.empty() && text.back() == '=') {
+        text.remove_suffix(1);
+    }
+    if (text.size() % 4 == 1) {
+        return std::nullopt;
+    }
+    const auto *in = reinterpret_cast<const unsigned char *>(text.data());
+    const std::size_t size = text.size();
+    std::string out(size / 4 * 3 + (size % 4 == 0 ? 0 : size % 4 - 1), '\0');
+    char *dst = out.data();
+    const auto &values = detail::BASE64_VALUES;
+    std::uint8_t invalid = 0; // OR de todos os valores: 0xFF marca erro
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        const std::uint8_t a = values[in[i]], b = values[in[i + 1]],
+                           c = values[in[i + 2]], d = values[in[i + 3]];
+        invalid |= static_cast<std::uint8_t>(a | b | c | d);
+        const std::uint32_t n = std::uint32_t{a} << 18 |
+                                std::uint32_t{b} << 12 |
+                                std::uint32_t{c} << 6 | d;
+        *dst++ = static_cast<char>(n >> 16);
+        *dst++ = static_cast<char>((n >> 8) & 0xFF);
+        *dst++ = static_cast<char>(n & 0xFF);
+    }
+    if (i < size) {
+        std::uint32_t n = 0;
+        for (std::size_t k = 0; k < 4; ++k) {
+            const std::uint8_t v = i + k < size ? values[in[i + k]] : 0;
+            invalid |= v;
+            n = n << 6 | (v & 63U);
+        }
+        *dst++ = static_cast<char>(n >> 16);
+        if (size - i == 3) {
+            *dst = static_cast<char>((n >> 8) & 0xFF);
+        }
+    }
+    if (invalid & 0x80) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+} // namespace app
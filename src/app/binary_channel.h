@@ -0,0 +1,234 @@
+#pragma once
+// =============================================================================
+// Binary channel - ArrayBuffer <-> std::span<const std::byte> sem JSON
+// =============================================================================
+// bind_binary registra um handler que recebe e devolve bytes. No JS ele
+// aparece como `name(data: ArrayBuffer | TypedArray): Promise<ArrayBuffer>`
+// (definido por um script de init da webview) e usa o melhor transporte:
+//   - UI servida por app://: fetch POST app://ui/__binary/<name>, corpo e
+//     resposta crus (sem codificação, resposta sem cópia para o WebKit)
+//   - fora disso (Vite, WebKitGTK < 2.40 sem corpo no esquema): base64 pelo
+//     bridge, no binding `__binary_<name>`
+// Os dois caminhos passam pelo gate de shutdown e contam nas métricas do
+// binding (mesmo nome).
+// =============================================================================
+
+#include "app/base64.h"
+#include "app/bindings_meta.h"
+#include "app/resource_server.h"
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <source_location>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace app::bindings {
+
+// Path do canal no esquema app:// (mesma origem da UI)
+inline constexpr std::string_view BINARY_PATH_PREFIX = "/__binary/";
+
+using BinaryHandler =
+    std::function<std::vector<std::byte>(std::span<const std::byte>)>;
+
+// Handlers por nome: consultados pelo esquema (thread da UI) e pelo bridge
+class BinaryRegistry {
+  public:
+    void add(std::string name, BinaryHandler handler) {
+        std::lock_guard<std::mutex> lock(mu_);
+        handlers_[std::move(name)] =
+            std::make_shared<const BinaryHandler>(std::move(handler));
+    }
+
+    [[nodiscard]] std::shared_ptr<const BinaryHandler>
+    find(std::string_view name) const {
+        std::lock_guard<std::mutex> lock(mu_);
+        const auto it = handlers_.find(name);
+        return it == handlers_.end() ? nullptr : it->second;
+    }
+
+  private:
+    mutable std::mutex mu_;
+    std::map<std::string, std::shared_ptr<const BinaryHandler>, std::less<>>
+        handlers_;
+};
+
+inline BinaryRegistry &binary_registry() {
+    static BinaryRegistry registry;
+    return registry;
+}
+
+namespace detail {
+
+[[nodiscard]] inline std::span<const std::byte> as_bytes(std::string_view s) {
+    return std::as_bytes(std::span<const char>(s.data(), s.size()));
+}
+
+// Handler + métricas do binding; exceções sobem para o transporte
+inline std::vector<std::byte>
+call_binary(const BinaryHandler &handler, std::string_view name,
+            std::span<const std::byte> input) {
+    auto &metrics = metrics::registry().binding(name);
+    const auto begin = std::chrono::steady_clock::now();
+    std::vector<std::byte> output;
+    try {
+        APP_TRACE_SPAN("binding", "binary");
+        output = handler(input);
+    } catch (const BindingError &e) {
+        metrics.record_error(static_cast<int>(e.code()));
+        throw;
+    } catch (const std::exception &) {
+        metrics.record_error(static_cast<int>(ErrorCode::InternalError));
+        throw;
+    }
+    metrics.calls.add();
+    metrics.request_bytes.add(input.size());
+    metrics.response_bytes.add(output.size());
+    metrics.latency.record(std::chrono::steady_clock::now() - begin);
+    return output;
+}
+
+// Define window.__callNativeBinary uma vez por página (fetch com fallback
+// para base64 pelo bridge)
+inline constexpr std::string_view BINARY_BRIDGE_JS = R"JS((() => {
+  if (window.__callNativeBinary) return
+  const toBytes = (data) =>
+    ArrayBuffer.isView(data)
+      ? new Uint8Array(data.buffer, data.byteOffset, data.byteLength)
+      : new Uint8Array(data ?? new ArrayBuffer(0))
+  const toBase64 = (bytes) => {
+    let binary = ''
+    for (let i = 0; i < bytes.length; i += 0x8000)
+      binary += String.fromCharCode(...bytes.subarray(i, i + 0x8000))
+    return btoa(binary)
+  }
+  const fromBase64 = (text) => {
+    const binary = atob(text)
+    const bytes = new Uint8Array(binary.length)
+    for (let i = 0; i < binary.length; i++) bytes[i] = binary.charCodeAt(i)
+    return bytes.buffer
+  }
+  window.__callNativeBinary = async (name, data) => {
+    const bytes = toBytes(data)
+    if (window.location.protocol === 'app:') {
+      const response = await fetch('/__binary/' + name, {
+        method: 'POST',
+        body: bytes
+      }).catch(() => null)
+      if (response?.ok) return response.arrayBuffer()
+      if (response && ![404, 405, 501].includes(response.status))
+        throw new Error(await response.text())
+    }
+    const result = await window['__binary_' + name](toBase64(bytes))
+    if (!result?.ok)
+      throw new Error(result?.error?.message || 'Binary call failed')
+    return fromBase64(result.data)
+  }
+})();)JS";
+
+} // namespace detail
+
+// Endpoint do esquema: POST app://ui/__binary/<name>. nullopt = outro path.
+[[nodiscard]] inline std::optional<resources::Response>
+serve_binary(const resources::Request &request, std::string_view path) {
+    if (path.substr(0, BINARY_PATH_PREFIX.size()) != BINARY_PATH_PREFIX) {
+        return std::nullopt;
+    }
+    resources::Response response;
+    response.mime = "text/plain; charset=utf-8";
+    const std::string_view name = path.substr(BINARY_PATH_PREFIX.size());
+    const auto handler = binary_registry().find(name);
+    if (!handler) {
+        response.status = 404;
+        return response;
+    }
+    if (request.method != "POST") {
+        response.status = 405;
+        response.headers.emplace_back("Allow", "POST");
+        return response;
+    }
+
+    // Mensagem de erro no corpo (o JS rejeita com ela)
+    const auto fail = [&response](int status, std::string message) {
+        auto text = std::make_shared<const std::string>(std::move(message));
+        response.status = status;
+        response.body = *text;
+        response.owner = std::move(text);
+        return response;
+    };
+    const auto ticket = call_gate().try_enter();
+    if (!ticket) {
+        return fail(503, "Aplicação encerrando");
+    }
+    try {
+        auto output = std::make_shared<const std::vector<std::byte>>(
+            detail::call_binary(*handler, name,
+                                detail::as_bytes(request.body)));
+        response.mime = "application/octet-stream";
+        response.body = std::string_view(
+            reinterpret_cast<const char *>(output->data()), output->size());
+        response.owner = std::move(output);
+        response.headers.emplace_back("Cache-Control", "no-store");
+        return response;
+    } catch (const BindingError &e) {
+        return fail(static_cast<int>(e.code()), e.what());
+    } catch (const std::exception &e) {
+        return fail(500, std::string("Erro interno: ") + e.what());
+    }
+}
+
+// Registra `name` nos dois transportes e no .d.ts (ArrayBuffer)
+inline void
+bind_binary(webview::webview &w, const std::string &name,
+            BinaryHandler handler,
+            std::source_location location = std::source_location::current()) {
+    binary_registry().add(name, std::move(handler));
+
+    bind_raw(w, "__binary_" + name, [name](const std::string &args_str) {
+        return guarded_call(args_str, [&name](const json &args) {
+            const json &arg = arg_or_null(args, 0);
+            if (!arg.is_string()) {
+                throw BindingError("Expected base64 string",
+                                   ErrorCode::TypeMismatch);
+            }
+            auto input = base64_decode(arg.get_ref<const std::string &>());
+            if (!input) {
+                throw BindingError("Invalid base64 data",
+                                   ErrorCode::InvalidArgs);
+            }
+            const auto handler = binary_registry().find(name);
+            if (!handler) {
+                throw BindingError("Binary binding not found: " + name,
+                                   ErrorCode::InternalError);
+            }
+            const auto output =
+                detail::call_binary(*handler, name, detail::as_bytes(*input));
+            std::string response = R"({"ok":true,"data":")";
+            response += base64_encode(std::string_view(
+                reinterpret_cast<const char *>(output.data()), output.size()));
+            response += "\"}";
+            return response;
+        });
+    });
+    w.init(std::string(detail::BINARY_BRIDGE_JS));
+    w.init("window." + name +
+           " = (data) => window.__callNativeBinary('" + name + "', data);");
+
+    meta::BindingMeta binding;
+    binding.name = name;
+    binding.return_ts = "ArrayBuffer";
+    binding.args_ts = {"ArrayBuffer"};
+    binding.cpp_begin = {location.file_name(),
+                         static_cast<std::uint32_t>(location.line()),
+                         static_cast<std::uint32_t>(location.column())};
+    binding.cpp_end = binding.cpp_begin;
+    meta::registry().push_back(std::move(binding));
+}
+
+} // namespace app::bindings
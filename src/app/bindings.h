@@ -3,14 +3,26 @@
 // Bindings - Handlers para comunicação JS <-> C++
 // =============================================================================
 
+#include "app/log.h"
+#include "app/metrics.h"
+#include "app/shutdown_coordinator.h"
+#include "app/stall_watchdog.h"
+#include "app/tracing.h"
 #include "webview/webview.h"
 #include <cassert> // Para asserts (NASA-style)
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
-#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -27,7 +39,9 @@ enum class ErrorCode {
     InvalidArgs = 400,
     MissingArg = 400,
     TypeMismatch = 400,
-    InternalError = 500
+    Conflict = 409, // versão base desatualizada
+    InternalError = 500,
+    Unavailable = 503 // app encerrando
 };
 
 // =============================================================================
@@ -48,6 +62,29 @@ enum class ErrorCode {
         {"error", {{"code", static_cast<int>(code)}, {"message", message}}}};
 }
 
+// =============================================================================
+// RawJson - retorno já serializado (emendado na resposta sem parse/dump)
+// =============================================================================
+// Útil para payloads grandes mantidos como texto JSON compartilhado: o
+// handler devolve o ponteiro e a resposta é montada por concatenação.
+// O texto precisa ser JSON válido; ponteiro nulo vira `null`.
+
+struct RawJson {
+    std::shared_ptr<const std::string> text;
+};
+
+[[nodiscard]] inline std::string ok_raw(const RawJson &data) {
+    if (!data.text) {
+        return R"({"ok":true})";
+    }
+    std::string response;
+    response.reserve(data.text->size() + 20);
+    response += R"({"ok":true,"data":)";
+    response += *data.text;
+    response += '}';
+    return response;
+}
+
 // =============================================================================
 // BindingError - erro customizado com código (RAII, strong type)
 // =============================================================================
@@ -63,6 +100,208 @@ class BindingError : public std::runtime_error {
     ErrorCode code_;
 };
 
+// =============================================================================
+// Stream - resultado grande entregue em blocos, puxado pelo JS
+// =============================================================================
+// O handler devolve um Stream (gerador: cada next() produz um item, nullopt
+// no fim) em vez de materializar tudo num json. O binding responde com o
+// primeiro bloco e um id; o resto sai em blocos limitados por bytes, só
+// quando o JS pede (pullNativeStream) - o ritmo do consumidor é o
+// backpressure. No JS: for await (const item of iterateNativeStream(p)).
+//
+// Resposta: {"stream":"s1","items":[...],"done":false}. Com done o stream
+// já foi liberado; parar antes do fim chama closeNativeStream. Streams
+// esquecidos (página recarregada) expiram após STREAM_IDLE_TIMEOUT.
+
+class Stream {
+  public:
+    using Next = std::function<std::optional<json>()>;
+
+    Stream() = default;
+    explicit Stream(Next next) : next_(std::move(next)) {}
+
+    // Percorre o range sob demanda (o range vai junto, por valor)
+    template <typename Range> [[nodiscard]] static Stream from_range(Range r) {
+        struct Cursor {
+            explicit Cursor(Range source)
+                : range(std::move(source)), it(std::begin(range)) {}
+            Range range;
+            decltype(std::begin(std::declval<Range &>())) it;
+        };
+        auto cursor = std::make_shared<Cursor>(std::move(r));
+        return Stream([cursor]() -> std::optional<json> {
+            if (cursor->it == std::end(cursor->range)) {
+                return std::nullopt;
+            }
+            json item(*cursor->it);
+            ++cursor->it;
+            return item;
+        });
+    }
+
+    [[nodiscard]] std::optional<json> next() {
+        return next_ ? next_() : std::nullopt;
+    }
+
+  private:
+    Next next_;
+};
+
+class StreamRegistry {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // Primeiro bloco menor: o primeiro item chega antes
+    static constexpr std::size_t FIRST_CHUNK_BYTES = 16 * 1024;
+    static constexpr std::size_t CHUNK_BYTES = 256 * 1024;
+    static constexpr std::size_t MAX_OPEN_STREAMS = 64;
+    static constexpr std::chrono::seconds STREAM_IDLE_TIMEOUT{60};
+
+    // Primeiro bloco; o stream só fica registrado se não terminou nele
+    [[nodiscard]] RawJson open(Stream stream,
+                               std::size_t max_bytes = FIRST_CHUNK_BYTES) {
+        auto entry = std::make_shared<Entry>();
+        entry->stream = std::move(stream);
+        std::string items;
+        const bool done = fill(*entry, max_bytes, items);
+        std::string id;
+        if (!done) {
+            const auto now = Clock::now();
+            std::lock_guard<std::mutex> lock(mu_);
+            reap_locked(now);
+            if (streams_.size() >= MAX_OPEN_STREAMS) {
+                throw BindingError("Too many open streams",
+                                   ErrorCode::Unavailable);
+            }
+            id = "s" + std::to_string(++next_id_);
+            entry->last_used = now;
+            streams_.emplace(id, std::move(entry));
+        }
+        return chunk(id, items, done);
+    }
+
+    [[nodiscard]] RawJson pull(const std::string &id,
+                               std::size_t max_bytes = CHUNK_BYTES) {
+        std::shared_ptr<Entry> entry;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            const auto it = streams_.find(id);
+            if (it == streams_.end()) {
+                throw BindingError("Stream not found: " + id,
+                                   ErrorCode::MissingArg);
+            }
+            entry = it->second;
+        }
+        // O gerador roda fora do lock do registry
+        std::unique_lock<std::mutex> entry_lock(entry->mu, std::try_to_lock);
+        if (!entry_lock) {
+            throw BindingError("Stream busy: " + id, ErrorCode::InvalidArgs);
+        }
+        std::string items;
+        bool done = true;
+        try {
+            done = fill(*entry, max_bytes, items);
+        } catch (...) {
+            close(id);
+            throw;
+        }
+        entry->last_used = Clock::now();
+        entry_lock.unlock();
+        if (done) {
+            close(id);
+        }
+        return chunk(id, items, done);
+    }
+
+    bool close(const std::string &id) {
+        std::shared_ptr<Entry> entry; // destruído fora do lock
+        std::lock_guard<std::mutex> lock(mu_);
+        const auto it = streams_.find(id);
+        if (it == streams_.end()) {
+            return false;
+        }
+        entry = std::move(it->second);
+        streams_.erase(it);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t open_count() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        return streams_.size();
+    }
+
+  private:
+    struct Entry {
+        std::mutex mu; // um pull por vez
+        Stream stream;
+        Clock::time_point last_used;
+    };
+
+    // Itens separados por vírgula até passar de `max_bytes` (pelo menos
+    // um). true = o gerador terminou.
+    static bool fill(Entry &entry, std::size_t max_bytes, std::string &out) {
+        std::size_t count = 0;
+        while (out.size() < max_bytes) {
+            auto item = entry.stream.next();
+            if (!item) {
+                return true;
+            }
+            if (count++ > 0) {
+                out += ',';
+            }
+            out += item->dump();
+        }
+        return false;
+    }
+
+    static RawJson chunk(const std::string &id, const std::string &items,
+                         bool done) {
+        auto text = std::make_shared<std::string>();
+        text->reserve(items.size() + id.size() + 40);
+        *text += R"({"stream":)";
+        *text += id.empty() ? "null" : '"' + id + '"';
+        *text += R"(,"items":[)";
+        *text += items;
+        *text += R"(],"done":)";
+        *text += done ? "true}" : "false}";
+        return RawJson{std::move(text)};
+    }
+
+    // mu_ travado. Um pull em andamento segura a própria entry (shared_ptr)
+    void reap_locked(Clock::time_point now) {
+        for (auto it = streams_.begin(); it != streams_.end();) {
+            it = now - it->second->last_used > STREAM_IDLE_TIMEOUT
+                     ? streams_.erase(it)
+                     : std::next(it);
+        }
+    }
+
+    mutable std::mutex mu_;
+    std::map<std::string, std::shared_ptr<Entry>> streams_;
+    std::uint64_t next_id_ = 0;
+};
+
+inline StreamRegistry &stream_registry() {
+    static StreamRegistry registry;
+    return registry;
+}
+
+// =============================================================================
+// Gate de chamadas - fechado no início do shutdown
+// =============================================================================
+// bind_json/bind_typed/bind_generic passam por aqui: com o gate fechado a
+// chamada responde Unavailable sem executar o handler. bind_raw não é
+// controlado (usado pelos bindings do próprio shutdown).
+
+inline CallGate &call_gate() {
+    static CallGate gate;
+    return gate;
+}
+
+[[nodiscard]] inline std::string shutting_down_response() {
+    return error("Aplicação encerrando", ErrorCode::Unavailable).dump();
+}
+
 // =============================================================================
 // Camada 0 - Bind "cru" (string -> string)
 // =============================================================================
@@ -117,9 +356,17 @@ void bind_generic(webview::webview &w, std::string name, F &&func) {
     using Callable = std::decay_t<F>;
     using ResultType = std::decay_t<decltype(std::declval<Callable>()())>;
 
-    w.bind(std::move(name), [callable = Callable(std::forward<F>(func))](
+    const char *trace_name = trace::intern(name);
+    w.bind(std::move(name), [callable = Callable(std::forward<F>(func)),
+                             trace_name](
                                 [[maybe_unused]] const std::string &args_str) {
+        APP_TRACE_SPAN("binding", trace_name);
+        const watchdog::TaskScope task(trace_name);
         // Ignora os args, só chama o handler
+        const auto ticket = call_gate().try_enter();
+        if (!ticket) {
+            return shutting_down_response();
+        }
         try {
             auto result = callable();
 
@@ -150,46 +397,85 @@ inline json parse_args(const std::string &args_str) {
     return json::parse(args_str);
 }
 
-inline void bind_json(webview::webview &w, std::string name,
-                      JsonHandler handler) {
-    bind_raw(
-        w, std::move(name),
-        [handler =
-             std::move(handler)](const std::string &args_str) -> std::string {
-            json args;
-            try {
-                args = parse_args(args_str);
-            } catch (const std::exception &e) {
-                return error(std::string("JSON inválido: ") + e.what(),
-                             ErrorCode::InvalidJson)
-                    .dump();
-            }
+// Executa `body` com os argumentos parseados e converte exceções em respostas
+// de erro padronizadas. `body` devolve a resposta de sucesso já serializada.
+// Com `metrics`, cada erro é contado pelo seu ErrorCode.
+template <typename Body>
+std::string guarded_call(const std::string &args_str, const Body &body,
+                         metrics::BindingMetrics *metrics = nullptr) {
+    const auto fail = [metrics](const std::string &message, ErrorCode code) {
+        if (metrics) {
+            metrics->record_error(static_cast<int>(code));
+        }
+        return error(message, code).dump();
+    };
 
-            try {
-                if (!args.is_array()) {
-                    throw BindingError("Argumentos devem ser um array JSON",
-                                       ErrorCode::InvalidArgs);
-                }
+    const auto ticket = call_gate().try_enter();
+    if (!ticket) {
+        if (metrics) {
+            metrics->record_error(static_cast<int>(ErrorCode::Unavailable));
+        }
+        return shutting_down_response();
+    }
+    json args;
+    try {
+        APP_TRACE_SPAN("binding", "parse");
+        args = parse_args(args_str);
+    } catch (const std::exception &e) {
+        return fail(std::string("JSON inválido: ") + e.what(),
+                    ErrorCode::InvalidJson);
+    }
 
-                json result = handler(args);
-                return ok(result).dump();
-            } catch (const BindingError &e) {
-                return error(e.what(), e.code()).dump();
-            } catch (const json::type_error &e) {
-                return error(std::string("Argumento inválido: ") + e.what(),
-                             ErrorCode::TypeMismatch)
-                    .dump();
-            } catch (const json::out_of_range &e) {
-                return error(std::string("Argumento fora do intervalo: ") +
-                                 e.what(),
-                             ErrorCode::MissingArg)
-                    .dump();
-            } catch (const std::exception &e) {
-                return error(std::string("Erro interno: ") + e.what(),
-                             ErrorCode::InternalError)
-                    .dump();
-            }
-        });
+    try {
+        if (!args.is_array()) {
+            throw BindingError("Argumentos devem ser um array JSON",
+                               ErrorCode::InvalidArgs);
+        }
+        return body(args);
+    } catch (const BindingError &e) {
+        return fail(e.what(), e.code());
+    } catch (const json::type_error &e) {
+        return fail(std::string("Argumento inválido: ") + e.what(),
+                    ErrorCode::TypeMismatch);
+    } catch (const json::out_of_range &e) {
+        return fail(std::string("Argumento fora do intervalo: ") + e.what(),
+                    ErrorCode::MissingArg);
+    } catch (const std::exception &e) {
+        return fail(std::string("Erro interno: ") + e.what(),
+                    ErrorCode::InternalError);
+    }
+}
+
+// Contagem, bytes e latência de uma chamada (erros já contados em
+// guarded_call)
+inline void record_call(metrics::BindingMetrics &metrics,
+                        const std::string &request,
+                        const std::string &response,
+                        std::chrono::steady_clock::time_point begin) {
+    metrics.calls.add();
+    metrics.request_bytes.add(request.size());
+    metrics.response_bytes.add(response.size());
+    metrics.latency.record(std::chrono::steady_clock::now() - begin);
+}
+
+inline void bind_json(webview::webview &w, std::string name,
+                      JsonHandler handler) {
+    const char *trace_name = trace::intern(name);
+    bind_raw(w, std::move(name),
+             [handler = std::move(handler),
+              trace_name](const std::string &args_str) {
+                 APP_TRACE_SPAN("binding", trace_name);
+                 const watchdog::TaskScope task(trace_name);
+                 return guarded_call(args_str, [&handler](const json &args) {
+                     json result;
+                     {
+                         APP_TRACE_SPAN("binding", "handler");
+                         result = handler(args);
+                     }
+                     APP_TRACE_SPAN("binding", "serialize");
+                     return ok(result).dump();
+                 });
+             });
 }
 
 // =============================================================================
@@ -292,8 +578,11 @@ decltype(auto) call_with_json_args(Callable &&callable, const json &args) {
         std::make_index_sequence<traits::arity>{});
 }
 
+// `metrics` (opcional) precisa viver enquanto o binding existir; ver
+// bind_typed_with_meta, que usa o registry global
 template <typename F>
-void bind_typed(webview::webview &w, std::string name, F &&func) {
+void bind_typed(webview::webview &w, std::string name, F &&func,
+                metrics::BindingMetrics *metrics = nullptr) {
     using Callable = std::decay_t<F>;
     using traits = function_traits<Callable>;
     using result_t = typename traits::result_type;
@@ -302,33 +591,64 @@ void bind_typed(webview::webview &w, std::string name, F &&func) {
     static_assert(traits::arity <= 32,
                   "Too many arguments for binding"); // Bounded arity
 
-    bind_json(
+    const char *trace_name = trace::intern(name);
+    bind_raw(
         w, std::move(name),
-        [callable = Callable(std::forward<F>(func))](const json &args) -> json {
-            // Validação de argumentos (error checking)
-            if (!args.is_array()) {
-                throw BindingError("Arguments must be a JSON array",
-                                   ErrorCode::InvalidArgs);
-            }
-            if (args.size() > traits::arity) {
-                // Permitir extras, mas logar (não fatal)
-                std::cout << "[WARNING] Extra arguments ignored\n";
-            }
+        [callable = Callable(std::forward<F>(func)), trace_name,
+         metrics](const std::string &args_str) -> std::string {
+            APP_TRACE_SPAN("binding", trace_name);
+            const watchdog::TaskScope task(trace_name);
+            const auto body = [&callable,
+                               trace_name](const json &args) -> std::string {
+                if (args.size() > traits::arity) {
+                    // Permitir extras, mas logar (não fatal)
+                    APP_LOG_WARN("BIND", "Argumentos extras ignorados em ",
+                                 trace_name);
+                }
 
-            try {
-                if constexpr (std::is_void_v<result_t>) {
-                    call_with_json_args(callable, args);
-                    return json::object();
-                } else {
-                    auto result = call_with_json_args(callable, args);
-                    return JsConv<std::decay_t<result_t>>::to_json(result);
+                try {
+                    if constexpr (std::is_void_v<result_t>) {
+                        {
+                            APP_TRACE_SPAN("binding", "handler");
+                            call_with_json_args(callable, args);
+                        }
+                        return ok(json::object()).dump();
+                    } else {
+                        auto result = [&] {
+                            APP_TRACE_SPAN("binding", "handler");
+                            return call_with_json_args(callable, args);
+                        }();
+                        APP_TRACE_SPAN("binding", "serialize");
+                        if constexpr (std::is_same_v<std::decay_t<result_t>,
+                                                     RawJson>) {
+                            return ok_raw(result);
+                        } else if constexpr (std::is_same_v<
+                                                 std::decay_t<result_t>,
+                                                 Stream>) {
+                            return ok_raw(
+                                stream_registry().open(std::move(result)));
+                        } else {
+                            return ok(JsConv<std::decay_t<result_t>>::to_json(
+                                          result))
+                                .dump();
+                        }
+                    }
+                } catch (const BindingError &) {
+                    throw; // Re-throw custom errors
+                } catch (const std::exception &e) {
+                    throw BindingError(std::string("Internal error: ") +
+                                           e.what(),
+                                       ErrorCode::InternalError);
                 }
-            } catch (const BindingError &) {
-                throw; // Re-throw custom errors
-            } catch (const std::exception &e) {
-                throw BindingError(std::string("Internal error: ") + e.what(),
-                                   ErrorCode::InternalError);
+            };
+
+            if (!metrics) {
+                return guarded_call(args_str, body);
             }
+            const auto begin = std::chrono::steady_clock::now();
+            auto response = guarded_call(args_str, body, metrics);
+            record_call(*metrics, args_str, response, begin);
+            return response;
         });
 }
 
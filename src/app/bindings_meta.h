@@ -51,6 +51,12 @@ template <> struct TsType<int> {
 template <> struct TsType<long> {
     static std::string name() { return "number"; }
 };
+template <> struct TsType<unsigned long> {
+    static std::string name() { return "number"; }
+};
+template <> struct TsType<unsigned long long> {
+    static std::string name() { return "number"; }
+};
 template <> struct TsType<double> {
     static std::string name() { return "number"; }
 };
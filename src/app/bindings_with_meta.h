@@ -10,7 +10,9 @@ void bind_typed_with_meta(
     webview::webview &w, const std::string &name, F &&func,
     std::source_location begin = std::source_location::current(),
     std::source_location end = std::source_location::current()) {
-    bind_typed(w, name, std::forward<F>(func));
+    // métricas (chamadas, erros, bytes, latência) sob o mesmo nome
+    bind_typed(w, name, std::forward<F>(func),
+               &metrics::registry().binding(name));
     // registra metadados para geração de .d.ts e índice (começo/fim)
     meta::register_binding_meta<F>(name, begin, end);
 }
@@ -0,0 +1,402 @@
+#pragma once
+// =============================================================================
+// BlobStore - Buffers grandes compartilhados entre janelas por handle
+// =============================================================================
+// Lógica pura (sem GTK). Em vez de passar o payload (stringify -> bridge ->
+// parse -> dump -> eval a cada salto), uma janela guarda os bytes aqui
+// (putBlob) e passa só o handle; quem recebe lê com getBlob ou, com a UI
+// servida por app://, direto de app://ui/__blobs/<handle> (fetch sem cópia:
+// o WebKit lê do mesmo buffer).
+//
+// Endereçado por conteúdo: o handle é o hash dos bytes, então o mesmo
+// conteúdo é guardado uma vez (colisão de hash vira sufixo, os bytes são
+// comparados). Cada put/retain conta uma referência para a janela dona;
+// release (ou o fechamento da janela) devolve. Sem referências o blob fica
+// como cache até sair pelo LRU.
+//
+// Teto de memória (memory_cap): passando dele, saem primeiro os blobs sem
+// referência, do menos usado para o mais; com spill_dir configurado, os
+// referenciados vão para o disco e voltam no próximo get.
+// =============================================================================
+
+#include "app/metrics.h"
+#include "app/resource_server.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+namespace app {
+
+// Path dos blobs no esquema app:// (mesma origem da UI)
+inline constexpr std::string_view BLOB_PATH_PREFIX = "/__blobs/";
+inline constexpr std::string_view BLOB_URL_BASE = "app://ui/__blobs/";
+
+struct BlobStoreOptions {
+    std::size_t memory_cap = std::size_t{256} * 1024 * 1024;
+    std::filesystem::path spill_dir; // vazio = sem spill
+};
+
+class BlobStore {
+  public:
+    using Data = std::shared_ptr<const std::string>;
+    using Options = BlobStoreOptions;
+
+    struct Blob {
+        std::string handle;
+        std::string mime;
+        Data data;
+    };
+
+    struct Stats {
+        std::size_t blobs = 0;
+        std::size_t memory_bytes = 0;
+        std::size_t spilled_blobs = 0;
+        std::size_t spilled_bytes = 0;
+        std::uint64_t evictions = 0;
+        std::uint64_t spills = 0;
+        std::uint64_t loads = 0;
+    };
+
+    explicit BlobStore(Options options = {})
+        : options_(std::move(options)),
+          memory_gauge_(metrics::registry().gauge("blobs_memory_bytes")),
+          spilled_gauge_(metrics::registry().gauge("blobs_spilled_bytes")) {}
+
+    ~BlobStore() {
+        std::lock_guard<std::mutex> lock(mu_);
+        for (const auto &entry : blobs_) {
+            if (entry.second.spilled) {
+                remove_spill_file(entry.first);
+            }
+        }
+        memory_gauge_.set(0);
+        spilled_gauge_.set(0);
+    }
+
+    BlobStore(const BlobStore &) = delete;
+    BlobStore &operator=(const BlobStore &) = delete;
+
+    // Guarda os bytes (ou reaproveita o blob igual) e conta uma referência
+    // para `owner`. O mime não entra na chave: num blob reaproveitado vale
+    // o do primeiro put, e o retorno traz o guardado (não o pedido).
+    Blob put(const std::string &owner, std::string bytes,
+             std::string mime = {}) {
+        const std::string base = hash_handle(bytes);
+        std::lock_guard<std::mutex> lock(mu_);
+        std::string handle = base;
+        for (unsigned suffix = 1;; ++suffix) {
+            auto it = blobs_.find(handle);
+            if (it == blobs_.end()) {
+                break;
+            }
+            const Data existing = it->second.size == bytes.size()
+                                      ? load_locked(handle, it->second)
+                                      : nullptr;
+            if (existing && *existing == bytes) {
+                add_ref_locked(owner, it->second);
+                touch_locked(handle, it->second);
+                enforce_cap_locked(handle);
+                publish_locked();
+                return Blob{handle, it->second.mime, existing};
+            }
+            handle = base + "-" + std::to_string(suffix); // colisão
+        }
+
+        Entry &entry = blobs_[handle];
+        entry.size = bytes.size();
+        entry.mime = mime.empty() ? "application/octet-stream" : mime;
+        entry.data = std::make_shared<const std::string>(std::move(bytes));
+        memory_bytes_ += entry.size;
+        lru_.push_front(handle);
+        entry.lru = lru_.begin();
+        add_ref_locked(owner, entry);
+        Blob stored{handle, entry.mime, entry.data};
+        enforce_cap_locked(handle);
+        publish_locked();
+        return stored;
+    }
+
+    // Bytes do blob (recarrega do disco se foi para o spill)
+    std::optional<Blob> get(const std::string &handle) {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = blobs_.find(handle);
+        if (it == blobs_.end()) {
+            return std::nullopt;
+        }
+        Data data = load_locked(handle, it->second);
+        if (!data) {
+            return std::nullopt;
+        }
+        touch_locked(handle, it->second);
+        enforce_cap_locked(handle);
+        publish_locked();
+        return Blob{handle, it->second.mime, std::move(data)};
+    }
+
+    // Mais uma referência (ex: a janela que recebeu o handle vai guardá-lo)
+    bool retain(const std::string &owner, const std::string &handle) {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = blobs_.find(handle);
+        if (it == blobs_.end()) {
+            return false;
+        }
+        add_ref_locked(owner, it->second);
+        return true;
+    }
+
+    bool release(const std::string &owner, const std::string &handle) {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = blobs_.find(handle);
+        if (it == blobs_.end()) {
+            return false;
+        }
+        auto owner_it = it->second.owners.find(owner);
+        if (owner_it == it->second.owners.end()) {
+            return false;
+        }
+        if (--owner_it->second == 0) {
+            it->second.owners.erase(owner_it);
+        }
+        --it->second.refs;
+        unreferenced_locked(it);
+        publish_locked();
+        return true;
+    }
+
+    // A janela fechou: devolve todas as referências dela
+    std::size_t release_owner(const std::string &owner) {
+        std::lock_guard<std::mutex> lock(mu_);
+        std::size_t released = 0;
+        for (auto it = blobs_.begin(); it != blobs_.end();) {
+            auto next = std::next(it);
+            auto owner_it = it->second.owners.find(owner);
+            if (owner_it != it->second.owners.end()) {
+                released += owner_it->second;
+                it->second.refs -= owner_it->second;
+                it->second.owners.erase(owner_it);
+                unreferenced_locked(it);
+            }
+            it = next;
+        }
+        publish_locked();
+        return released;
+    }
+
+    [[nodiscard]] Stats stats() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        Stats out = stats_;
+        out.blobs = blobs_.size();
+        out.memory_bytes = memory_bytes_;
+        out.spilled_bytes = spilled_bytes_;
+        for (const auto &entry : blobs_) {
+            out.spilled_blobs += entry.second.spilled ? 1 : 0;
+        }
+        return out;
+    }
+
+    // Handle válido para URL/arquivo: só hex e '-'
+    [[nodiscard]] static bool valid_handle(std::string_view handle) {
+        if (handle.empty() || handle.size() > 32) {
+            return false;
+        }
+        for (const char c : handle) {
+            const bool hex = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+            if (!hex && c != '-') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    struct Entry {
+        std::size_t size = 0;
+        std::string mime;
+        Data data; // nulo = no disco
+        bool spilled = false;
+        std::size_t refs = 0;
+        std::map<std::string, std::size_t> owners;
+        std::list<std::string>::iterator lru; // válido com data != nullptr
+    };
+
+    using Blobs = std::unordered_map<std::string, Entry>;
+
+    // FNV-1a 64 bits, em hex
+    static std::string hash_handle(std::string_view bytes) {
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (const char c : bytes) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string out;
+        for (int shift = 60; shift >= 0; shift -= 4) {
+            out.push_back(digits[(hash >> shift) & 0xFU]);
+        }
+        return out;
+    }
+
+    static void add_ref_locked(const std::string &owner, Entry &entry) {
+        ++entry.owners[owner];
+        ++entry.refs;
+    }
+
+    void touch_locked(const std::string &handle, Entry &entry) {
+        if (entry.data) {
+            lru_.erase(entry.lru);
+            lru_.push_front(handle);
+            entry.lru = lru_.begin();
+        }
+    }
+
+    // Sem referências: fica como cache em memória; no disco não vale a
+    // pena (sai de vez)
+    void unreferenced_locked(Blobs::iterator it) {
+        if (it->second.refs == 0 && it->second.spilled) {
+            remove_spill_file(it->first);
+            spilled_bytes_ -= it->second.size;
+            blobs_.erase(it);
+        }
+    }
+
+    std::filesystem::path spill_path(const std::string &handle) const {
+        return options_.spill_dir / (handle + ".blob");
+    }
+
+    void remove_spill_file(const std::string &handle) const {
+        std::error_code ec;
+        std::filesystem::remove(spill_path(handle), ec);
+    }
+
+    // Dados em memória, lendo do spill se preciso (nulo se o arquivo sumiu)
+    Data load_locked(const std::string &handle, Entry &entry) {
+        if (entry.data) {
+            return entry.data;
+        }
+        std::ifstream in(spill_path(handle), std::ios::binary);
+        std::string bytes(entry.size, '\0');
+        if (!in.read(bytes.data(), static_cast<std::streamsize>(entry.size))) {
+            return nullptr;
+        }
+        remove_spill_file(handle);
+        entry.data = std::make_shared<const std::string>(std::move(bytes));
+        entry.spilled = false;
+        spilled_bytes_ -= entry.size;
+        memory_bytes_ += entry.size;
+        lru_.push_front(handle);
+        entry.lru = lru_.begin();
+        ++stats_.loads;
+        return entry.data;
+    }
+
+    bool spill_locked(const std::string &handle, Entry &entry) {
+        std::error_code ec;
+        std::filesystem::create_directories(options_.spill_dir, ec);
+        std::ofstream out(spill_path(handle),
+                          std::ios::binary | std::ios::trunc);
+        if (!out || !out.write(entry.data->data(),
+                               static_cast<std::streamsize>(entry.size))) {
+            remove_spill_file(handle);
+            return false;
+        }
+        // Quem já leu (ex: resposta app:// em andamento) segura o seu
+        entry.data.reset();
+        entry.spilled = true;
+        memory_bytes_ -= entry.size;
+        spilled_bytes_ += entry.size;
+        lru_.erase(entry.lru);
+        ++stats_.spills;
+        return true;
+    }
+
+    // Acima do teto: primeiro descarta os sem referência, depois manda os
+    // referenciados para o disco (LRU nos dois casos). `keep` é o blob que
+    // acabou de ser usado.
+    void enforce_cap_locked(const std::string &keep) {
+        for (const bool spill : {false, true}) {
+            if (spill && options_.spill_dir.empty()) {
+                return;
+            }
+            auto it = lru_.end();
+            while (memory_bytes_ > options_.memory_cap && it != lru_.begin()) {
+                const auto victim = std::prev(it);
+                auto blob = blobs_.find(*victim);
+                if (*victim == keep || (blob->second.refs == 0) == spill) {
+                    it = victim;
+                    continue;
+                }
+                // `it` continua válido: só o nó da vítima sai do LRU
+                if (!spill) {
+                    memory_bytes_ -= blob->second.size;
+                    lru_.erase(victim);
+                    blobs_.erase(blob);
+                    ++stats_.evictions;
+                } else if (!spill_locked(blob->first, blob->second)) {
+                    it = victim;
+                }
+            }
+        }
+    }
+
+    void publish_locked() {
+        memory_gauge_.set(static_cast<std::int64_t>(memory_bytes_));
+        spilled_gauge_.set(static_cast<std::int64_t>(spilled_bytes_));
+    }
+
+    const Options options_;
+    metrics::Gauge &memory_gauge_;
+    metrics::Gauge &spilled_gauge_;
+    mutable std::mutex mu_;
+    Blobs blobs_;
+    std::list<std::string> lru_; // frente = mais recente (só em memória)
+    std::size_t memory_bytes_ = 0;
+    std::size_t spilled_bytes_ = 0;
+    Stats stats_;
+};
+
+// =============================================================================
+// Ponte com o esquema app:// e com o bridge JSON
+// =============================================================================
+
+// Asset de app://ui/__blobs/<handle>: o buffer vai junto (owner) e o
+// WebKit lê dele sem cópia. Conteúdo endereçado = imutável.
+[[nodiscard]] inline std::optional<resources::Asset>
+blob_asset(BlobStore &store, std::string_view path) {
+    if (path.substr(0, BLOB_PATH_PREFIX.size()) != BLOB_PATH_PREFIX) {
+        return std::nullopt;
+    }
+    const std::string handle(path.substr(BLOB_PATH_PREFIX.size()));
+    if (!BlobStore::valid_handle(handle)) {
+        return std::nullopt;
+    }
+    auto blob = store.get(handle);
+    if (!blob) {
+        return std::nullopt;
+    }
+    struct Body {
+        BlobStore::Data data;
+        std::string etag;
+        std::string mime;
+    };
+    auto body = std::make_shared<Body>(
+        Body{blob->data, '"' + handle + '"', std::move(blob->mime)});
+    resources::Asset asset{path, *body->data, body->etag};
+    asset.mime = body->mime;
+    asset.immutable = true;
+    asset.owner = std::move(body);
+    return asset;
+}
+
+} // namespace app
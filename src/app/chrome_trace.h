@@ -0,0 +1,77 @@
+#pragma once
+// =============================================================================
+// Chrome trace - Serialização no formato Trace Event (chrome://tracing,
+// Perfetto UI)
+// =============================================================================
+// Só o subconjunto que usamos: spans completos ("X"), instantes ("i"),
+// contadores ("C") e metadados com o nome de cada thread ("M"). Tempos em
+// microssegundos relativos a uma origem escolhida pelo chamador.
+// =============================================================================
+
+#include <cstdint>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace app::trace {
+
+struct ChromeEvent {
+    std::string name;
+    std::string category;
+    char phase = 'X';
+    std::int64_t ts_us = 0;
+    std::int64_t dur_us = 0; // só para "X"
+    std::uint32_t tid = 0;
+    nlohmann::json args; // null = sem args
+};
+
+using ThreadNames = std::vector<std::pair<std::uint32_t, std::string>>;
+
+[[nodiscard]] inline std::string
+to_chrome_trace(const std::vector<ChromeEvent> &events,
+                const ThreadNames &thread_names = {}) {
+    nlohmann::json out = nlohmann::json::array();
+    for (const auto &[tid, name] : thread_names) {
+        out.push_back({{"name", "thread_name"},
+                       {"ph", "M"},
+                       {"pid", 1},
+                       {"tid", tid},
+                       {"args", {{"name", name}}}});
+    }
+    for (const auto &event : events) {
+        nlohmann::json entry = {{"name", event.name},
+                                {"cat", event.category},
+                                {"ph", std::string(1, event.phase)},
+                                {"ts", event.ts_us},
+                                {"pid", 1},
+                                {"tid", event.tid}};
+        if (event.phase == 'X') {
+            entry["dur"] = event.dur_us;
+        } else if (event.phase == 'i') {
+            entry["s"] = "t"; // instante no escopo da thread
+        }
+        if (!event.args.is_null()) {
+            entry["args"] = event.args;
+        }
+        out.push_back(std::move(entry));
+    }
+    return nlohmann::json{{"traceEvents", std::move(out)},
+                          {"displayTimeUnit", "ms"}}
+        .dump();
+}
+
+// false se o arquivo não pôde ser escrito
+inline bool write_chrome_trace(const std::string &path,
+                               const std::vector<ChromeEvent> &events,
+                               const ThreadNames &thread_names = {}) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file << to_chrome_trace(events, thread_names);
+    return static_cast<bool>(file);
+}
+
+} // namespace app::trace
@@ -24,13 +24,21 @@ struct Options {
     int width = 0;          // Largura da janela (0 = usar padrão)
     int height = 0;         // Altura da janela (0 = usar padrão)
     std::string url;        // URL customizada para navegação
+    bool cross_origin_isolated = false; // Servir UI com COOP/COEP
+    int shutdown_timeout_ms = 0; // Prazo do shutdown (0 = usar padrão)
+    bool profile_startup = false; // Medir fases do startup (trace Chrome)
+    bool trace = false;           // Spans de bindings/janelas (trace Chrome)
+    int metrics_interval_s = 0;   // Dump periódico das métricas (0 = não)
+    int stall_threshold_ms = -1;  // Watchdog (-1 = padrão, 0 = desligado)
+    std::string blob_spill_dir;   // Spill do blob store (vazio = só memória)
+    std::string state_file;       // Estado persistido (vazio = padrão)
 };
 
 // =============================================================================
 // Especificações das opções
 // =============================================================================
 
-inline constexpr std::array<cli::OptionSpec<Options>, 7> OPTION_SPECS = {{
+inline constexpr std::array<cli::OptionSpec<Options>, 15> OPTION_SPECS = {{
     {
         .long_name = "dev",
         .short_name = 'd',
@@ -118,6 +126,149 @@ inline constexpr std::array<cli::OptionSpec<Options>, 7> OPTION_SPECS = {{
                     std::string_view val) { cfg.url = std::string(val); },
         .required = false,
     },
+    {
+        .long_name = "cross-origin-isolated",
+        .short_name = '\0',
+        .takes_value = false,
+        .value_name = "",
+        .help = "Serve the UI cross-origin isolated (COOP/COEP)",
+        .long_help =
+            "Adds Cross-Origin-Opener-Policy: same-origin and\n"
+            "Cross-Origin-Embedder-Policy: require-corp to the UI responses,\n"
+            "enabling SharedArrayBuffer, Atomics.wait and high-resolution\n"
+            "timers. Applies to the embedded UI (app://) and to a Vite dev\n"
+            "server started by the app.",
+        .allowed_values = {},
+        .apply =
+            [](Options &cfg, std::string_view) {
+                cfg.cross_origin_isolated = true;
+            },
+        .required = false,
+    },
+    {
+        .long_name = "shutdown-timeout",
+        .short_name = '\0',
+        .takes_value = true,
+        .value_name = "<ms>",
+        .help = "Deadline for graceful shutdown",
+        .long_help =
+            "Maximum time, in milliseconds, to drain in-flight calls and the\n"
+            "UI queue and to let windows persist their layout on shutdown.\n"
+            "Phases still pending at the deadline are cut short and reported.",
+        .allowed_values = {},
+        .apply =
+            [](Options &cfg, std::string_view val) {
+                cfg.shutdown_timeout_ms = std::stoi(std::string(val));
+            },
+        .required = false,
+    },
+    {
+        .long_name = "profile-startup",
+        .short_name = '\0',
+        .takes_value = false,
+        .value_name = "",
+        .help = "Print a startup phase breakdown and write a Chrome trace",
+        .long_help =
+            "Records the startup phases (signal setup, dev server wait,\n"
+            "webview construction, bindings, navigation) plus the\n"
+            "DOMContentLoaded and first paint reported by the UI. Prints a\n"
+            "breakdown once the main window paints and writes\n"
+            "startup-trace.json (open in chrome://tracing or Perfetto).",
+        .allowed_values = {},
+        .apply =
+            [](Options &cfg, std::string_view) { cfg.profile_startup = true; },
+        .required = false,
+    },
+    {
+        .long_name = "trace",
+        .short_name = '\0',
+        .takes_value = false,
+        .value_name = "",
+        .help = "Record binding and window spans, write native-trace.json",
+        .long_help =
+            "Records spans for every binding call (parse, handler,\n"
+            "serialize), window creation/close/events and drag ticks, plus\n"
+            "the UI's performance.mark/measure entries. The trace is written\n"
+            "to native-trace.json on dumpNativeTrace() and on shutdown.",
+        .allowed_values = {},
+        .apply = [](Options &cfg, std::string_view) { cfg.trace = true; },
+        .required = false,
+    },
+    {
+        .long_name = "metrics-interval",
+        .short_name = '\0',
+        .takes_value = true,
+        .value_name = "<seconds>",
+        .help = "Write binding metrics to native-metrics.txt periodically",
+        .long_help =
+            "Rewrites native-metrics.txt every <seconds> (and once more on\n"
+            "shutdown) with per-binding call and error counts, request and\n"
+            "response bytes and p50/p99/p999 latency. The same data is\n"
+            "always available to the UI through getNativeMetrics().",
+        .allowed_values = {},
+        .apply =
+            [](Options &cfg, std::string_view val) {
+                cfg.metrics_interval_s = std::stoi(std::string(val));
+            },
+        .required = false,
+    },
+    {
+        .long_name = "stall-threshold",
+        .short_name = '\0',
+        .takes_value = true,
+        .value_name = "<ms>",
+        .help = "Report main loop stalls longer than <ms> (0 disables)",
+        .long_help =
+            "A watchdog thread checks a heartbeat from the UI main loop and,\n"
+            "when it stops for longer than <ms> (default 250), logs the\n"
+            "native task that was running (binding, window creation, event\n"
+            "delivery, drag tick) with a stack sample of the UI thread.\n"
+            "Reports, including requestAnimationFrame gaps seen by each\n"
+            "window, are available through getStallReports(). 0 disables.",
+        .allowed_values = {},
+        .apply =
+            [](Options &cfg, std::string_view val) {
+                cfg.stall_threshold_ms = std::stoi(std::string(val));
+            },
+        .required = false,
+    },
+    {
+        .long_name = "blob-spill-dir",
+        .short_name = '\0',
+        .takes_value = true,
+        .value_name = "<dir>",
+        .help = "Spill referenced blobs to <dir> above the memory cap",
+        .long_help =
+            "Blobs shared between windows (putBlob) live in memory up to\n"
+            "256 MB. Above that, unreferenced blobs are dropped first; with\n"
+            "this option, blobs still referenced by a window are written to\n"
+            "<dir> and read back on the next access instead of staying in\n"
+            "memory. Spill files are removed on exit.",
+        .allowed_values = {},
+        .apply =
+            [](Options &cfg, std::string_view val) {
+                cfg.blob_spill_dir = std::string(val);
+            },
+        .required = false,
+    },
+    {
+        .long_name = "state-file",
+        .short_name = '\0',
+        .takes_value = true,
+        .value_name = "<path>",
+        .help = "Save the main window layout to <path> on exit",
+        .long_help =
+            "On shutdown the main window's dock layout is written to <path>\n"
+            "(default window-state.json in the current directory) and\n"
+            "restored on the next start. The file is replaced atomically;\n"
+            "an unreadable file is ignored and the default layout is used.",
+        .allowed_values = {},
+        .apply =
+            [](Options &cfg, std::string_view val) {
+                cfg.state_file = std::string(val);
+            },
+        .required = false,
+    },
 }};
 
 // =============================================================================
@@ -133,7 +284,8 @@ inline cli::OptionParser<Options> create_parser() {
             "  app --dev              # Force development mode\n"
             "  app --prod             # Force production mode\n"
             "  app --url http://localhost:3000  # Use custom URL\n"
-            "  app -W 1920 -H 1080    # Custom window size\n");
+            "  app -W 1920 -H 1080    # Custom window size\n"
+            "  app --cross-origin-isolated  # Enable SharedArrayBuffer\n");
 }
 
 } // namespace app
@@ -10,6 +10,31 @@ constexpr const char *WINDOW_TITLE = "Prompt Workbench";
 constexpr int WINDOW_WIDTH = 1280;
 constexpr int WINDOW_HEIGHT = 720;
 
+// Prazo total do shutdown graceful (drenar chamadas/fila, salvar estado)
+constexpr int SHUTDOWN_TIMEOUT_MS = 2000;
+
+// Trace gerado por --profile-startup (diretório atual)
+constexpr const char *STARTUP_TRACE_FILE = "startup-trace.json";
+
+// Trace gerado por --trace (dumpNativeTrace e encerramento)
+constexpr const char *TRACE_FILE = "native-trace.json";
+
+// Watchdog do main loop: travamento a partir de STALL_THRESHOLD_MS; o timer
+// de heartbeat e a thread de vigia rodam a cada STALL_HEARTBEAT_MS
+constexpr int STALL_THRESHOLD_MS = 250;
+constexpr int STALL_HEARTBEAT_MS = 50;
+
+// Métricas em texto gravadas por --metrics-interval
+constexpr const char *METRICS_FILE = "native-metrics.txt";
+
+// Blob store (putBlob/getBlob): teto em memória antes de descartar os sem
+// referência e, com --blob-spill-dir, mandar os referenciados para o disco
+constexpr int BLOB_MEMORY_CAP_MB = 256;
+
+// Estado que sobrevive a reinícios (layout da janela principal), gravado no
+// encerramento; --state-file troca o caminho (padrão: diretório atual)
+constexpr const char *STATE_FILE = "window-state.json";
+
 // Versão (pode ser injetada pelo CMake)
 #ifndef APP_VERSION
 #define APP_VERSION "0.1.0"
@@ -0,0 +1,99 @@
+#pragma once
+// =============================================================================
+// Drag events - Payload compartilhado e eventos dock.* pré-serializados
+// =============================================================================
+// O payload do drag (subárvore de layout, pode ser grande) é serializado uma
+// única vez no início e compartilhado como string imutável. Hover/leave
+// levam só o id do drag; o texto do payload é emendado direto no
+// dock.dragComplete e no retorno dos bindings, sem re-serializar.
+// =============================================================================
+
+#include <cstdint>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+
+namespace app::drag {
+
+using SharedPayload = std::shared_ptr<const std::string>;
+
+[[nodiscard]] inline SharedPayload
+share_payload(const nlohmann::json &payload) {
+    if (payload.is_null()) {
+        return nullptr;
+    }
+    return std::make_shared<const std::string>(payload.dump());
+}
+
+// Literal JSON de uma string (ids de janela são curtos)
+inline void append_quoted(std::string &out, std::string_view text) {
+    out += nlohmann::json(text).dump();
+}
+
+[[nodiscard]] inline std::string hover_event(std::string_view type,
+                                             std::uint64_t drag_id,
+                                             std::string_view origin_id,
+                                             std::string_view target_id) {
+    std::string out;
+    out.reserve(96 + origin_id.size() + target_id.size());
+    out += R"({"type":)";
+    append_quoted(out, type);
+    out += R"(,"payload":{"dragId":)";
+    out += std::to_string(drag_id);
+    out += R"(,"originWindowId":)";
+    append_quoted(out, origin_id);
+    out += R"(,"targetWindowId":)";
+    append_quoted(out, target_id);
+    out += "}}";
+    return out;
+}
+
+[[nodiscard]] inline std::string complete_event(std::uint64_t drag_id,
+                                                std::string_view origin_id,
+                                                std::string_view target_id,
+                                                const SharedPayload &payload) {
+    const std::string_view payload_text =
+        payload ? std::string_view(*payload) : std::string_view("null");
+    std::string out;
+    out.reserve(128 + origin_id.size() + target_id.size() +
+                payload_text.size());
+    out += R"({"type":"dock.dragComplete","payload":{"dragId":)";
+    out += std::to_string(drag_id);
+    out += R"(,"originWindowId":)";
+    append_quoted(out, origin_id);
+    out += R"(,"targetWindowId":)";
+    append_quoted(out, target_id);
+    out += R"(,"dragPayload":)";
+    out += payload_text;
+    out += "}}";
+    return out;
+}
+
+// Cursor em coordenadas locais da janela sob o drag (stream por frame)
+[[nodiscard]] inline std::string cursor_event(std::uint64_t drag_id, int x,
+                                              int y) {
+    std::string out = R"({"type":"dock.dragCursor","payload":{"dragId":)";
+    out += std::to_string(drag_id);
+    out += R"(,"x":)";
+    out += std::to_string(x);
+    out += R"(,"y":)";
+    out += std::to_string(y);
+    out += "}}";
+    return out;
+}
+
+[[nodiscard]] inline std::string drop_zone_event(std::uint64_t drag_id,
+                                                 std::string_view target_id,
+                                                 std::string_view zone) {
+    std::string out = R"({"type":"dock.dropZone","payload":{"dragId":)";
+    out += std::to_string(drag_id);
+    out += R"(,"targetId":)";
+    append_quoted(out, target_id);
+    out += R"(,"zone":)";
+    append_quoted(out, zone);
+    out += "}}";
+    return out;
+}
+
+} // namespace app::drag
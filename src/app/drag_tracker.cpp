@@ -1,6 +1,11 @@
 #include "app/drag_tracker.h"
+#include "app/main_loop.h"
+#include "app/stall_watchdog.h"
+#include "app/tracing.h"
+#include <algorithm>
 #include <chrono>
 #include <optional>
+#include <utility>
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -19,18 +24,6 @@ struct ScreenPoint {
     int y = 0;
 };
 
-struct ScreenRect {
-    int x = 0;
-    int y = 0;
-    int width = 0;
-    int height = 0;
-};
-
-bool contains(const ScreenRect &rect, const ScreenPoint &point) {
-    return point.x >= rect.x && point.x <= rect.x + rect.width &&
-           point.y >= rect.y && point.y <= rect.y + rect.height;
-}
-
 std::optional<ScreenPoint> get_cursor_position() {
 #if defined(_WIN32)
     POINT pt{};
@@ -53,7 +46,8 @@ std::optional<ScreenPoint> get_cursor_position() {
     return ScreenPoint{static_cast<int>(point.x), static_cast<int>(point.y)};
 #elif defined(__linux__)
 #if GTK_MAJOR_VERSION >= 4
-    // TODO: Implementar via GDK4 (gdk_surface_get_device_position).
+    // GDK4 não expõe coordenadas globais (Wayland); o hit test usa
+    // surface_under_pointer() por janela.
     return std::nullopt;
 #else
     auto *display = gdk_display_get_default();
@@ -78,120 +72,182 @@ std::optional<ScreenPoint> get_cursor_position() {
 #endif
 }
 
-std::optional<ScreenRect> get_window_bounds(void *handle) {
+#if defined(__linux__) && GTK_MAJOR_VERSION >= 4
+// true quando o ponteiro está sobre a surface da janela. Funciona também
+// no Wayland, onde só há posições relativas à surface.
+bool surface_under_pointer(void *handle) {
     if (!handle) {
-        return std::nullopt;
+        return false;
     }
-
-#if defined(_WIN32)
-    RECT rect{};
-    if (!GetWindowRect(static_cast<HWND>(handle), &rect)) {
-        return std::nullopt;
+    auto *surface = gtk_native_get_surface(GTK_NATIVE(handle));
+    if (!surface) {
+        return false;
     }
-    return ScreenRect{rect.left, rect.top, rect.right - rect.left,
-                      rect.bottom - rect.top};
-#elif defined(__APPLE__)
-    struct NSPoint {
-        double x;
-        double y;
-    };
-    struct NSSize {
-        double width;
-        double height;
-    };
-    struct NSRect {
-        NSPoint origin;
-        NSSize size;
-    };
-
-    // On x86_64, structs larger than 16 bytes must use objc_msgSend_stret.
-    NSRect frame{};
-#if defined(__x86_64__)
-    using SendStret = void (*)(NSRect *, id, SEL);
-    auto send_frame = reinterpret_cast<SendStret>(objc_msgSend_stret);
-    send_frame(&frame, static_cast<id>(handle), sel_registerName("frame"));
-#else
-    frame = reinterpret_cast<NSRect (*)(id, SEL)>(objc_msgSend)(
-        static_cast<id>(handle), sel_registerName("frame"));
+    auto *seat = gdk_display_get_default_seat(gdk_surface_get_display(surface));
+    auto *pointer = seat ? gdk_seat_get_pointer(seat) : nullptr;
+    if (!pointer) {
+        return false;
+    }
+    double x = 0;
+    double y = 0;
+    GdkModifierType mask{};
+    if (!gdk_surface_get_device_position(surface, pointer, &x, &y, &mask)) {
+        return false;
+    }
+    return x >= 0 && y >= 0 && x < gdk_surface_get_width(surface) &&
+           y < gdk_surface_get_height(surface);
+}
 #endif
-    return ScreenRect{static_cast<int>(frame.origin.x),
-                      static_cast<int>(frame.origin.y),
-                      static_cast<int>(frame.size.width),
-                      static_cast<int>(frame.size.height)};
-#elif defined(__linux__)
+
+using Clock = std::chrono::steady_clock;
+
+// Ticks parados antes de recuar para SLOW_INTERVAL
+constexpr int IDLE_TICKS = 6;
+// Intervalo mínimo entre ticks disparados por eventos de movimento
+constexpr auto MIN_MOTION_GAP = std::chrono::milliseconds(4);
+
+std::chrono::microseconds to_us(Clock::duration value) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::max(value, Clock::duration::zero()));
+}
+
+} // namespace
+
+// =============================================================================
+// Hooks de movimento nativos
+// =============================================================================
+// Conectados só durante o drag. No GTK3 escutam motion-notify-event e
+// drag-motion da webview (o drag HTML5 do WebKit vira um drag GTK entre
+// janelas); no GTK4, um GtkEventControllerMotion na fase de captura.
+// Handlers retornam FALSE: a webview continua recebendo os eventos.
+
+struct DragTracker::MotionHook {
+#if defined(__linux__)
+    GObject *target = nullptr; // weak pointer: zerado se o widget morrer
+    std::vector<gulong> handlers;
 #if GTK_MAJOR_VERSION >= 4
-    // TODO: Implementar via GDK4 (gtk_native_get_surface +
-    // gdk_surface_get_position).
-    return std::nullopt;
-#else
-    int x = 0;
-    int y = 0;
-    int width = 0;
-    int height = 0;
-    gtk_window_get_position(GTK_WINDOW(handle), &x, &y);
-    gtk_window_get_size(GTK_WINDOW(handle), &width, &height);
-    return ScreenRect{x, y, width, height};
+    GtkEventController *controller = nullptr;
 #endif
-#else
-    return std::nullopt;
 #endif
-}
+};
 
-std::string find_window_under_cursor(const std::vector<DragWindow> &windows) {
-    auto cursor = get_cursor_position();
-    if (!cursor) {
-        return {};
-    }
+#if defined(__linux__)
+namespace {
 
-    for (const auto &window : windows) {
-        const auto bounds = get_window_bounds(window.handle);
-        if (!bounds) {
-            continue;
-        }
-        if (contains(*bounds, *cursor)) {
-            return window.id;
-        }
-    }
-    return {};
+#if GTK_MAJOR_VERSION >= 4
+void on_controller_motion(GtkEventControllerMotion *, double, double,
+                          gpointer data) {
+    static_cast<DragTracker *>(data)->on_pointer_motion();
 }
+#else
+gboolean on_motion_notify(GtkWidget *, GdkEventMotion *, gpointer data) {
+    static_cast<DragTracker *>(data)->on_pointer_motion();
+    return FALSE;
+}
+
+gboolean on_drag_motion(GtkWidget *, GdkDragContext *, gint, gint, guint,
+                        gpointer data) {
+    static_cast<DragTracker *>(data)->on_pointer_motion();
+    return FALSE;
+}
+#endif
 
 } // namespace
+#endif
+
+// =============================================================================
+// DragTracker
+// =============================================================================
 
 DragTracker::DragTracker(webview::webview &ui_window,
-                         WindowProvider window_provider, HoverCallback on_hover)
+                         WindowProvider window_provider, HitTester hit_tester,
+                         HoverCallback on_hover)
     : ui_window_(ui_window), window_provider_(std::move(window_provider)),
-      on_hover_(std::move(on_hover)) {}
+      hit_tester_(std::move(hit_tester)), on_hover_(std::move(on_hover)) {}
 
-DragTracker::~DragTracker() {
-    stop();
-    stop_requested_.store(true);
-    if (worker_.joinable()) {
-        worker_.join();
-    }
-}
+DragTracker::~DragTracker() { stop(); }
 
 void DragTracker::start(const std::string &origin_window_id) {
     (void)origin_window_id;
+    stop();
     {
         std::lock_guard<std::mutex> lock(mu_);
         last_hovered_id_.clear();
+        stats_ = {};
     }
+    const std::uint64_t generation = generation_.fetch_add(1) + 1;
+    idle_.store(false);
+    still_ticks_ = 0;
+    motion_pending_ = false;
+    last_cursor_.reset();
+    last_tick_ = Clock::now();
     active_.store(true);
-    ensure_worker();
+
+    if (has_ui_main_loop()) {
+        attach_motion_hooks();
+        schedule_timer(FAST_INTERVAL);
+        return;
+    }
+    fallback_ = executor().schedule_periodic(
+        std::chrono::milliseconds(0), Lane::High, "drag.fallback",
+        [this, generation](std::stop_token)
+            -> std::optional<std::chrono::milliseconds> {
+            return fallback_tick(generation);
+        });
 }
 
 void DragTracker::stop() {
     active_.store(false);
+    generation_.fetch_add(1);
     tick_scheduled_.store(false);
+
+    if (timer_id_ != 0) {
+        remove_ui_timer(timer_id_);
+        timer_id_ = 0;
+    }
+    detach_motion_hooks();
+    // A tarefa só despacha para a UI (nunca a espera): wait() não trava
+    fallback_.cancel();
+    fallback_.wait();
+
     std::lock_guard<std::mutex> lock(mu_);
     last_hovered_id_.clear();
 }
 
 bool DragTracker::active() const { return active_.load(); }
 
-std::string
-DragTracker::current_hovered_id(const std::vector<DragWindow> &windows) const {
-    return find_window_under_cursor(windows);
+void DragTracker::set_move_callback(MoveCallback on_move) {
+    on_move_ = std::move(on_move);
+}
+
+std::string DragTracker::current_hovered_id() const {
+    std::string hovered_id;
+    hit_test(hovered_id);
+    return hovered_id;
+}
+
+// Escreve em `out` o id da janela sob o cursor (vazio se nenhuma). Reusa a
+// capacidade de `out`: sem alocações por tick.
+void DragTracker::hit_test(std::string &out) const {
+    APP_TRACE_SPAN("drag", "hit_test");
+    out.clear();
+#if defined(__linux__) && GTK_MAJOR_VERSION >= 4
+    // Sem coordenadas globais: pergunta a cada surface se o ponteiro está
+    // sobre ela
+    const auto windows =
+        window_provider_ ? window_provider_() : std::vector<DragWindow>{};
+    for (const auto &window : windows) {
+        if (surface_under_pointer(window.handle)) {
+            out.assign(window.id);
+            return;
+        }
+    }
+#else
+    const auto cursor = get_cursor_position();
+    if (cursor && hit_tester_) {
+        hit_tester_(DragCursor{cursor->x, cursor->y}, out);
+    }
+#endif
 }
 
 std::optional<DragCursor> DragTracker::current_cursor_position() const {
@@ -202,50 +258,205 @@ std::optional<DragCursor> DragTracker::current_cursor_position() const {
     return DragCursor{cursor->x, cursor->y};
 }
 
-void DragTracker::ensure_worker() {
-    if (worker_.joinable()) {
+DragStats DragTracker::stats() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return stats_;
+}
+
+void DragTracker::on_pointer_motion() {
+    if (!active_.load()) {
         return;
     }
-    stop_requested_.store(false);
-    worker_ = std::thread([this]() { worker_loop(); });
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        ++stats_.motion_events;
+    }
+    motion_pending_ = true;
+
+    // Cursor voltou a se mexer: sai do modo lento sem esperar o timer
+    if (idle_.exchange(false)) {
+        still_ticks_ = 0;
+        schedule_timer(FAST_INTERVAL);
+    }
+    if (Clock::now() - last_tick_ >= MIN_MOTION_GAP) {
+        tick_ui();
+    }
 }
 
-void DragTracker::worker_loop() {
-    while (!stop_requested_.load()) {
-        if (active_.load() && !tick_scheduled_.exchange(true)) {
-            ui_window_.dispatch([this]() { tick_ui(); });
+void DragTracker::attach_motion_hooks() {
+#if defined(__linux__)
+    const auto windows =
+        window_provider_ ? window_provider_() : std::vector<DragWindow>{};
+    for (const auto &window : windows) {
+        if (!window.handle) {
+            continue;
+        }
+        auto hook = std::make_unique<MotionHook>();
+#if GTK_MAJOR_VERSION >= 4
+        auto *widget = GTK_WIDGET(window.handle);
+        hook->controller = gtk_event_controller_motion_new();
+        gtk_event_controller_set_propagation_phase(hook->controller,
+                                                   GTK_PHASE_CAPTURE);
+        hook->handlers.push_back(
+            g_signal_connect(hook->controller, "motion",
+                             G_CALLBACK(on_controller_motion), this));
+        gtk_widget_add_controller(widget, hook->controller);
+        hook->target = G_OBJECT(widget);
+#else
+        // Eventos chegam na webview (filha da GtkWindow), não na janela
+        GtkWidget *widget = gtk_bin_get_child(GTK_BIN(window.handle));
+        if (!widget) {
+            widget = GTK_WIDGET(window.handle);
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        hook->target = G_OBJECT(widget);
+        hook->handlers.push_back(g_signal_connect(
+            widget, "motion-notify-event", G_CALLBACK(on_motion_notify), this));
+        hook->handlers.push_back(g_signal_connect(
+            widget, "drag-motion", G_CALLBACK(on_drag_motion), this));
+#endif
+        g_object_add_weak_pointer(hook->target,
+                                  reinterpret_cast<gpointer *>(&hook->target));
+        motion_hooks_.push_back(std::move(hook));
     }
+#endif
 }
 
-void DragTracker::tick_ui() {
-    tick_scheduled_.store(false);
-    if (!active_.load()) {
-        return;
+void DragTracker::detach_motion_hooks() {
+#if defined(__linux__)
+    for (auto &hook : motion_hooks_) {
+        if (!hook->target) {
+            continue; // widget já destruído junto com seus handlers
+        }
+#if GTK_MAJOR_VERSION >= 4
+        // Remover o controller também desconecta seus handlers
+        gtk_widget_remove_controller(GTK_WIDGET(hook->target),
+                                     hook->controller);
+#else
+        for (const gulong id : hook->handlers) {
+            g_signal_handler_disconnect(hook->target, id);
+        }
+#endif
+        g_object_remove_weak_pointer(
+            hook->target, reinterpret_cast<gpointer *>(&hook->target));
     }
+#endif
+    motion_hooks_.clear();
+}
 
-    const auto windows =
-        window_provider_ ? window_provider_() : std::vector<DragWindow>{};
-    const std::string hovered_id = find_window_under_cursor(windows);
+void DragTracker::schedule_timer(std::chrono::milliseconds interval) {
+    if (timer_id_ != 0) {
+        remove_ui_timer(timer_id_);
+    }
+    next_tick_due_ = Clock::now() + interval;
+    timer_id_ = add_ui_timer(interval, [this]() { return on_timer(); });
+}
 
-    std::string last_hovered;
+// Callback do timer GLib. Retornar false desarma o timer atual; usado para
+// trocar o intervalo (um novo timer já foi armado em timer_id_).
+bool DragTracker::on_timer() {
+    if (!active_.load()) {
+        timer_id_ = 0;
+        return false;
+    }
+    const auto now = Clock::now();
     {
         std::lock_guard<std::mutex> lock(mu_);
-        last_hovered = last_hovered_id_;
+        stats_.max_tick_lateness =
+            std::max(stats_.max_tick_lateness, to_us(now - next_tick_due_));
     }
 
-    if (hovered_id == last_hovered) {
+    const bool was_idle = idle_.load();
+    const std::uint64_t generation = generation_.load();
+    tick_ui();
+    // O callback do tick pode ter parado (ou reiniciado) o rastreio: stop()
+    // já removeu este timer e zerou timer_id_, não há o que rearmar
+    if (!active_.load() || generation_.load() != generation) {
+        return false;
+    }
+    const auto interval = was_idle ? SLOW_INTERVAL : FAST_INTERVAL;
+    if (idle_.load() != was_idle) {
+        const auto next = idle_.load() ? SLOW_INTERVAL : FAST_INTERVAL;
+        next_tick_due_ = now + next;
+        timer_id_ = add_ui_timer(next, [this]() { return on_timer(); });
+        return false;
+    }
+    next_tick_due_ = now + interval;
+    return true;
+}
+
+// Sem main loop GLib: tarefa periódica (lane High) do executor, cancelada
+// em stop() sem esperar o intervalo corrente. Devolve o próximo intervalo.
+std::chrono::milliseconds DragTracker::fallback_tick(std::uint64_t generation) {
+    if (!tick_scheduled_.exchange(true)) {
+        const auto due = Clock::now();
+        ui_window_.dispatch([this, generation, due]() {
+            tick_scheduled_.store(false);
+            if (!active_.load() || generation_.load() != generation) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> stats_lock(mu_);
+                stats_.max_tick_lateness = std::max(
+                    stats_.max_tick_lateness, to_us(Clock::now() - due));
+            }
+            tick_ui();
+        });
+    }
+    return idle_.load() ? SLOW_INTERVAL : FAST_INTERVAL;
+}
+
+// Amostra o cursor; true se ele se moveu desde o último tick
+bool DragTracker::sample() {
+    bool moved = std::exchange(motion_pending_, false);
+    const auto cursor = current_cursor_position();
+    if (cursor && (!last_cursor_ || last_cursor_->x != cursor->x ||
+                   last_cursor_->y != cursor->y)) {
+        moved = true;
+    }
+    last_cursor_ = cursor;
+    return moved;
+}
+
+void DragTracker::tick_ui() {
+    if (!active_.load()) {
         return;
     }
+    APP_TRACE_SPAN("drag", "tick");
+    const watchdog::TaskScope task("drag.tick");
+
+    const auto now = Clock::now();
+    const auto previous_tick = std::exchange(last_tick_, now);
+    const bool moved = sample();
+    if (moved) {
+        still_ticks_ = 0;
+        idle_.store(false);
+    } else if (++still_ticks_ >= IDLE_TICKS) {
+        idle_.store(true);
+    }
+
+    hit_test(hovered_scratch_);
 
+    bool hover_changed = false;
     {
         std::lock_guard<std::mutex> lock(mu_);
-        last_hovered_id_ = hovered_id;
+        ++stats_.ticks;
+        if (hovered_scratch_ != last_hovered_id_) {
+            hover_changed = true;
+            last_hovered_id_.assign(hovered_scratch_);
+            ++stats_.hover_changes;
+            trace::counter("drag", "hover_changes",
+                           static_cast<std::int64_t>(stats_.hover_changes));
+            // A troca aconteceu em algum ponto desde a amostra anterior
+            stats_.max_hover_latency =
+                std::max(stats_.max_hover_latency, to_us(now - previous_tick));
+        }
     }
 
-    if (on_hover_) {
-        on_hover_(hovered_id);
+    if (hover_changed && on_hover_) {
+        on_hover_(hovered_scratch_);
+    }
+    if ((moved || hover_changed) && on_move_ && active_.load()) {
+        on_move_(hovered_scratch_);
     }
 }
 
@@ -1,15 +1,24 @@
 #pragma once
 // =============================================================================
-// DragTracker - Polling do cursor para detectar janela sob o mouse
+// DragTracker - Detecta a janela sob o cursor durante um drag entre janelas
+// =============================================================================
+// Só custa algo enquanto há um drag ativo: o tracker arma um timer no main
+// loop da UI (GLib) com intervalo adaptativo - rápido enquanto o cursor se
+// move, recuando quando parado - e, no GTK3, também reage aos eventos de
+// drag-motion das próprias janelas. Sem drag ativo não há thread nem timer.
+// Plataformas sem main loop GLib usam uma thread que vive só durante o drag.
 // =============================================================================
 
+#include "app/executor.h"
 #include "webview/webview.h"
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
-#include <thread>
 #include <vector>
 
 namespace app {
@@ -24,13 +33,36 @@ struct DragCursor {
     int y = 0;
 };
 
+// Medições do último drag (para comparar latência de hover)
+struct DragStats {
+    std::uint64_t ticks = 0;
+    std::uint64_t motion_events = 0;
+    std::uint64_t hover_changes = 0;
+    // Atraso entre o momento previsto de um tick e sua execução
+    std::chrono::microseconds max_tick_lateness{0};
+    // Pior caso entre o cursor mudar de janela e o callback de hover
+    // (intervalo de amostragem + atraso do tick)
+    std::chrono::microseconds max_hover_latency{0};
+};
+
 class DragTracker {
   public:
     using WindowProvider = std::function<std::vector<DragWindow>()>;
+    // Resolve a janela sob o ponto (coordenadas de tela) escrevendo seu id
+    // em `out`; vazio se nenhuma. Chamado a cada tick: não deve alocar.
+    using HitTester =
+        std::function<void(const DragCursor &cursor, std::string &out)>;
     using HoverCallback = std::function<void(const std::string &)>;
+    // Chamado na thread da UI a cada tick em que o cursor se moveu (ou a
+    // janela sob ele mudou), com o id da janela sob o cursor
+    using MoveCallback = std::function<void(const std::string &)>;
+
+    // Intervalos do timer adaptativo (apenas com drag ativo)
+    static constexpr std::chrono::milliseconds FAST_INTERVAL{8};
+    static constexpr std::chrono::milliseconds SLOW_INTERVAL{50};
 
     DragTracker(webview::webview &ui_window, WindowProvider window_provider,
-                HoverCallback on_hover);
+                HitTester hit_tester, HoverCallback on_hover);
     ~DragTracker();
 
     DragTracker(const DragTracker &) = delete;
@@ -38,28 +70,59 @@ class DragTracker {
     DragTracker(DragTracker &&) = delete;
     DragTracker &operator=(DragTracker &&) = delete;
 
+    // start/stop rodam na thread da UI (callbacks de bind rodam nela)
     void start(const std::string &origin_window_id);
     void stop();
     bool active() const;
-    std::string
-    current_hovered_id(const std::vector<DragWindow> &windows) const;
+    void set_move_callback(MoveCallback on_move);
+    std::string current_hovered_id() const;
     std::optional<DragCursor> current_cursor_position() const;
+    DragStats stats() const;
+
+    // Chamado pelos hooks nativos de movimento (thread da UI)
+    void on_pointer_motion();
 
   private:
-    void ensure_worker();
-    void worker_loop();
+    struct MotionHook;
+
+    void attach_motion_hooks();
+    void detach_motion_hooks();
+    void schedule_timer(std::chrono::milliseconds interval);
+    bool on_timer();
+    std::chrono::milliseconds fallback_tick(std::uint64_t generation);
+    bool sample();
+    void hit_test(std::string &out) const;
     void tick_ui();
 
     webview::webview &ui_window_;
     WindowProvider window_provider_;
+    HitTester hit_tester_;
     HoverCallback on_hover_;
+    MoveCallback on_move_;
 
     std::atomic_bool active_{false};
-    std::atomic_bool stop_requested_{false};
     std::atomic_bool tick_scheduled_{false};
-    std::mutex mu_;
+    std::atomic<std::uint64_t> generation_{0};
+    mutable std::mutex mu_;
     std::string last_hovered_id_;
-    std::thread worker_;
+    DragStats stats_;
+
+    // true quando o cursor está parado: o timer recua para SLOW_INTERVAL
+    std::atomic_bool idle_{false};
+
+    // Estado da thread da UI
+    unsigned int timer_id_ = 0;
+    std::chrono::steady_clock::time_point next_tick_due_;
+    std::chrono::steady_clock::time_point last_tick_;
+    std::optional<DragCursor> last_cursor_;
+    std::string hovered_scratch_;
+    bool motion_pending_ = false;
+    int still_ticks_ = 0;
+    std::vector<std::unique_ptr<MotionHook>> motion_hooks_;
+
+    // Fallback sem main loop GLib: tarefa periódica do executor durante o
+    // drag
+    Task fallback_;
 };
 
 } // namespace app
@@ -0,0 +1,89 @@
+#pragma once
+// =============================================================================
+// Drop zones - Zona de drop do dock calculada no lado nativo
+// =============================================================================
+// Cada janela registra os retângulos dos seus grupos do dock (coordenadas
+// locais da janela, px CSS). Durante um drag entre janelas o tracker
+// converte o cursor para coordenadas locais e resolve aqui a zona - borda
+// mais próxima dentro de EDGE_FRACTION, senão centro - enviando ao JS só
+// as mudanças.
+// =============================================================================
+
+#include "app/window_geometry.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace app::dock {
+
+enum class DropZone : std::uint8_t { None, Left, Right, Top, Bottom, Center };
+
+// Fração da largura/altura do alvo que conta como borda
+inline constexpr double EDGE_FRACTION = 0.25;
+
+[[nodiscard]] inline std::string_view to_string(DropZone zone) {
+    switch (zone) {
+    case DropZone::Left:
+        return "left";
+    case DropZone::Right:
+        return "right";
+    case DropZone::Top:
+        return "top";
+    case DropZone::Bottom:
+        return "bottom";
+    case DropZone::Center:
+        return "center";
+    case DropZone::None:
+        break;
+    }
+    return "none";
+}
+
+struct DropTarget {
+    std::string id;
+    WindowRect rect;
+};
+
+struct DropHit {
+    const DropTarget *target = nullptr;
+    DropZone zone = DropZone::None;
+};
+
+// Alvos registrados depois ficam por cima (ex: grupos flutuantes), então a
+// busca vai do fim para o começo. Sem alocações.
+[[nodiscard]] inline DropHit
+compute_drop_zone(const std::vector<DropTarget> &targets, int x, int y,
+                  double edge_fraction = EDGE_FRACTION) {
+    for (auto it = targets.rbegin(); it != targets.rend(); ++it) {
+        const WindowRect &rect = it->rect;
+        if (rect.empty() || !rect.contains(x, y)) {
+            continue;
+        }
+        const double fx = static_cast<double>(x - rect.x) / rect.width;
+        const double fy = static_cast<double>(y - rect.y) / rect.height;
+        const double left = fx;
+        const double right = 1.0 - fx;
+        const double top = fy;
+        const double bottom = 1.0 - fy;
+        const double nearest = std::min({left, right, top, bottom});
+
+        DropZone zone = DropZone::Center;
+        if (nearest < edge_fraction) {
+            if (nearest == left) {
+                zone = DropZone::Left;
+            } else if (nearest == right) {
+                zone = DropZone::Right;
+            } else if (nearest == top) {
+                zone = DropZone::Top;
+            } else {
+                zone = DropZone::Bottom;
+            }
+        }
+        return {&*it, zone};
+    }
+    return {};
+}
+
+} // namespace app::dock
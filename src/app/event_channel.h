@@ -0,0 +1,212 @@
+#pragma once
+// =============================================================================
+// EventChannel - Fluxo nativo -> JS com sequência e janela de créditos
+// =============================================================================
+// Lógica pura (sem GTK), um canal por janela. Cada evento enviado ganha um
+// número de sequência (`seq`, injetado no JSON) e consome um crédito; o JS
+// confirma o maior seq já consumido (ackNativeEvents, cumulativo) e os
+// créditos voltam. Sem crédito, o destino do evento depende da política do
+// tipo:
+//   Reliable - entra na fila e sai na ordem, conforme os acks chegam
+//   Coalesce - o evento do mesmo tipo que estava na fila sai e o novo vai
+//              para o fim (só o último valor importa, na posição real)
+//   Drop     - descartado (amostra efêmera que o próximo evento refaz)
+// A fila tem teto (MAX_QUEUED): uma página que nunca confirma não cresce a
+// memória sem limite; o excedente é descartado e contado.
+//
+// ack(0) = o receptor reiniciou (reload): o que estava em voo se perdeu com
+// a página antiga, os créditos voltam todos e a fila é liberada.
+//
+// Métricas agregadas de todas as janelas (nomes por janela vazariam um par
+// a cada janela aberta): events_queued (gauge, soma das filas) e
+// events_ack (latência do envio até o ack). Por janela: stats().
+// =============================================================================
+
+#include "app/metrics.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace app {
+
+enum class EventPolicy { Reliable, Coalesce, Drop };
+
+// Política pelo tipo do evento. O cursor do drag chega a cada frame enquanto
+// o mouse anda; zona e geometria só valem pelo último valor; o resto
+// (hover/leave/complete, jobs, mensagens) precisa chegar inteiro.
+[[nodiscard]] inline EventPolicy event_policy(std::string_view type) {
+    if (type == "dock.dragCursor") {
+        return EventPolicy::Drop;
+    }
+    if (type == "dock.dropZone" || type == "native-window.geometry") {
+        return EventPolicy::Coalesce;
+    }
+    return EventPolicy::Reliable;
+}
+
+// Tipo de um evento serializado que começa por {"type":"..." (formato dos
+// eventos montados à mão); vazio se não começa assim
+[[nodiscard]] inline std::string_view raw_event_type(std::string_view event) {
+    constexpr std::string_view PREFIX = R"({"type":")";
+    if (event.substr(0, PREFIX.size()) != PREFIX) {
+        return {};
+    }
+    event.remove_prefix(PREFIX.size());
+    const auto end = event.find_first_of("\"\\");
+    if (end == std::string_view::npos || event[end] != '"') {
+        return {};
+    }
+    return event.substr(0, end);
+}
+
+class EventChannel {
+  public:
+    using Clock = std::chrono::steady_clock;
+    // Entrega o evento (já com seq) à página. Chamado com o lock do canal
+    // travado, para a ordem de envio ser a ordem do seq: só enfileira (ex:
+    // dispatch para a thread da UI), nunca volta ao canal.
+    using Sender = std::function<void(std::string event)>;
+
+    static constexpr std::uint32_t DEFAULT_CREDITS = 64;
+    static constexpr std::size_t MAX_QUEUED = 4096;
+
+    struct Stats {
+        std::uint64_t sent = 0;
+        std::uint64_t acked = 0;
+        std::uint64_t coalesced = 0;
+        std::uint64_t dropped = 0;
+        std::size_t in_flight = 0;
+        std::size_t queued = 0;
+    };
+
+    explicit EventChannel(Sender send, std::uint32_t credits = DEFAULT_CREDITS)
+        : send_(std::move(send)), credits_(credits > 0 ? credits : 1),
+          queued_gauge_(metrics::registry().gauge("events_queued")),
+          ack_latency_(metrics::registry().histogram("events_ack")) {}
+
+    EventChannel(const EventChannel &) = delete;
+    EventChannel &operator=(const EventChannel &) = delete;
+
+    // A fila que morre com o canal sai da soma
+    ~EventChannel() { queued_gauge_.add(-published_queued_); }
+
+    // true se saiu na hora; false se ficou na fila, foi coalescido ou
+    // descartado
+    bool push(std::string_view type, EventPolicy policy, std::string event) {
+        std::lock_guard<std::mutex> lock(mu_);
+        // Com fila, respeita a ordem mesmo que sobre crédito
+        if (queue_.empty() && in_flight_.size() < credits_) {
+            send_locked(std::move(event));
+            return true;
+        }
+        switch (policy) {
+        case EventPolicy::Drop:
+            ++stats_.dropped;
+            return false;
+        case EventPolicy::Coalesce:
+            for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+                if (it->policy == EventPolicy::Coalesce && it->type == type) {
+                    queue_.erase(it);
+                    ++stats_.coalesced;
+                    break;
+                }
+            }
+            break;
+        case EventPolicy::Reliable:
+            break;
+        }
+        if (queue_.size() >= MAX_QUEUED) {
+            ++stats_.dropped;
+            return false;
+        }
+        queue_.push_back({std::string(type), policy, std::move(event)});
+        publish_locked();
+        return false;
+    }
+
+    // Confirma tudo até `seq` e envia o que a fila liberou, na ordem.
+    // Retorna quantos eventos saíram da fila.
+    std::size_t ack(std::uint64_t seq) {
+        const auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(mu_);
+        if (seq == 0) {
+            in_flight_.clear();
+        }
+        while (!in_flight_.empty() && in_flight_.front().seq <= seq) {
+            ack_latency_.record(now - in_flight_.front().sent);
+            in_flight_.pop_front();
+            ++stats_.acked;
+        }
+        std::size_t released = 0;
+        while (!queue_.empty() && in_flight_.size() < credits_) {
+            send_locked(std::move(queue_.front().event));
+            queue_.pop_front();
+            ++released;
+        }
+        publish_locked();
+        return released;
+    }
+
+    [[nodiscard]] Stats stats() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        Stats out = stats_;
+        out.in_flight = in_flight_.size();
+        out.queued = queue_.size();
+        return out;
+    }
+
+  private:
+    struct Pending {
+        std::string type;
+        EventPolicy policy;
+        std::string event;
+    };
+
+    struct InFlight {
+        std::uint64_t seq;
+        Clock::time_point sent;
+    };
+
+    // mu_ travado: {"seq":N, + resto do objeto
+    void send_locked(std::string event) {
+        const std::uint64_t seq = ++next_seq_;
+        in_flight_.push_back({seq, Clock::now()});
+        ++stats_.sent;
+        std::string out = R"({"seq":)";
+        out += std::to_string(seq);
+        if (event.size() > 2) {
+            out += ',';
+        }
+        out.append(event, event.empty() ? 0 : 1);
+        if (event.size() < 2) {
+            out += '}';
+        }
+        send_(std::move(out));
+    }
+
+    // Só a variação: o gauge soma as filas de todos os canais
+    void publish_locked() {
+        const auto queued = static_cast<std::int64_t>(queue_.size());
+        queued_gauge_.add(queued - published_queued_);
+        published_queued_ = queued;
+    }
+
+    const Sender send_;
+    const std::size_t credits_;
+    metrics::Gauge &queued_gauge_;
+    metrics::LatencyHistogram &ack_latency_;
+    std::int64_t published_queued_ = 0; // parcela deste canal no gauge
+    mutable std::mutex mu_;
+    std::uint64_t next_seq_ = 0;
+    std::deque<InFlight> in_flight_;
+    std::deque<Pending> queue_;
+    Stats stats_;
+};
+
+} // namespace app
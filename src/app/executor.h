@@ -0,0 +1,567 @@
+#pragma once
+// =============================================================================
+// Executor - Pool de threads único da aplicação (work stealing)
+// =============================================================================
+// Um worker por núcleo (menos a thread da UI, mínimo 2). Cada worker tem uma
+// deque por lane de prioridade (High, Normal, Background): ele consome a
+// própria deque pelo fim (LIFO, cache quente) e, vazia, rouba o início das
+// deques dos outros, sempre da lane mais prioritária para a menos.
+//
+// - Tarefas recebem um std::stop_token; Task::cancel() pede a parada e, se
+//   a tarefa ainda não começou, ela nem roda. Task::wait() espera o fim.
+// - Atrasos e periódicas passam por uma timer wheel (ticks de 1ms) com uma
+//   thread que só acorda no próximo vencimento (sem timers, não acorda).
+// - post_to_ui() devolve trabalho à thread da UI pelo dispatcher registrado
+//   pela Application (webview::dispatch).
+// - Métricas por lane: executor_<lane>_depth (gauge), _wait (fila até o
+//   início) e _run (execução).
+//
+// Tarefas longas que só esperam (ex: o dev server subir) vão na lane
+// Background e precisam observar o stop_token. Leitura bloqueante de I/O,
+// o watchdog do main loop e a escrita do log mantêm threads próprias.
+// =============================================================================
+
+#include "app/log.h"
+#include "app/metrics.h"
+#include "app/thread_signals.h"
+#include "app/tracing.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+enum class Lane : std::uint8_t { High = 0, Normal = 1, Background = 2 };
+
+inline constexpr std::size_t LANE_COUNT = 3;
+
+[[nodiscard]] inline const char *lane_name(Lane lane) {
+    switch (lane) {
+    case Lane::High:
+        return "high";
+    case Lane::Normal:
+        return "normal";
+    case Lane::Background:
+        return "background";
+    }
+    return "unknown";
+}
+
+namespace detail {
+
+// Corpo de tarefa normalizado: devolve o próximo intervalo (periódicas) ou
+// nullopt para terminar
+using TaskBody =
+    std::function<std::optional<std::chrono::milliseconds>(std::stop_token)>;
+
+struct TaskState {
+    Lane lane = Lane::Normal;
+    const char *name = "task";
+    TaskBody body;
+    std::stop_source stop;
+    std::chrono::steady_clock::time_point enqueued;
+
+    std::mutex mu;
+    std::condition_variable cv;
+    bool running = false;
+    bool finished = false;
+
+    // false se a tarefa foi cancelada (ou já terminou) antes de começar
+    bool try_begin() {
+        std::lock_guard<std::mutex> lock(mu);
+        if (finished || stop.stop_requested()) {
+            finished = true;
+            cv.notify_all();
+            return false;
+        }
+        running = true;
+        return true;
+    }
+
+    void end(bool again) {
+        std::lock_guard<std::mutex> lock(mu);
+        running = false;
+        if (!again || stop.stop_requested()) {
+            finished = true;
+        }
+        cv.notify_all();
+    }
+
+    void cancel() {
+        stop.request_stop();
+        std::lock_guard<std::mutex> lock(mu);
+        if (!running) {
+            finished = true;
+        }
+        cv.notify_all();
+    }
+};
+
+template <typename F> TaskBody make_once(F &&fn) {
+    return [fn = std::forward<F>(fn)](
+               std::stop_token stop) mutable
+           -> std::optional<std::chrono::milliseconds> {
+        if constexpr (std::is_invocable_v<F &, std::stop_token>) {
+            fn(std::move(stop));
+        } else {
+            fn();
+        }
+        return std::nullopt;
+    };
+}
+
+} // namespace detail
+
+// Handle de uma tarefa. Vazio (default) ignora cancel/wait.
+class Task {
+  public:
+    Task() = default;
+    explicit Task(std::shared_ptr<detail::TaskState> state)
+        : state_(std::move(state)) {}
+
+    explicit operator bool() const { return state_ != nullptr; }
+
+    // Pede a parada; não espera (ver wait)
+    void cancel() {
+        if (state_) {
+            state_->cancel();
+        }
+    }
+
+    // Espera a tarefa terminar (periódicas: só depois de cancel()). Não
+    // chamar de dentro da própria tarefa.
+    void wait() {
+        if (!state_) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(state_->mu);
+        state_->cv.wait(lock, [this] { return state_->finished; });
+    }
+
+    [[nodiscard]] bool done() const {
+        if (!state_) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(state_->mu);
+        return state_->finished;
+    }
+
+  private:
+    std::shared_ptr<detail::TaskState> state_;
+};
+
+class Executor {
+  public:
+    using Clock = std::chrono::steady_clock;
+    using UiDispatcher = std::function<void(std::function<void()>)>;
+
+    static constexpr std::chrono::milliseconds TIMER_TICK{1};
+    static constexpr std::size_t WHEEL_SLOTS = 512;
+
+    [[nodiscard]] static std::size_t default_workers() {
+        const unsigned cores = std::thread::hardware_concurrency();
+        return std::max<std::size_t>(2, cores > 1 ? cores - 1 : 1);
+    }
+
+    explicit Executor(std::size_t workers = default_workers())
+        : origin_(Clock::now()) {
+        for (std::size_t i = 0; i < LANE_COUNT; ++i) {
+            const std::string prefix =
+                std::string("executor_") + lane_name(static_cast<Lane>(i));
+            auto &registry = metrics::registry();
+            lane_metrics_[i] = {&registry.gauge(prefix + "_depth"),
+                                &registry.histogram(prefix + "_wait"),
+                                &registry.histogram(prefix + "_run")};
+        }
+        workers = std::max<std::size_t>(workers, 1);
+        queues_.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i) {
+            queues_.push_back(std::make_unique<WorkerQueues>());
+        }
+        threads_.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i) {
+            threads_.emplace_back(
+                [this, i](std::stop_token stop) { worker_loop(i, stop); });
+        }
+        timer_thread_ =
+            std::jthread([this](std::stop_token stop) { timer_loop(stop); });
+    }
+
+    ~Executor() { shutdown(); }
+
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    // `fn`: void() ou void(std::stop_token). `name` precisa ser estável
+    // (literal ou trace::intern).
+    template <typename F>
+    Task submit(Lane lane, const char *name, F &&fn) {
+        auto state =
+            make_state(lane, name, detail::make_once(std::forward<F>(fn)));
+        enqueue(state);
+        return Task(std::move(state));
+    }
+
+    template <typename F>
+    Task schedule_after(std::chrono::milliseconds delay, Lane lane,
+                        const char *name, F &&fn) {
+        auto state =
+            make_state(lane, name, detail::make_once(std::forward<F>(fn)));
+        add_timer(delay, state);
+        return Task(std::move(state));
+    }
+
+    // `fn(stop_token)` devolve o próximo intervalo; nullopt encerra. As
+    // execuções nunca se sobrepõem (o próximo agendamento é feito no fim).
+    Task schedule_periodic(std::chrono::milliseconds first_delay, Lane lane,
+                           const char *name, detail::TaskBody fn) {
+        auto state = make_state(lane, name, std::move(fn));
+        add_timer(first_delay, state);
+        return Task(std::move(state));
+    }
+
+    // Handoff para a thread da UI. false sem dispatcher (antes da janela
+    // existir ou depois do encerramento).
+    bool post_to_ui(std::function<void()> fn) {
+        std::lock_guard<std::mutex> lock(ui_mu_);
+        if (!ui_dispatcher_) {
+            return false;
+        }
+        ui_dispatcher_(std::move(fn));
+        return true;
+    }
+
+    void set_ui_dispatcher(UiDispatcher dispatcher) {
+        std::lock_guard<std::mutex> lock(ui_mu_);
+        ui_dispatcher_ = std::move(dispatcher);
+    }
+
+    [[nodiscard]] std::size_t worker_count() const { return threads_.size(); }
+
+    [[nodiscard]] std::int64_t queue_depth(Lane lane) const {
+        return lane_metrics_[static_cast<std::size_t>(lane)].depth->value();
+    }
+
+    // Cancela o que está na fila e nos timers, espera as tarefas em
+    // execução e encerra as threads. Idempotente.
+    void shutdown() {
+        if (stopped_.exchange(true)) {
+            return;
+        }
+        set_ui_dispatcher(nullptr);
+        timer_thread_.request_stop();
+        for (auto &thread : threads_) {
+            thread.request_stop();
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mu_);
+        }
+        sleep_cv_.notify_all();
+        if (timer_thread_.joinable()) {
+            timer_thread_.join();
+        }
+        for (auto &thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        std::lock_guard<std::mutex> lock(timer_mu_);
+        for (auto &slot : wheel_) {
+            for (auto &entry : slot) {
+                entry.task->cancel();
+            }
+            slot.clear();
+        }
+        for (auto &queues : queues_) {
+            std::lock_guard<std::mutex> queue_lock(queues->mu);
+            for (auto &lane : queues->lanes) {
+                for (auto &task : lane) {
+                    task->cancel();
+                }
+                lane.clear();
+            }
+        }
+    }
+
+  private:
+    using TaskPtr = std::shared_ptr<detail::TaskState>;
+
+    struct WorkerQueues {
+        std::mutex mu;
+        std::array<std::deque<TaskPtr>, LANE_COUNT> lanes;
+    };
+
+    struct LaneMetrics {
+        metrics::Gauge *depth = nullptr;
+        metrics::LatencyHistogram *wait = nullptr;
+        metrics::LatencyHistogram *run = nullptr;
+    };
+
+    struct TimerEntry {
+        std::uint64_t due_tick = 0;
+        TaskPtr task;
+    };
+
+    static TaskPtr make_state(Lane lane, const char *name,
+                              detail::TaskBody body) {
+        auto state = std::make_shared<detail::TaskState>();
+        state->lane = lane;
+        state->name = name;
+        state->body = std::move(body);
+        return state;
+    }
+
+    // Worker atual (submissões de dentro do pool vão para a própria deque)
+    struct WorkerSlot {
+        const Executor *owner = nullptr;
+        std::size_t index = 0;
+    };
+    static WorkerSlot &current_worker() {
+        thread_local WorkerSlot slot;
+        return slot;
+    }
+
+    void enqueue(const TaskPtr &task) {
+        if (stopped_.load()) {
+            task->cancel();
+            return;
+        }
+        task->enqueued = Clock::now();
+        const auto &worker = current_worker();
+        const std::size_t target =
+            worker.owner == this
+                ? worker.index
+                : next_queue_.fetch_add(1, std::memory_order_relaxed) %
+                      queues_.size();
+        const auto lane = static_cast<std::size_t>(task->lane);
+        {
+            // Reteste sob a trava: shutdown() marca stopped_ antes de
+            // esvaziar as filas com esta mesma trava, então ou a tarefa
+            // entra antes e é cancelada lá, ou é cancelada aqui
+            std::lock_guard<std::mutex> lock(queues_[target]->mu);
+            if (stopped_.load()) {
+                task->cancel();
+                return;
+            }
+            queues_[target]->lanes[lane].push_back(task);
+        }
+        lane_metrics_[lane].depth->add(1);
+        queued_.fetch_add(1, std::memory_order_release);
+        {
+            // Fecha a janela entre o teste do predicado e o wait do worker
+            std::lock_guard<std::mutex> lock(sleep_mu_);
+        }
+        sleep_cv_.notify_one();
+    }
+
+    TaskPtr take(std::size_t self) {
+        for (std::size_t lane = 0; lane < LANE_COUNT; ++lane) {
+            {
+                WorkerQueues &own = *queues_[self];
+                std::lock_guard<std::mutex> lock(own.mu);
+                if (!own.lanes[lane].empty()) {
+                    TaskPtr task = std::move(own.lanes[lane].back());
+                    own.lanes[lane].pop_back();
+                    return taken(lane, std::move(task));
+                }
+            }
+            for (std::size_t k = 1; k < queues_.size(); ++k) {
+                WorkerQueues &victim = *queues_[(self + k) % queues_.size()];
+                std::lock_guard<std::mutex> lock(victim.mu);
+                if (!victim.lanes[lane].empty()) {
+                    TaskPtr task = std::move(victim.lanes[lane].front());
+                    victim.lanes[lane].pop_front();
+                    return taken(lane, std::move(task));
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    TaskPtr taken(std::size_t lane, TaskPtr task) {
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        lane_metrics_[lane].depth->add(-1);
+        return task;
+    }
+
+    void worker_loop(std::size_t index, std::stop_token stop) {
+        block_thread_signals(); // o pool nasce antes do SignalWatcher
+        current_worker() = {this, index};
+        trace::set_thread_name("worker-" + std::to_string(index));
+        while (!stop.stop_requested()) {
+            if (TaskPtr task = take(index)) {
+                run(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mu_);
+            sleep_cv_.wait(lock, stop, [this] {
+                return queued_.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+
+    void run(const TaskPtr &task) {
+        if (!task->try_begin()) {
+            task->body = nullptr;
+            return;
+        }
+        const auto lane = static_cast<std::size_t>(task->lane);
+        const auto start = Clock::now();
+        lane_metrics_[lane].wait->record(start - task->enqueued);
+        std::optional<std::chrono::milliseconds> next;
+        {
+            APP_TRACE_SPAN("executor", task->name);
+            try {
+                next = task->body(task->stop.get_token());
+            } catch (const std::exception &e) {
+                APP_LOG_ERROR("EXEC", "Tarefa ", task->name,
+                              " falhou: ", e.what());
+            } catch (...) {
+                APP_LOG_ERROR("EXEC", "Tarefa ", task->name, " falhou");
+            }
+        }
+        lane_metrics_[lane].run->record(Clock::now() - start);
+        const bool again = next.has_value() && !stopped_.load();
+        if (!again) {
+            task->body = nullptr; // solta as capturas (ciclos via Task)
+        }
+        task->end(again);
+        if (again) {
+            add_timer(*next, task);
+        }
+    }
+
+    // =========================================================================
+    // Timer wheel
+    // =========================================================================
+
+    [[nodiscard]] std::uint64_t tick_at(Clock::time_point at) const {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(at -
+                                                                  origin_)
+                .count() /
+            TIMER_TICK.count());
+    }
+
+    void add_timer(std::chrono::milliseconds delay, const TaskPtr &task) {
+        if (delay <= std::chrono::milliseconds::zero()) {
+            enqueue(task);
+            return;
+        }
+        // Arredonda para cima: nunca dispara antes do atraso pedido
+        const std::uint64_t due = tick_at(Clock::now() + delay) + 1;
+        bool earlier = false;
+        {
+            std::lock_guard<std::mutex> lock(timer_mu_);
+            if (stopped_.load()) {
+                task->cancel();
+                return;
+            }
+            wheel_[due % WHEEL_SLOTS].push_back({due, task});
+            ++timer_count_;
+            earlier = due < next_due_;
+            next_due_ = std::min(next_due_, due);
+        }
+        if (earlier) {
+            timer_cv_.notify_one();
+        }
+    }
+
+    void timer_loop(std::stop_token stop) {
+        block_thread_signals();
+        trace::set_thread_name("executor-timers");
+        std::vector<TaskPtr> due;
+        std::unique_lock<std::mutex> lock(timer_mu_);
+        while (!stop.stop_requested()) {
+            if (timer_count_ == 0) {
+                timer_cv_.wait(lock, stop, [this] { return timer_count_ > 0; });
+                continue;
+            }
+            const auto wake = origin_ + TIMER_TICK * next_due_;
+            if (timer_cv_.wait_until(lock, stop, wake, [this, wake] {
+                    return origin_ + TIMER_TICK * next_due_ < wake;
+                })) {
+                continue; // timer mais cedo chegou
+            }
+            collect_due(tick_at(Clock::now()), due);
+            lock.unlock();
+            for (auto &task : due) {
+                enqueue(task);
+            }
+            due.clear();
+            lock.lock();
+        }
+    }
+
+    // timer_mu_ travado. Percorre os slots entre o último tick processado
+    // e `now_tick` (a volta inteira se o atraso passou de WHEEL_SLOTS).
+    void collect_due(std::uint64_t now_tick, std::vector<TaskPtr> &out) {
+        const std::uint64_t span =
+            std::min<std::uint64_t>(now_tick - processed_tick_ + 1,
+                                    WHEEL_SLOTS);
+        for (std::uint64_t i = 0; i < span; ++i) {
+            auto &slot = wheel_[(now_tick - i) % WHEEL_SLOTS];
+            std::erase_if(slot, [&](TimerEntry &entry) {
+                if (entry.due_tick > now_tick) {
+                    return false;
+                }
+                out.push_back(std::move(entry.task));
+                return true;
+            });
+        }
+        processed_tick_ = now_tick;
+        timer_count_ -= out.size();
+        next_due_ = UINT64_MAX;
+        for (const auto &slot : wheel_) {
+            for (const auto &entry : slot) {
+                next_due_ = std::min(next_due_, entry.due_tick);
+            }
+        }
+    }
+
+    Clock::time_point origin_;
+    std::array<LaneMetrics, LANE_COUNT> lane_metrics_{};
+    std::vector<std::unique_ptr<WorkerQueues>> queues_;
+    std::atomic<std::size_t> next_queue_{0};
+    std::atomic<std::size_t> queued_{0};
+    std::mutex sleep_mu_;
+    std::condition_variable_any sleep_cv_;
+    std::atomic<bool> stopped_{false};
+
+    std::mutex timer_mu_;
+    std::condition_variable_any timer_cv_;
+    std::array<std::vector<TimerEntry>, WHEEL_SLOTS> wheel_;
+    std::size_t timer_count_ = 0;
+    std::uint64_t next_due_ = UINT64_MAX;
+    std::uint64_t processed_tick_ = 0;
+
+    std::mutex ui_mu_;
+    UiDispatcher ui_dispatcher_;
+
+    std::vector<std::jthread> threads_;
+    std::jthread timer_thread_;
+};
+
+// Executor compartilhado pela aplicação
+inline Executor &executor() {
+    static Executor instance;
+    return instance;
+}
+
+} // namespace app
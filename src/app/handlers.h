@@ -3,8 +3,20 @@
 // App Handlers - Handlers específicos desta aplicação
 // =============================================================================
 
+#include "app/binary_channel.h"
 #include "app/bindings_with_meta.h"
+#include "app/blob_store.h"
 #include "app/config.h"
+#include "app/job_manager.h"
+#include "app/log.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace app {
 
@@ -19,10 +31,10 @@ class HandlerRegistry {
         virtual void log(const std::string &msg) = 0;
     };
 
-    // Logger padrão que usa std::cout
+    // Logger padrão: log assíncrono (app/log.h), nível Info
     struct DefaultLogger : Logger {
         void log(const std::string &msg) override {
-            std::cout << msg << std::endl;
+            APP_LOG_INFO("APP", msg);
         }
     };
 
@@ -34,7 +46,7 @@ class HandlerRegistry {
     ping(std::optional<std::string> message) const {
         const std::string ping_message = message.value_or("");
         if (logger_)
-            logger_->log("[APP] Ping from UI: " + ping_message);
+            logger_->log("Ping from UI: " + ping_message);
         return {{"message", "pong"}, {"echo", ping_message}};
     }
 
@@ -42,18 +54,95 @@ class HandlerRegistry {
         return {{"version", config::VERSION}};
     }
 
-    [[nodiscard]] nlohmann::json open_file(const std::string &path) const {
+    // Job "openFile": lê o arquivo em blocos no pool, com progresso e
+    // cancelamento, e guarda o conteúdo no BlobStore em nome da janela
+    // que pediu. O JS recebe o handle e busca os bytes com getBlob;
+    // cancelado, nada fica guardado.
+    [[nodiscard]] nlohmann::json read_file_job(const nlohmann::json &params,
+                                               JobContext &job,
+                                               BlobStore &blobs) const {
+        const std::string path = params.value("path", std::string());
         if (path.empty()) {
             throw bindings::BindingError("Path not provided",
                                          bindings::ErrorCode::MissingArg);
         }
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Could not open " + path);
+        }
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path, ec);
         if (logger_)
-            logger_->log("[APP] Opening file: " + path);
-        // TODO: Implement file opening logic
-        return {{"path", path}, {"status", "opened"}};
+            logger_->log("Reading file: " + path);
+
+        std::string content;
+        if (!ec) {
+            content.reserve(static_cast<std::size_t>(size));
+        }
+        std::vector<char> buffer(FILE_JOB_CHUNK);
+        while (in && !job.cancelled()) {
+            in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            content.append(buffer.data(),
+                           static_cast<std::size_t>(in.gcount()));
+            job.progress(ec || size == 0
+                             ? -1.0
+                             : static_cast<double>(content.size()) /
+                                   static_cast<double>(size));
+        }
+        if (job.cancelled()) {
+            return nullptr; // o JobManager descarta o resultado
+        }
+        if (in.bad()) {
+            throw std::runtime_error("Could not read " + path);
+        }
+        const auto blob = blobs.put(job.window_id(), std::move(content));
+        return {{"path", path},
+                {"handle", blob.handle},
+                {"type", blob.mime},
+                {"size", blob.data->size()}};
+    }
+
+    // Listagem em stream: cada entrada sai do directory_iterator quando o
+    // JS puxa o bloco, um diretório enorme nunca fica inteiro na memória
+    [[nodiscard]] bindings::Stream
+    list_directory(const std::string &path) const {
+        namespace fs = std::filesystem;
+        if (path.empty()) {
+            throw bindings::BindingError("Path not provided",
+                                         bindings::ErrorCode::MissingArg);
+        }
+        std::error_code ec;
+        auto it = std::make_shared<fs::directory_iterator>(
+            path, fs::directory_options::skip_permission_denied, ec);
+        if (ec) {
+            throw bindings::BindingError("Could not list " + path + ": " +
+                                             ec.message(),
+                                         bindings::ErrorCode::InvalidArgs);
+        }
+        return bindings::Stream([it]() -> std::optional<nlohmann::json> {
+            const fs::directory_iterator end;
+            if (*it == end) {
+                return std::nullopt;
+            }
+            const fs::directory_entry &entry = **it;
+            std::error_code entry_ec;
+            nlohmann::json item = {
+                {"name", entry.path().filename().string()},
+                {"directory", entry.is_directory(entry_ec)}};
+            if (entry.is_regular_file(entry_ec)) {
+                item["size"] = entry.file_size(entry_ec);
+            }
+            it->increment(entry_ec);
+            if (entry_ec) {
+                *it = end; // erro no meio: encerra a listagem
+            }
+            return item;
+        });
     }
 
   private:
+    static constexpr std::size_t FILE_JOB_CHUNK = 64 * 1024;
+
     std::unique_ptr<Logger> logger_;
 };
 
@@ -68,8 +157,22 @@ inline void setup(webview::webview &w, const HandlerRegistry &handlers) {
     });
     APP_BIND_TYPED(w, "getVersion",
                    [&handlers]() { return handlers.get_version(); });
-    APP_BIND_TYPED(w, "openFile", [&handlers](const std::string &path) {
-        return handlers.open_file(path);
+    APP_BIND_TYPED(w, "listDirectory", [&handlers](const std::string &path) {
+        return handlers.list_directory(path);
+    });
+
+    // Canal binário: devolve os bytes recebidos (teste de ida e volta e
+    // medida de vazão do transporte)
+    bindings::bind_binary(w, "echoBinary", [](std::span<const std::byte> in) {
+        return std::vector<std::byte>(in.begin(), in.end());
+    });
+
+    // Blocos seguintes dos bindings que devolvem bindings::Stream
+    APP_BIND_TYPED(w, "pullNativeStream", [](const std::string &stream_id) {
+        return bindings::stream_registry().pull(stream_id);
+    });
+    APP_BIND_TYPED(w, "closeNativeStream", [](const std::string &stream_id) {
+        return bindings::stream_registry().close(stream_id);
     });
 
     // =============================================================================
@@ -126,4 +229,17 @@ inline void setup(webview::webview &w, const HandlerRegistry &handlers) {
     // });
 }
 
+// =============================================================================
+// register_jobs - Tipos de job disponíveis para startJob
+// =============================================================================
+
+inline void register_jobs(JobManager &jobs, const HandlerRegistry &handlers,
+                          BlobStore &blobs) {
+    jobs.register_kind("openFile", [&handlers, &blobs](
+                                       const nlohmann::json &params,
+                                       JobContext &job) {
+        return handlers.read_file_job(params, job, blobs);
+    });
+}
+
 } // namespace app
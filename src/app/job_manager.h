@@ -0,0 +1,367 @@
+#pragma once
+// =============================================================================
+// JobManager - Operações nativas longas com progresso e cancelamento
+// =============================================================================
+// Lógica pura (sem GTK). O JS inicia um job por tipo (startJob), recebe o
+// id na hora e acompanha pelo evento `jobs.update` da janela dona; o
+// AbortSignal do lado JS vira cancelJob, que pede a parada pelo
+// std::stop_token do job.
+//
+// Os jobs rodam na lane Background do executor. O progresso é só gravado
+// (último valor vence) e um flush por frame (FRAME_INTERVAL) manda um
+// único evento por janela com todos os jobs alterados desde o anterior.
+// Fechar a janela dona cancela os jobs dela (cancel_window).
+//
+// Estados: queued -> running -> completed | failed | cancelled. Jobs
+// terminados saem da lista depois que o estado final foi enviado.
+// =============================================================================
+
+#include "app/executor.h"
+#include "app/tracing.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+class JobContext;
+class JobManager;
+
+namespace detail {
+
+enum class JobState { Queued, Running, Completed, Failed, Cancelled };
+
+struct Job {
+    std::string id;
+    std::string window_id;
+    std::string kind;
+    nlohmann::json params;
+    std::function<nlohmann::json(const nlohmann::json &, JobContext &)> fn;
+    JobState state = JobState::Queued;
+    double progress = -1;
+    std::string message;
+    nlohmann::json result;
+    std::string error;
+    bool dirty = false;
+    Task task;
+};
+
+} // namespace detail
+
+// Visão do job para o corpo (thread do pool)
+class JobContext {
+  public:
+    [[nodiscard]] std::stop_token stop_token() const { return stop_; }
+    [[nodiscard]] bool cancelled() const { return stop_.stop_requested(); }
+    // Janela que iniciou o job (dona dos recursos que ele criar)
+    [[nodiscard]] const std::string &window_id() const {
+        return job_->window_id;
+    }
+
+    // `fraction` em [0, 1] (< 0 = indeterminado). Barato: só guarda o
+    // valor, enviado no próximo frame.
+    void progress(double fraction, std::string message = {});
+
+  private:
+    friend class JobManager;
+
+    JobContext(JobManager &manager, std::shared_ptr<detail::Job> job,
+               std::stop_token stop)
+        : manager_(manager), job_(std::move(job)), stop_(std::move(stop)) {}
+
+    JobManager &manager_;
+    std::shared_ptr<detail::Job> job_;
+    std::stop_token stop_;
+};
+
+class JobManager {
+  public:
+    using json = nlohmann::json;
+    // Corpo de um tipo de job: recebe os parâmetros do JS, devolve o
+    // resultado. Exceção = failed.
+    using JobFn = std::function<json(const json &params, JobContext &)>;
+    // Entrega um evento já serializado à janela (thread do pool)
+    using Sink = std::function<void(const std::string &window_id,
+                                    std::string event)>;
+
+    static constexpr std::chrono::milliseconds FRAME_INTERVAL{16};
+
+    explicit JobManager(Executor &executor = app::executor())
+        : executor_(executor) {}
+
+    ~JobManager() {
+        std::vector<Task> tasks;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            closing_ = true; // sem novos flushes
+            for (const auto &entry : jobs_) {
+                cancel_locked(*entry.second);
+                tasks.push_back(entry.second->task);
+            }
+            tasks.push_back(flush_task_);
+        }
+        for (auto &task : tasks) {
+            task.cancel();
+            task.wait();
+        }
+    }
+
+    JobManager(const JobManager &) = delete;
+    JobManager &operator=(const JobManager &) = delete;
+
+    void set_sink(Sink sink) {
+        std::lock_guard<std::mutex> lock(mu_);
+        sink_ = std::move(sink);
+    }
+
+    void register_kind(std::string kind, JobFn fn) {
+        std::lock_guard<std::mutex> lock(mu_);
+        kinds_[std::move(kind)] = std::move(fn);
+    }
+
+    // Id do job; nullopt se o tipo não existe
+    std::optional<std::string> start(const std::string &window_id,
+                                     const std::string &kind, json params) {
+        auto job = std::make_shared<detail::Job>();
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            const auto it = kinds_.find(kind);
+            if (it == kinds_.end()) {
+                return std::nullopt;
+            }
+            job->id = "job" + std::to_string(++next_id_);
+            job->window_id = window_id;
+            job->kind = kind;
+            job->params = std::move(params);
+            job->fn = it->second;
+            jobs_[job->id] = job;
+            mark_dirty(*job);
+            // Antes de liberar o lock: cancel() precisa ver a Task
+            job->task = executor_.submit(
+                Lane::Background, trace::intern("job." + kind),
+                [this, job](std::stop_token stop) { run(job, stop); });
+        }
+        return job->id;
+    }
+
+    // false se o job não existe ou já terminou
+    bool cancel(const std::string &job_id) {
+        std::lock_guard<std::mutex> lock(mu_);
+        const auto it = jobs_.find(job_id);
+        return it != jobs_.end() && cancel_locked(*it->second);
+    }
+
+    // A janela fechou: cancela os jobs dela
+    std::size_t cancel_window(const std::string &window_id) {
+        std::lock_guard<std::mutex> lock(mu_);
+        std::size_t count = 0;
+        for (const auto &entry : jobs_) {
+            if (entry.second->window_id == window_id &&
+                cancel_locked(*entry.second)) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    void cancel_all() {
+        std::lock_guard<std::mutex> lock(mu_);
+        for (const auto &entry : jobs_) {
+            cancel_locked(*entry.second);
+        }
+    }
+
+    // Jobs na fila ou rodando
+    [[nodiscard]] std::size_t active() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        std::size_t count = 0;
+        for (const auto &entry : jobs_) {
+            if (!is_terminal(entry.second->state)) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    [[nodiscard]] json list() const {
+        json out = json::array();
+        std::lock_guard<std::mutex> lock(mu_);
+        for (const auto &entry : jobs_) {
+            json item = describe(*entry.second);
+            item["windowId"] = entry.second->window_id;
+            out.push_back(std::move(item));
+        }
+        return out;
+    }
+
+    // Envia os jobs alterados: um evento por janela. Roda no timer do
+    // frame; público para o encerramento e os testes.
+    void flush() {
+        std::map<std::string, json> batches;
+        Sink sink;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            flush_scheduled_ = false;
+            for (auto it = jobs_.begin(); it != jobs_.end();) {
+                detail::Job &job = *it->second;
+                if (job.dirty) {
+                    job.dirty = false;
+                    auto &batch = batches[job.window_id];
+                    if (batch.is_null()) {
+                        batch = json::array();
+                    }
+                    batch.push_back(describe(job));
+                }
+                it = is_terminal(job.state) ? jobs_.erase(it) : std::next(it);
+            }
+            sink = sink_;
+        }
+        if (!sink) {
+            return;
+        }
+        for (auto &[window_id, jobs] : batches) {
+            sink(window_id,
+                 json{{"type", "jobs.update"}, {"jobs", std::move(jobs)}}
+                     .dump());
+        }
+    }
+
+  private:
+    friend class JobContext;
+
+    using State = detail::JobState;
+
+    static bool is_terminal(State state) {
+        return state != State::Queued && state != State::Running;
+    }
+
+    static const char *state_name(State state) {
+        switch (state) {
+        case State::Queued:
+            return "queued";
+        case State::Running:
+            return "running";
+        case State::Completed:
+            return "completed";
+        case State::Failed:
+            return "failed";
+        case State::Cancelled:
+            return "cancelled";
+        }
+        return "unknown";
+    }
+
+    static json describe(const detail::Job &job);
+
+    // mu_ travado
+    bool cancel_locked(detail::Job &job) {
+        if (is_terminal(job.state)) {
+            return false;
+        }
+        job.task.cancel();
+        if (job.state == State::Queued) {
+            // Nunca vai rodar: o estado final sai daqui
+            job.state = State::Cancelled;
+            mark_dirty(job);
+        }
+        return true;
+    }
+
+    // mu_ travado: marca o job e agenda o flush do frame
+    void mark_dirty(detail::Job &job) {
+        job.dirty = true;
+        if (!flush_scheduled_ && !closing_) {
+            flush_scheduled_ = true;
+            flush_task_ = executor_.schedule_after(
+                FRAME_INTERVAL, Lane::High, "jobs.flush", [this] { flush(); });
+        }
+    }
+
+    void run(const std::shared_ptr<detail::Job> &job,
+             std::stop_token stop);
+
+    Executor &executor_;
+    mutable std::mutex mu_;
+    std::unordered_map<std::string, JobFn> kinds_;
+    std::map<std::string, std::shared_ptr<detail::Job>> jobs_;
+    std::uint64_t next_id_ = 0;
+    Sink sink_;
+    bool flush_scheduled_ = false;
+    bool closing_ = false;
+    Task flush_task_;
+};
+
+inline void JobContext::progress(double fraction, std::string message) {
+    std::lock_guard<std::mutex> lock(manager_.mu_);
+    job_->progress = fraction;
+    job_->message = std::move(message);
+    manager_.mark_dirty(*job_);
+}
+
+inline nlohmann::json JobManager::describe(const detail::Job &job) {
+    json item = {{"id", job.id},
+                 {"kind", job.kind},
+                 {"state", state_name(job.state)},
+                 {"progress", job.progress},
+                 {"message", job.message}};
+    if (job.state == State::Completed) {
+        item["result"] = job.result;
+    } else if (job.state == State::Failed) {
+        item["error"] = job.error;
+    }
+    return item;
+}
+
+inline void JobManager::run(const std::shared_ptr<detail::Job> &job,
+                            std::stop_token stop) {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (job->state != State::Queued) {
+            return; // cancelado entre o submit e o início
+        }
+        job->state = State::Running;
+        mark_dirty(*job);
+    }
+
+    JobContext context(*this, job, stop);
+    json result;
+    std::string error;
+    bool failed = false;
+    try {
+        result = job->fn(job->params, context);
+    } catch (const std::exception &e) {
+        failed = true;
+        error = e.what();
+    } catch (...) {
+        failed = true;
+        error = "Unknown error";
+    }
+
+    std::lock_guard<std::mutex> lock(mu_);
+    if (stop.stop_requested()) {
+        job->state = State::Cancelled;
+    } else if (failed) {
+        job->state = State::Failed;
+        job->error = std::move(error);
+    } else {
+        job->state = State::Completed;
+        job->progress = 1;
+        job->result = std::move(result);
+    }
+    job->fn = nullptr;
+    mark_dirty(*job);
+}
+
+} // namespace app
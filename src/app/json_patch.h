@@ -0,0 +1,603 @@
+#pragma once
+// =============================================================================
+// JSON Patch (RFC 6902) - diff e aplicação sobre nlohmann::json
+// =============================================================================
+// Lógica pura. O diff usa hashes estruturais: StructuralHash percorre o
+// documento uma vez e guarda, em pré-ordem, o hash e o tamanho de cada
+// subárvore. Comparar duas subárvores vira comparar dois inteiros (O(1)), e
+// o diff só desce onde os hashes diferem; json::diff compara com == em cada
+// nível (O(n * profundidade)) e não alinha arrays. O hash de um documento
+// que não muda pode ser guardado e reaproveitado (ver StateStore).
+//
+// Hashes iguais são tratados como subárvores iguais: uma colisão de 64 bits
+// omitiria uma mudança, com probabilidade ~2^-64 por comparação.
+//
+// Arrays: prefixo e sufixo iguais são pulados pelos hashes, o miolo é
+// comparado por índice e o excedente vira add/remove. Inserir, remover ou
+// mover um item (ex: aba arrastada no dock) gera uma operação, não um
+// replace por item deslocado.
+//
+// apply_json_patch aplica no lugar (sem copiar o documento, ao contrário de
+// json::patch) e é atômico: se uma operação falha, as anteriores são
+// desfeitas e JsonPatchError sobe com o documento intacto.
+// =============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+class JsonPatchError : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+// =============================================================================
+// StructuralHash - hash de cada subárvore, em pré-ordem
+// =============================================================================
+// Filhos de objetos na ordem das chaves (a de nlohmann::json), de arrays na
+// ordem dos itens. O filho seguinte de um nó fica a `size` posições do
+// anterior. Válido enquanto o documento não muda.
+
+class StructuralHash {
+  public:
+    using json = nlohmann::json;
+
+    explicit StructuralHash(const json &doc) { build(doc); }
+
+    [[nodiscard]] std::uint64_t root() const { return nodes_[0].hash; }
+    [[nodiscard]] std::uint64_t hash(std::size_t node) const {
+        return nodes_[node].hash;
+    }
+    // Índice do primeiro nó depois da subárvore de `node`
+    [[nodiscard]] std::size_t skip(std::size_t node) const {
+        return node + nodes_[node].size;
+    }
+    [[nodiscard]] std::size_t nodes() const { return nodes_.size(); }
+
+  private:
+    struct Node {
+        std::uint64_t hash;
+        std::uint32_t size; // nós da subárvore, incluindo ele
+    };
+
+    // Finalizador do splitmix64 sobre acumulado + valor
+    static std::uint64_t mix(std::uint64_t h, std::uint64_t v) {
+        h ^= v + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBULL;
+        return h ^ (h >> 31);
+    }
+
+    // 8 bytes por passo (as chaves e valores de layouts são curtos)
+    static std::uint64_t hash_string(std::string_view s) {
+        std::uint64_t h = s.size() * 0x9E3779B97F4A7C15ULL;
+        const char *p = s.data();
+        std::size_t n = s.size();
+        for (; n >= 8; p += 8, n -= 8) {
+            std::uint64_t v = 0;
+            std::memcpy(&v, p, 8);
+            h = (h ^ v) * 0xBF58476D1CE4E5B9ULL;
+            h ^= h >> 29;
+        }
+        if (n > 0) {
+            std::uint64_t v = 0;
+            std::memcpy(&v, p, n);
+            h = (h ^ v) * 0x94D049BB133111EBULL;
+            h ^= h >> 32;
+        }
+        return h;
+    }
+
+    // 1, 1u e 1.0 são iguais para nlohmann::json: o hash também
+    static std::uint64_t hash_number(const json &value) {
+        if (const auto *u = value.get_ptr<const json::number_unsigned_t *>()) {
+            if (*u <= static_cast<std::uint64_t>(
+                          std::numeric_limits<std::int64_t>::max())) {
+                return *u;
+            }
+            return mix(*u, 1);
+        }
+        if (const auto *i = value.get_ptr<const json::number_integer_t *>()) {
+            return static_cast<std::uint64_t>(*i);
+        }
+        const double d = *value.get_ptr<const json::number_float_t *>();
+        if (d >= -9.2e18 && d <= 9.2e18 &&
+            static_cast<double>(static_cast<std::int64_t>(d)) == d) {
+            return static_cast<std::uint64_t>(static_cast<std::int64_t>(d));
+        }
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &d, sizeof bits);
+        return mix(bits, 2);
+    }
+
+    // Percorre os containers do nlohmann direto (sem iter_impl)
+    void build(const json &value) {
+        const std::size_t index = nodes_.size();
+        nodes_.push_back({0, 1});
+        std::uint64_t h = 0;
+        switch (value.type()) {
+        case json::value_t::object:
+            h = 1;
+            for (const auto &[key, child] :
+                 *value.get_ptr<const json::object_t *>()) {
+                const std::size_t at = nodes_.size();
+                build(child);
+                h = mix(h ^ hash_string(key), nodes_[at].hash);
+            }
+            break;
+        case json::value_t::array:
+            h = 2;
+            for (const auto &child : *value.get_ptr<const json::array_t *>()) {
+                const std::size_t at = nodes_.size();
+                build(child);
+                h = mix(h, nodes_[at].hash);
+            }
+            break;
+        case json::value_t::string:
+            h = mix(3, hash_string(*value.get_ptr<const json::string_t *>()));
+            break;
+        case json::value_t::boolean:
+            h = mix(4, *value.get_ptr<const json::boolean_t *>() ? 1 : 0);
+            break;
+        case json::value_t::number_integer:
+        case json::value_t::number_unsigned:
+        case json::value_t::number_float:
+            h = mix(5, hash_number(value));
+            break;
+        default: // null, binary, discarded
+            h = mix(6, static_cast<std::uint64_t>(value.type()));
+            break;
+        }
+        const std::size_t size = nodes_.size() - index;
+        nodes_[index].hash = mix(h, size);
+        nodes_[index].size = static_cast<std::uint32_t>(size);
+    }
+
+    std::vector<Node> nodes_;
+};
+
+namespace detail {
+
+inline void append_pointer_token(std::string &path, std::string_view token) {
+    path += '/';
+    for (const char c : token) {
+        if (c == '~') {
+            path += "~0";
+        } else if (c == '/') {
+            path += "~1";
+        } else {
+            path += c;
+        }
+    }
+}
+
+class JsonDiffer {
+  public:
+    using json = nlohmann::json;
+
+    JsonDiffer(const StructuralHash &ha, const StructuralHash &hb)
+        : ha_(ha), hb_(hb) {}
+
+    json run(const json &a, const json &b) {
+        diff(a, 0, b, 0);
+        return std::move(ops_);
+    }
+
+  private:
+    void emit(const char *op, const json *value) {
+        json entry = {{"op", op}, {"path", path_}};
+        if (value) {
+            entry["value"] = *value;
+        }
+        ops_.push_back(std::move(entry));
+    }
+
+    void diff(const json &a, std::size_t ia, const json &b,
+              std::size_t ib) {
+        if (ha_.hash(ia) == hb_.hash(ib)) {
+            return;
+        }
+        if (a.is_object() && b.is_object()) {
+            diff_object(a, ia, b, ib);
+        } else if (a.is_array() && b.is_array()) {
+            diff_array(a, ia, b, ib);
+        } else {
+            emit("replace", &b);
+        }
+    }
+
+    void diff_object(const json &a, std::size_t ia, const json &b,
+                     std::size_t ib) {
+        const std::size_t base = path_.size();
+        auto ita = a.begin();
+        auto itb = b.begin();
+        std::size_t na = ia + 1;
+        std::size_t nb = ib + 1;
+        while (ita != a.end() || itb != b.end()) {
+            const int order = ita == a.end()   ? 1
+                              : itb == b.end() ? -1
+                                               : ita.key().compare(itb.key());
+            if (order < 0) {
+                append_pointer_token(path_, ita.key());
+                emit("remove", nullptr);
+                na = ha_.skip(na);
+                ++ita;
+            } else if (order > 0) {
+                append_pointer_token(path_, itb.key());
+                emit("add", &itb.value());
+                nb = hb_.skip(nb);
+                ++itb;
+            } else {
+                append_pointer_token(path_, ita.key());
+                diff(ita.value(), na, itb.value(), nb);
+                na = ha_.skip(na);
+                nb = hb_.skip(nb);
+                ++ita;
+                ++itb;
+            }
+            path_.resize(base);
+        }
+    }
+
+    void diff_array(const json &a, std::size_t ia, const json &b,
+                    std::size_t ib) {
+        std::vector<std::size_t> ca;
+        std::vector<std::size_t> cb;
+        ca.reserve(a.size());
+        cb.reserve(b.size());
+        for (std::size_t i = 0, n = ia + 1; i < a.size(); ++i) {
+            ca.push_back(n);
+            n = ha_.skip(n);
+        }
+        for (std::size_t i = 0, n = ib + 1; i < b.size(); ++i) {
+            cb.push_back(n);
+            n = hb_.skip(n);
+        }
+
+        const std::size_t common = std::min(a.size(), b.size());
+        std::size_t prefix = 0;
+        while (prefix < common &&
+               ha_.hash(ca[prefix]) == hb_.hash(cb[prefix])) {
+            ++prefix;
+        }
+        std::size_t suffix = 0;
+        while (suffix < common - prefix &&
+               ha_.hash(ca[a.size() - 1 - suffix]) ==
+                   hb_.hash(cb[b.size() - 1 - suffix])) {
+            ++suffix;
+        }
+        const std::size_t mid_a = a.size() - prefix - suffix;
+        const std::size_t mid_b = b.size() - prefix - suffix;
+
+        const std::size_t base = path_.size();
+        if (mid_a == mid_b && mid_a > 1 && diff_moved_item(ca, cb, prefix,
+                                                          prefix + mid_a - 1)) {
+            return;
+        }
+        for (std::size_t k = 0; k < std::min(mid_a, mid_b); ++k) {
+            const std::size_t i = prefix + k;
+            append_pointer_token(path_, std::to_string(i));
+            diff(a[i], ca[i], b[i], cb[i]);
+            path_.resize(base);
+        }
+        for (std::size_t k = mid_a; k < mid_b; ++k) {
+            const std::size_t i = prefix + k;
+            append_pointer_token(path_, std::to_string(i));
+            emit("add", &b[i]);
+            path_.resize(base);
+        }
+        for (std::size_t k = mid_b; k < mid_a; ++k) {
+            append_pointer_token(path_, std::to_string(prefix + mid_b));
+            emit("remove", nullptr);
+            path_.resize(base);
+        }
+    }
+
+    // Miolo [first, last] é o mesmo com um item levado de uma ponta à
+    // outra: um move
+    bool diff_moved_item(const std::vector<std::size_t> &ca,
+                         const std::vector<std::size_t> &cb, std::size_t first,
+                         std::size_t last) {
+        const auto same = [&](std::size_t i, std::size_t j) {
+            return ha_.hash(ca[i]) == hb_.hash(cb[j]);
+        };
+        bool forward = same(first, last);
+        bool backward = same(last, first);
+        for (std::size_t i = first; i < last && (forward || backward); ++i) {
+            forward = forward && same(i + 1, i);
+            backward = backward && same(i, i + 1);
+        }
+        if (!forward && !backward) {
+            return false;
+        }
+        const std::size_t base = path_.size();
+        append_pointer_token(path_, std::to_string(forward ? first : last));
+        std::string from = path_;
+        path_.resize(base);
+        append_pointer_token(path_, std::to_string(forward ? last : first));
+        ops_.push_back({{"op", "move"}, {"from", std::move(from)},
+                        {"path", path_}});
+        path_.resize(base);
+        return true;
+    }
+
+    const StructuralHash &ha_;
+    const StructuralHash &hb_;
+    std::string path_;
+    json ops_ = json::array();
+};
+
+// Tokens de um JSON Pointer ("" = raiz)
+inline std::vector<std::string> parse_pointer(const std::string &pointer) {
+    std::vector<std::string> tokens;
+    if (pointer.empty()) {
+        return tokens;
+    }
+    if (pointer[0] != '/') {
+        throw JsonPatchError("Invalid JSON pointer: " + pointer);
+    }
+    std::string token;
+    for (std::size_t i = 1; i <= pointer.size(); ++i) {
+        if (i == pointer.size() || pointer[i] == '/') {
+            tokens.push_back(std::move(token));
+            token.clear();
+        } else if (pointer[i] == '~') {
+            const char next = i + 1 < pointer.size() ? pointer[i + 1] : '\0';
+            if (next != '0' && next != '1') {
+                throw JsonPatchError("Invalid JSON pointer: " + pointer);
+            }
+            token += next == '0' ? '~' : '/';
+            ++i;
+        } else {
+            token += pointer[i];
+        }
+    }
+    return tokens;
+}
+
+// Índice de array: dígitos sem zero à esquerda, < limit
+inline std::size_t parse_index(const std::string &token, std::size_t limit) {
+    const bool digits =
+        !token.empty() && token.size() <= 18 &&
+        token.find_first_not_of("0123456789") == std::string::npos &&
+        (token.size() == 1 || token[0] != '0');
+    const std::size_t index = digits ? std::stoull(token) : limit;
+    if (index >= limit) {
+        throw JsonPatchError("Invalid array index: " + token);
+    }
+    return index;
+}
+
+class JsonPatcher {
+  public:
+    using json = nlohmann::json;
+    using Tokens = std::vector<std::string>;
+
+    explicit JsonPatcher(json &doc) : doc_(doc) {}
+
+    void apply(const json &patch) {
+        if (!patch.is_array()) {
+            throw JsonPatchError("Patch must be an array");
+        }
+        try {
+            for (const auto &op : patch) {
+                apply_op(op);
+            }
+        } catch (...) {
+            rollback();
+            throw;
+        }
+    }
+
+  private:
+    enum class Kind { Add, Remove, Replace };
+
+    struct Undo {
+        Kind kind;
+        Tokens path;
+        json value;
+    };
+
+    static const json &member(const json &op, const char *name) {
+        const auto it = op.find(name);
+        if (it == op.end()) {
+            throw JsonPatchError(std::string("Patch operation missing '") +
+                                 name + "'");
+        }
+        return *it;
+    }
+
+    static const std::string &string_member(const json &op,
+                                            const char *name) {
+        const json &value = member(op, name);
+        if (!value.is_string()) {
+            throw JsonPatchError(std::string("Patch member '") + name +
+                                 "' must be a string");
+        }
+        return value.get_ref<const std::string &>();
+    }
+
+    void apply_op(const json &op) {
+        if (!op.is_object()) {
+            throw JsonPatchError("Patch operation must be an object");
+        }
+        const std::string &name = string_member(op, "op");
+        const Tokens path = parse_pointer(string_member(op, "path"));
+        if (name == "add") {
+            add(path, member(op, "value"), true);
+        } else if (name == "remove") {
+            remove(path, true);
+        } else if (name == "replace") {
+            replace(path, member(op, "value"), true);
+        } else if (name == "move") {
+            const Tokens from = parse_pointer(string_member(op, "from"));
+            if (from == path) {
+                return;
+            }
+            if (from.size() < path.size() &&
+                std::equal(from.begin(), from.end(), path.begin())) {
+                throw JsonPatchError("Cannot move a value into itself");
+            }
+            add(path, remove(from, true), true);
+        } else if (name == "copy") {
+            const Tokens from = parse_pointer(string_member(op, "from"));
+            add(path, resolve(from), true);
+        } else if (name == "test") {
+            if (resolve(path) != member(op, "value")) {
+                throw JsonPatchError("Test failed at " +
+                                     string_member(op, "path"));
+            }
+        } else {
+            throw JsonPatchError("Unknown patch operation: " + name);
+        }
+    }
+
+    json &resolve(const Tokens &path, std::size_t depth) {
+        json *node = &doc_;
+        for (std::size_t i = 0; i < depth; ++i) {
+            if (node->is_object()) {
+                const auto it = node->find(path[i]);
+                if (it == node->end()) {
+                    throw JsonPatchError("Path not found: " + path[i]);
+                }
+                node = &*it;
+            } else if (node->is_array()) {
+                node = &(*node)[parse_index(path[i], node->size())];
+            } else {
+                throw JsonPatchError("Path not found: " + path[i]);
+            }
+        }
+        return *node;
+    }
+
+    json &resolve(const Tokens &path) { return resolve(path, path.size()); }
+
+    void add(const Tokens &path, json value, bool record) {
+        if (path.empty()) {
+            record_undo(record, Kind::Replace, path, std::move(doc_));
+            doc_ = std::move(value);
+            return;
+        }
+        json &parent = resolve(path, path.size() - 1);
+        const std::string &last = path.back();
+        if (parent.is_object()) {
+            const auto it = parent.find(last);
+            if (it != parent.end()) {
+                record_undo(record, Kind::Replace, path, std::move(*it));
+                *it = std::move(value);
+            } else {
+                record_undo(record, Kind::Remove, path, nullptr);
+                parent.emplace(last, std::move(value));
+            }
+        } else if (parent.is_array()) {
+            const std::size_t index =
+                last == "-" ? parent.size()
+                            : parse_index(last, parent.size() + 1);
+            Tokens concrete = path;
+            concrete.back() = std::to_string(index);
+            record_undo(record, Kind::Remove, std::move(concrete), nullptr);
+            parent.insert(parent.begin() + static_cast<std::ptrdiff_t>(index),
+                          std::move(value));
+        } else {
+            throw JsonPatchError("Cannot add to a scalar: " + last);
+        }
+    }
+
+    json remove(const Tokens &path, bool record) {
+        if (path.empty()) {
+            throw JsonPatchError("Cannot remove the document root");
+        }
+        json &parent = resolve(path, path.size() - 1);
+        const std::string &last = path.back();
+        json old;
+        if (parent.is_object()) {
+            const auto it = parent.find(last);
+            if (it == parent.end()) {
+                throw JsonPatchError("Path not found: " + last);
+            }
+            old = std::move(*it);
+            parent.erase(it);
+        } else if (parent.is_array()) {
+            const std::size_t index = parse_index(last, parent.size());
+            old = std::move(parent[index]);
+            parent.erase(index);
+        } else {
+            throw JsonPatchError("Path not found: " + last);
+        }
+        if (record) {
+            undo_.push_back({Kind::Add, path, old});
+        }
+        return old;
+    }
+
+    void replace(const Tokens &path, json value, bool record) {
+        json &target = resolve(path);
+        record_undo(record, Kind::Replace, path, std::move(target));
+        target = std::move(value);
+    }
+
+    void record_undo(bool record, Kind kind, Tokens path, json value) {
+        if (record) {
+            undo_.push_back({kind, std::move(path), std::move(value)});
+        }
+    }
+
+    // Desfaz na ordem inversa; cada passo só é possível porque o original
+    // foi possível, então não falha
+    void rollback() {
+        while (!undo_.empty()) {
+            Undo step = std::move(undo_.back());
+            undo_.pop_back();
+            switch (step.kind) {
+            case Kind::Add:
+                add(step.path, std::move(step.value), false);
+                break;
+            case Kind::Remove:
+                remove(step.path, false);
+                break;
+            case Kind::Replace:
+                replace(step.path, std::move(step.value), false);
+                break;
+            }
+        }
+    }
+
+    json &doc_;
+    std::vector<Undo> undo_;
+};
+
+} // namespace detail
+
+// Patch que leva `a` a `b` (add/remove/replace/move). Com os hashes já
+// calculados (documento guardado), só o lado novo precisa ser percorrido.
+[[nodiscard]] inline nlohmann::json json_diff(const nlohmann::json &a,
+                                              const StructuralHash &ha,
+                                              const nlohmann::json &b,
+                                              const StructuralHash &hb) {
+    return detail::JsonDiffer(ha, hb).run(a, b);
+}
+
+[[nodiscard]] inline nlohmann::json json_diff(const nlohmann::json &a,
+                                              const nlohmann::json &b) {
+    return json_diff(a, StructuralHash(a), b, StructuralHash(b));
+}
+
+// Aplica no lugar; JsonPatchError deixa `doc` como estava
+inline void apply_json_patch(nlohmann::json &doc,
+                             const nlohmann::json &patch) {
+    detail::JsonPatcher(doc).apply(patch);
+}
+
+} // namespace app
@@ -0,0 +1,391 @@
+#pragma once
+// =============================================================================
+// Log - Logger assíncrono com níveis, filtro em compile-time e rate limit
+// =============================================================================
+// APP_LOG_INFO("DEV", "Servidor disponível em ", url) não formata nem faz
+// I/O na thread que chama: os argumentos são copiados (textos viram
+// std::string) para um ring buffer da própria thread (um produtor, sem
+// locks) e uma thread de escrita formata, ordena por timestamp e grava em
+// lote, com um flush por lote. Ring cheio descarta o registro e conta.
+//
+// - Níveis abaixo de APP_LOG_MIN_LEVEL somem na compilação; abaixo de
+//   set_level() custam um load e um branch (--verbose liga Debug).
+// - Cada ponto de log aceita RATE_BURST registros por RATE_WINDOW; os
+//   excedentes são contados e anunciados no próximo registro aceito.
+// - flush() espera a thread de escrita (encerramento).
+//
+// `tag` precisa viver até o fim do processo (literal).
+// =============================================================================
+
+#include "app/thread_signals.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 0 = Debug, 1 = Info, 2 = Warn, 3 = Error
+#ifndef APP_LOG_MIN_LEVEL
+#define APP_LOG_MIN_LEVEL 0
+#endif
+
+namespace app::log {
+
+enum class Level : int { Debug = 0, Info = 1, Warn = 2, Error = 3 };
+
+inline constexpr std::size_t RING_SLOTS = 512;   // registros por thread
+inline constexpr std::size_t INLINE_BYTES = 160; // args sem alocação extra
+inline constexpr std::chrono::seconds RATE_WINDOW{1};
+inline constexpr std::uint32_t RATE_BURST = 20;
+
+// Recebe cada linha já formatada ("[TAG] mensagem"), na thread de escrita
+using Sink = std::function<void(Level, std::string_view line)>;
+
+namespace detail {
+
+inline std::atomic<int> min_level{static_cast<int>(Level::Info)};
+
+inline std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Tipo guardado para cada argumento: a formatação roda depois, em outra
+// thread, então nada de ponteiros/views para texto do chamador
+template <typename T> struct Captured {
+    using type = std::decay_t<T>;
+};
+template <typename T>
+    requires(std::is_convertible_v<const std::decay_t<T> &,
+                                   std::string_view> &&
+             !std::is_same_v<std::decay_t<T>, std::string>)
+struct Captured<T> {
+    using type = std::string;
+};
+
+template <typename... Args>
+void append_all(std::string &out, const Args &...args) {
+    std::ostringstream stream;
+    (stream << ... << args);
+    out += stream.str();
+}
+
+struct Record {
+    std::int64_t ts_ns = 0;
+    Level level = Level::Info;
+    const char *tag = nullptr;
+    std::uint32_t suppressed = 0;
+    // Formata os args guardados em `storage` e os destrói
+    void (*render)(Record &, std::string &) = nullptr;
+    alignas(std::max_align_t) unsigned char storage[INLINE_BYTES];
+};
+
+template <typename Tuple> void render_tuple(Record &record, std::string &out) {
+    auto *args = std::launder(reinterpret_cast<Tuple *>(record.storage));
+    std::apply([&out](const auto &...values) { append_all(out, values...); },
+               *args);
+    args->~Tuple();
+}
+
+struct Ring {
+    std::atomic<std::uint64_t> head{0}; // produtor
+    std::atomic<std::uint64_t> tail{0}; // thread de escrita
+    std::atomic<std::uint64_t> dropped{0};
+    std::array<Record, RING_SLOTS> slots;
+};
+
+struct Line {
+    std::int64_t ts_ns;
+    Level level;
+    std::string text;
+};
+
+class Backend {
+  public:
+    Backend() : sink_(default_sink) {
+        writer_ = std::jthread([this](std::stop_token stop) { run(stop); });
+    }
+
+    // Drena o que restou antes de sair
+    ~Backend() {
+        writer_.request_stop();
+        writer_.join();
+    }
+
+    Backend(const Backend &) = delete;
+    Backend &operator=(const Backend &) = delete;
+
+    Ring &local_ring() {
+        thread_local std::shared_ptr<Ring> ring;
+        if (!ring) {
+            ring = std::make_shared<Ring>();
+            std::lock_guard<std::mutex> lock(mu_);
+            rings_.push_back(ring);
+        }
+        return *ring;
+    }
+
+    // Primeiro registro desde a última drenagem (fila vazia -> não vazia)
+    // acorda a escrita, que dorme sem prazo. Passar pelo lock garante que
+    // ela está antes do teste do predicado ou já dormindo, nunca entre os
+    // dois: o aviso não se perde. Os demais registros não tocam no lock.
+    void notify() {
+        if (!pending_.exchange(true, std::memory_order_acq_rel)) {
+            { std::lock_guard<std::mutex> lock(mu_); }
+            wake_.notify_one();
+        }
+    }
+
+    void set_sink(Sink sink) {
+        std::lock_guard<std::mutex> lock(mu_);
+        sink_ = sink ? std::move(sink) : Sink(default_sink);
+    }
+
+    void flush(std::chrono::milliseconds timeout) {
+        if (std::this_thread::get_id() == writer_.get_id()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mu_);
+        const std::uint64_t ticket = ++flush_requested_;
+        wake_.notify_one();
+        flushed_.wait_for(lock, timeout,
+                          [&] { return flush_done_ >= ticket; });
+    }
+
+  private:
+    static void default_sink(Level level, std::string_view line) {
+        std::FILE *out = level >= Level::Warn ? stderr : stdout;
+        std::fwrite(line.data(), 1, line.size(), out);
+        std::fputc('\n', out);
+    }
+
+    void run(std::stop_token stop) {
+        // Nasce no primeiro log, antes do SignalWatcher
+        block_thread_signals();
+        std::vector<Line> batch;
+        while (true) {
+            std::uint64_t requested = 0;
+            {
+                std::unique_lock<std::mutex> lock(mu_);
+                wake_.wait(lock, stop, [this] {
+                    return pending_.load(std::memory_order_acquire) ||
+                           flush_requested_ > flush_done_;
+                });
+                requested = flush_requested_;
+            }
+            // RMW: vê o último exchange de um produtor, e com ele o head
+            pending_.exchange(false, std::memory_order_acq_rel);
+            drain(batch);
+            {
+                std::lock_guard<std::mutex> lock(mu_);
+                flush_done_ = requested;
+            }
+            flushed_.notify_all();
+            if (stop.stop_requested()) {
+                drain(batch);
+                return;
+            }
+        }
+    }
+
+    void drain(std::vector<Line> &batch) {
+        std::vector<std::shared_ptr<Ring>> rings;
+        Sink sink;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            // Rings de threads que já saíram e foram esvaziados
+            std::erase_if(rings_, [](const std::shared_ptr<Ring> &ring) {
+                return ring.use_count() == 1 &&
+                       ring->tail.load(std::memory_order_relaxed) ==
+                           ring->head.load(std::memory_order_acquire);
+            });
+            rings = rings_;
+            sink = sink_;
+        }
+
+        batch.clear();
+        for (const auto &ring : rings) {
+            const std::uint64_t tail =
+                ring->tail.load(std::memory_order_relaxed);
+            const std::uint64_t head =
+                ring->head.load(std::memory_order_acquire);
+            for (std::uint64_t i = tail; i < head; ++i) {
+                Record &record = ring->slots[i % RING_SLOTS];
+                Line line{record.ts_ns, record.level, {}};
+                if (record.tag && *record.tag) {
+                    line.text += '[';
+                    line.text += record.tag;
+                    line.text += "] ";
+                }
+                record.render(record, line.text);
+                if (record.suppressed > 0) {
+                    line.text += " (+" + std::to_string(record.suppressed) +
+                                 " suprimidas)";
+                }
+                batch.push_back(std::move(line));
+            }
+            ring->tail.store(head, std::memory_order_release);
+            if (const auto dropped = ring->dropped.exchange(0)) {
+                batch.push_back({now_ns(), Level::Warn,
+                                 "[LOG] " + std::to_string(dropped) +
+                                     " registros descartados (buffer cheio)"});
+            }
+        }
+        if (batch.empty()) {
+            return;
+        }
+        std::stable_sort(batch.begin(), batch.end(),
+                         [](const Line &a, const Line &b) {
+                             return a.ts_ns < b.ts_ns;
+                         });
+        for (const auto &line : batch) {
+            sink(line.level, line.text);
+        }
+        std::fflush(stdout);
+        std::fflush(stderr);
+    }
+
+    std::mutex mu_;
+    std::condition_variable_any wake_;
+    std::condition_variable_any flushed_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    Sink sink_;
+    std::atomic<bool> pending_{false};
+    std::uint64_t flush_requested_ = 0;
+    std::uint64_t flush_done_ = 0;
+    std::jthread writer_;
+};
+
+inline Backend &backend() {
+    static Backend instance;
+    return instance;
+}
+
+} // namespace detail
+
+[[nodiscard]] inline bool enabled(Level level) {
+    return static_cast<int>(level) >=
+           detail::min_level.load(std::memory_order_relaxed);
+}
+
+inline void set_level(Level level) {
+    detail::min_level.store(static_cast<int>(level),
+                            std::memory_order_relaxed);
+}
+
+// nullptr restaura a saída padrão (stdout; Warn/Error em stderr)
+inline void set_sink(Sink sink) { detail::backend().set_sink(std::move(sink)); }
+
+// Espera a escrita do que já foi registrado (até `timeout`)
+inline void flush(std::chrono::milliseconds timeout =
+                      std::chrono::milliseconds(1000)) {
+    detail::backend().flush(timeout);
+}
+
+// Rate limit por ponto de log (um static por expansão de APP_LOG)
+class SiteLimiter {
+  public:
+    // -1 = descartar; senão, quantos foram descartados desde o último aceito
+    long admit(std::int64_t now_ns = detail::now_ns()) {
+        const std::int64_t window =
+            now_ns /
+            std::chrono::duration_cast<std::chrono::nanoseconds>(RATE_WINDOW)
+                .count();
+        std::int64_t current = window_.load(std::memory_order_relaxed);
+        if (current != window &&
+            window_.compare_exchange_strong(current, window,
+                                            std::memory_order_relaxed)) {
+            count_.store(0, std::memory_order_relaxed);
+        }
+        if (count_.fetch_add(1, std::memory_order_relaxed) < RATE_BURST) {
+            return static_cast<long>(
+                suppressed_.exchange(0, std::memory_order_relaxed));
+        }
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+
+  private:
+    std::atomic<std::int64_t> window_{-1};
+    std::atomic<std::uint32_t> count_{0};
+    std::atomic<std::uint32_t> suppressed_{0};
+};
+
+// Enfileira um registro; prefira as macros APP_LOG_* (filtro de nível e
+// rate limit)
+template <typename... Args>
+void write(Level level, const char *tag, std::uint32_t suppressed,
+           Args &&...args) {
+    detail::Backend &backend = detail::backend();
+    detail::Ring &ring = backend.local_ring();
+    const std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= RING_SLOTS) {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    detail::Record &record = ring.slots[head % RING_SLOTS];
+    record.ts_ns = detail::now_ns();
+    record.level = level;
+    record.tag = tag;
+    record.suppressed = suppressed;
+    using Tuple = std::tuple<typename detail::Captured<Args>::type...>;
+    if constexpr (sizeof(Tuple) <= INLINE_BYTES &&
+                  alignof(Tuple) <= alignof(std::max_align_t)) {
+        ::new (static_cast<void *>(record.storage))
+            Tuple(std::forward<Args>(args)...);
+        record.render = &detail::render_tuple<Tuple>;
+    } else {
+        // Args grandes demais para o slot: formata aqui mesmo
+        std::string text;
+        detail::append_all(text, args...);
+        using Text = std::tuple<std::string>;
+        ::new (static_cast<void *>(record.storage)) Text(std::move(text));
+        record.render = &detail::render_tuple<Text>;
+    }
+    ring.head.store(head + 1, std::memory_order_release);
+    backend.notify();
+}
+
+} // namespace app::log
+
+#define APP_LOG(level, tag, ...)                                               \
+    do {                                                                       \
+        if constexpr (static_cast<int>(level) >= APP_LOG_MIN_LEVEL) {          \
+            if (::app::log::enabled(level)) {                                  \
+                static ::app::log::SiteLimiter app_log_site_;                  \
+                const long app_log_admit_ = app_log_site_.admit();             \
+                if (app_log_admit_ >= 0) {                                     \
+                    ::app::log::write(                                         \
+                        level, tag,                                            \
+                        static_cast<std::uint32_t>(app_log_admit_),            \
+                        __VA_ARGS__);                                          \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+    } while (false)
+
+#define APP_LOG_DEBUG(tag, ...)                                                \
+    APP_LOG(::app::log::Level::Debug, tag, __VA_ARGS__)
+#define APP_LOG_INFO(tag, ...)                                                 \
+    APP_LOG(::app::log::Level::Info, tag, __VA_ARGS__)
+#define APP_LOG_WARN(tag, ...)                                                 \
+    APP_LOG(::app::log::Level::Warn, tag, __VA_ARGS__)
+#define APP_LOG_ERROR(tag, ...)                                                \
+    APP_LOG(::app::log::Level::Error, tag, __VA_ARGS__)
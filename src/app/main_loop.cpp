@@ -0,0 +1,325 @@
+#include "app/main_loop.h"
+#include <memory>
+
+#if defined(__linux__)
+#include "app/executor.h"
+#include "app/tracing.h"
+#include <cstdint>
+#include <fcntl.h>
+#include <glib-unix.h>
+#include <glib.h>
+#include <mutex>
+#include <sys/epoll.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#endif
+
+namespace app {
+
+#if defined(__linux__)
+namespace {
+
+gboolean run_timer(gpointer data) {
+    auto *callback = static_cast<std::function<bool()> *>(data);
+    return (*callback)() ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+void destroy_timer(gpointer data) {
+    delete static_cast<std::function<bool()> *>(data);
+}
+
+// =============================================================================
+// Reactor: epoll edge-triggered como uma única fonte GLib
+// =============================================================================
+
+constexpr int REACTOR_BATCH = 64;
+
+struct FdWatch {
+    FdWatchId id = 0;
+    int fd = -1;
+    FdCallback callback;
+    FdDispatch dispatch = FdDispatch::Ui;
+
+    // Estado do despacho no pool
+    std::mutex mu;
+    unsigned pending = 0;
+    bool scheduled = false;
+    bool removed = false;
+    std::thread::id running_on;
+    Task task;
+};
+
+unsigned from_epoll(std::uint32_t events) {
+    unsigned out = 0;
+    if (events & (EPOLLIN | EPOLLPRI)) {
+        out |= FdReadable;
+    }
+    if (events & EPOLLOUT) {
+        out |= FdWritable;
+    }
+    if (events & (EPOLLHUP | EPOLLRDHUP)) {
+        out |= FdHangup;
+    }
+    if (events & EPOLLERR) {
+        out |= FdError;
+    }
+    return out;
+}
+
+std::uint32_t to_epoll(unsigned events) {
+    // Hangup e erro sempre chegam; EPOLLRDHUP só se pedido
+    std::uint32_t out = EPOLLET;
+    if (events & FdReadable) {
+        out |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (events & FdWritable) {
+        out |= EPOLLOUT;
+    }
+    return out;
+}
+
+class Reactor {
+  public:
+    FdWatchId add(int fd, unsigned events, FdCallback callback,
+                  FdDispatch dispatch) {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (!ensure_source()) {
+            return 0;
+        }
+        auto watch = std::make_shared<FdWatch>();
+        watch->id = ++next_id_;
+        watch->fd = fd;
+        watch->callback = std::move(callback);
+        watch->dispatch = dispatch;
+
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        epoll_event event{};
+        event.events = to_epoll(events);
+        event.data.u64 = watch->id;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+            return 0;
+        }
+        watches_.emplace(watch->id, watch);
+        return watch->id;
+    }
+
+    void remove(FdWatchId id) {
+        std::shared_ptr<FdWatch> watch;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            const auto it = watches_.find(id);
+            if (it == watches_.end()) {
+                return;
+            }
+            watch = std::move(it->second);
+            watches_.erase(it);
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, watch->fd, nullptr);
+        }
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(watch->mu);
+            watch->removed = true;
+            if (watch->running_on == std::this_thread::get_id()) {
+                return; // de dentro do próprio callback
+            }
+            task = watch->task;
+        }
+        task.cancel();
+        task.wait();
+    }
+
+    // Thread da UI: o epoll ficou legível
+    void dispatch_ready() {
+        epoll_event events[REACTOR_BATCH];
+        const int count = epoll_wait(epoll_fd_, events, REACTOR_BATCH, 0);
+        if (count <= 0) {
+            return;
+        }
+        APP_TRACE_SPAN("reactor", "reactor.batch");
+        trace::counter("reactor", "ready_fds", count);
+        for (int i = 0; i < count; ++i) {
+            std::shared_ptr<FdWatch> watch;
+            {
+                std::lock_guard<std::mutex> lock(mu_);
+                const auto it = watches_.find(
+                    static_cast<FdWatchId>(events[i].data.u64));
+                if (it == watches_.end()) {
+                    continue; // removido por um callback anterior do lote
+                }
+                watch = it->second;
+            }
+            const unsigned ready = from_epoll(events[i].events);
+            if (watch->dispatch == FdDispatch::Ui) {
+                run_on_ui(*watch, ready);
+            } else {
+                post_to_worker(watch, ready);
+            }
+        }
+    }
+
+  private:
+    // mu_ travado. A fonte vive até o fim do processo.
+    bool ensure_source() {
+        if (epoll_fd_ >= 0) {
+            return true;
+        }
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0) {
+            return false;
+        }
+        g_unix_fd_add_full(G_PRIORITY_DEFAULT, epoll_fd_, G_IO_IN,
+                           on_epoll_ready, this, nullptr);
+        return true;
+    }
+
+    static gboolean on_epoll_ready(gint, GIOCondition, gpointer data) {
+        static_cast<Reactor *>(data)->dispatch_ready();
+        return G_SOURCE_CONTINUE;
+    }
+
+    void run_on_ui(FdWatch &watch, unsigned ready) {
+        {
+            std::lock_guard<std::mutex> lock(watch.mu);
+            if (watch.removed) {
+                return;
+            }
+            watch.running_on = std::this_thread::get_id();
+        }
+        if (!watch.callback(ready)) {
+            remove(watch.id); // ainda marcado como rodando: não espera
+        }
+        std::lock_guard<std::mutex> lock(watch.mu);
+        watch.running_on = {};
+    }
+
+    void post_to_worker(const std::shared_ptr<FdWatch> &watch,
+                        unsigned ready) {
+        std::lock_guard<std::mutex> lock(watch->mu);
+        watch->pending |= ready;
+        if (watch->removed || watch->scheduled) {
+            return;
+        }
+        watch->scheduled = true;
+        watch->task = executor().submit(Lane::Normal, "fd-watch",
+                                        [this, watch] { drain(*watch); });
+    }
+
+    // Worker: roda o callback enquanto houver eventos acumulados
+    void drain(FdWatch &watch) {
+        while (true) {
+            unsigned ready = 0;
+            {
+                std::lock_guard<std::mutex> lock(watch.mu);
+                if (watch.removed || watch.pending == 0) {
+                    watch.scheduled = false;
+                    return;
+                }
+                ready = std::exchange(watch.pending, 0);
+                watch.running_on = std::this_thread::get_id();
+            }
+            const bool keep = watch.callback(ready);
+            if (!keep) {
+                remove(watch.id);
+            }
+            std::lock_guard<std::mutex> lock(watch.mu);
+            watch.running_on = {};
+            if (!keep) {
+                watch.scheduled = false;
+                return;
+            }
+        }
+    }
+
+    std::mutex mu_;
+    int epoll_fd_ = -1;
+    FdWatchId next_id_ = 0;
+    std::unordered_map<FdWatchId, std::shared_ptr<FdWatch>> watches_;
+};
+
+Reactor &reactor() {
+    static Reactor instance;
+    return instance;
+}
+
+} // namespace
+#endif
+
+bool has_ui_main_loop() {
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+UiTimerId add_ui_timer(std::chrono::milliseconds interval,
+                       std::function<bool()> callback) {
+#if defined(__linux__)
+    if (!callback) {
+        return 0;
+    }
+    auto holder = std::make_unique<std::function<bool()>>(std::move(callback));
+    return g_timeout_add_full(G_PRIORITY_DEFAULT,
+                              static_cast<guint>(interval.count()), run_timer,
+                              holder.release(), destroy_timer);
+#else
+    (void)interval;
+    (void)callback;
+    return 0;
+#endif
+}
+
+void remove_ui_timer(UiTimerId id) {
+#if defined(__linux__)
+    if (id != 0) {
+        g_source_remove(id);
+    }
+#else
+    (void)id;
+#endif
+}
+
+bool drain_ui_queue(std::chrono::steady_clock::time_point until) {
+#if defined(__linux__)
+    while (g_main_context_pending(nullptr)) {
+        if (std::chrono::steady_clock::now() >= until) {
+            return false;
+        }
+        g_main_context_iteration(nullptr, FALSE);
+    }
+    return true;
+#else
+    (void)until;
+    return true;
+#endif
+}
+
+FdWatchId add_fd_watch(int fd, unsigned events, FdCallback callback,
+                       FdDispatch dispatch) {
+#if defined(__linux__)
+    if (fd < 0 || !callback) {
+        return 0;
+    }
+    return reactor().add(fd, events, std::move(callback), dispatch);
+#else
+    (void)fd;
+    (void)events;
+    (void)callback;
+    (void)dispatch;
+    return 0;
+#endif
+}
+
+void remove_fd_watch(FdWatchId id) {
+#if defined(__linux__)
+    if (id != 0) {
+        reactor().remove(id);
+    }
+#else
+    (void)id;
+#endif
+}
+
+} // namespace app
@@ -0,0 +1,67 @@
+#pragma once
+// =============================================================================
+// Main loop helpers - timers e fds no loop da UI (código nativo no .cpp)
+// =============================================================================
+
+#include <chrono>
+#include <functional>
+
+namespace app {
+
+using UiTimerId = unsigned int;
+
+// true quando a plataforma expõe o main loop da webview (GLib/GTK). Nas
+// demais, os chamadores precisam de um fallback próprio.
+bool has_ui_main_loop();
+
+// Agenda `callback` no main loop da UI a cada `interval`. O callback roda na
+// thread da UI e retorna false para se desarmar. Retorna 0 quando não há
+// main loop disponível.
+UiTimerId add_ui_timer(std::chrono::milliseconds interval,
+                       std::function<bool()> callback);
+
+// Remove um timer ainda armado (ids 0 ou já desarmados são ignorados).
+void remove_ui_timer(UiTimerId id);
+
+// Processa o que estiver pendente no main loop (dispatches, eventos) sem
+// bloquear, até esvaziar ou `until` passar. Usado no encerramento, depois
+// que o loop saiu. Retorna true se a fila ficou vazia (sempre true sem main
+// loop).
+bool drain_ui_queue(std::chrono::steady_clock::time_point until);
+
+// =============================================================================
+// Reactor de fds
+// =============================================================================
+// Linux: um único epoll (edge-triggered) registrado como fonte GLib no main
+// loop. Cada wakeup processa um lote de até 64 fds prontos, sem thread de
+// polling. O callback precisa consumir o fd até EAGAIN: com edge-triggered,
+// dado deixado no buffer não gera novo aviso. Callbacks caros vão para o
+// pool (FdDispatch::Worker): um por vez por fd, com os eventos que chegarem
+// no meio acumulados para a próxima rodada.
+
+using FdWatchId = unsigned int;
+
+enum FdEvent : unsigned {
+    FdReadable = 1u << 0,
+    FdWritable = 1u << 1,
+    FdHangup = 1u << 2, // a outra ponta fechou (EOF ainda pode ter dados)
+    FdError = 1u << 3,
+};
+
+enum class FdDispatch { Ui, Worker };
+
+// Recebe os eventos (FdEvent) e retorna false para se desarmar
+using FdCallback = std::function<bool(unsigned events)>;
+
+// Observa `fd` (em modo não bloqueante) até o callback retornar false ou
+// remove_fd_watch. Retorna 0 quando não há main loop disponível: o chamador
+// mantém o fallback próprio.
+FdWatchId add_fd_watch(int fd, unsigned events, FdCallback callback,
+                       FdDispatch dispatch = FdDispatch::Ui);
+
+// Remove antes de fechar o fd. Ao retornar, nenhum callback está rodando
+// nem vai rodar (exceto quando chamado de dentro do próprio callback).
+// Watches Ui devem ser removidos na thread da UI.
+void remove_fd_watch(FdWatchId id);
+
+} // namespace app
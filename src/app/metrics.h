@@ -0,0 +1,380 @@
+#pragma once
+// =============================================================================
+// Metrics - Contadores, gauges e histogramas de latência (estilo HDR)
+// =============================================================================
+// Sempre ligado: gravar é um punhado de atomics relaxed, sem locks. O mutex
+// do Registry só protege a criação das métricas (no bind) e a leitura para
+// exportação (getNativeMetrics, dump periódico em texto).
+//
+// LatencyHistogram usa buckets log-lineares: 32 sub-buckets por potência de
+// dois, erro relativo máximo ~3%, de 1ns a 2^37-1 ns (~137s) em ~1k
+// contadores; valores acima disso caem no último bucket.
+// =============================================================================
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+
+namespace app::metrics {
+
+class Counter {
+  public:
+    void add(std::uint64_t n = 1) {
+        value_.fetch_add(n, std::memory_order_relaxed);
+    }
+    [[nodiscard]] std::uint64_t value() const {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+class Gauge {
+  public:
+    void set(std::int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(std::int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    [[nodiscard]] std::int64_t value() const {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<std::int64_t> value_{0};
+};
+
+// Valores em nanossegundos
+class LatencyHistogram {
+  public:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr std::uint64_t SUB_BUCKETS = 1u << SUB_BITS;
+    static constexpr unsigned MAX_SHIFT = 31; // teto: 2^37 - 1 ns (~137s)
+    static constexpr std::size_t BUCKETS = (MAX_SHIFT + 2) * SUB_BUCKETS;
+    static constexpr std::uint64_t MAX_VALUE =
+        ((2 * SUB_BUCKETS) << MAX_SHIFT) - 1;
+
+    [[nodiscard]] static std::size_t bucket_index(std::uint64_t value) {
+        value = std::min(value, MAX_VALUE);
+        if (value < 2 * SUB_BUCKETS) {
+            return static_cast<std::size_t>(value);
+        }
+        const unsigned shift =
+            static_cast<unsigned>(std::bit_width(value)) - (SUB_BITS + 1);
+        return static_cast<std::size_t>((shift + 1) * SUB_BUCKETS +
+                                        ((value >> shift) - SUB_BUCKETS));
+    }
+
+    // Maior valor que cai no bucket (o percentil nunca subestima)
+    [[nodiscard]] static std::uint64_t bucket_upper(std::size_t index) {
+        if (index < 2 * SUB_BUCKETS) {
+            return index;
+        }
+        const auto shift = static_cast<unsigned>(index / SUB_BUCKETS - 1);
+        const std::uint64_t base = index % SUB_BUCKETS + SUB_BUCKETS;
+        return ((base + 1) << shift) - 1;
+    }
+
+    void record(std::uint64_t value) {
+        buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        std::uint64_t seen = max_.load(std::memory_order_relaxed);
+        while (value > seen &&
+               !max_.compare_exchange_weak(seen, value,
+                                           std::memory_order_relaxed)) {
+        }
+    }
+
+    void record(std::chrono::nanoseconds value) {
+        record(static_cast<std::uint64_t>(std::max<std::int64_t>(
+            value.count(), 0)));
+    }
+
+    [[nodiscard]] std::uint64_t count() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] std::uint64_t sum() const {
+        return sum_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] std::uint64_t max() const {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    // q em [0, 1]; 0 sem amostras
+    [[nodiscard]] std::uint64_t percentile(double q) const {
+        std::array<std::uint64_t, BUCKETS> snapshot{};
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            snapshot[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += snapshot[i];
+        }
+        if (total == 0) {
+            return 0;
+        }
+        const double clamped = std::clamp(q, 0.0, 1.0);
+        const auto rank = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(
+                   clamped * static_cast<double>(total) + 0.999999));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            seen += snapshot[i];
+            if (seen >= rank) {
+                return std::min(bucket_upper(i), max());
+            }
+        }
+        return max();
+    }
+
+  private:
+    std::array<std::atomic<std::uint64_t>, BUCKETS> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+// Métricas de um binding (nome vindo do bind / meta::registry())
+struct BindingMetrics {
+    static constexpr std::size_t ERROR_SLOTS = 8;
+
+    Counter calls;
+    Counter request_bytes;
+    Counter response_bytes;
+    LatencyHistogram latency;
+
+    // Erros por código (ErrorCode), slots reivindicados sem lock. Códigos
+    // além de ERROR_SLOTS distintos caem em errors_other.
+    void record_error(int code) {
+        for (auto &slot : error_slots_) {
+            int current = slot.code.load(std::memory_order_relaxed);
+            if (current == 0 &&
+                slot.code.compare_exchange_strong(current, code,
+                                                  std::memory_order_relaxed)) {
+                current = code;
+            }
+            if (current == code) {
+                slot.count.add();
+                return;
+            }
+        }
+        errors_other.add();
+    }
+
+    [[nodiscard]] std::map<int, std::uint64_t> errors() const {
+        std::map<int, std::uint64_t> out;
+        for (const auto &slot : error_slots_) {
+            const int code = slot.code.load(std::memory_order_relaxed);
+            if (code != 0 && slot.count.value() > 0) {
+                out[code] = slot.count.value();
+            }
+        }
+        return out;
+    }
+
+    [[nodiscard]] std::uint64_t error_count() const {
+        std::uint64_t total = errors_other.value();
+        for (const auto &[code, count] : errors()) {
+            total += count;
+        }
+        return total;
+    }
+
+    Counter errors_other;
+
+  private:
+    struct ErrorSlot {
+        std::atomic<int> code{0};
+        Counter count;
+    };
+    std::array<ErrorSlot, ERROR_SLOTS> error_slots_;
+};
+
+class Registry {
+  public:
+    // Referências estáveis: criadas uma vez, vivem até o fim do registry
+    Counter &counter(std::string_view name) { return get(counters_, name); }
+    Gauge &gauge(std::string_view name) { return get(gauges_, name); }
+    LatencyHistogram &histogram(std::string_view name) {
+        return get(histograms_, name);
+    }
+    BindingMetrics &binding(std::string_view name) {
+        return get(bindings_, name);
+    }
+
+    // Latências em microssegundos
+    [[nodiscard]] nlohmann::json to_json() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        nlohmann::json out = {{"counters", nlohmann::json::object()},
+                              {"gauges", nlohmann::json::object()},
+                              {"histograms", nlohmann::json::object()},
+                              {"bindings", nlohmann::json::object()}};
+        for (const auto &[name, counter] : counters_) {
+            out["counters"][name] = counter->value();
+        }
+        for (const auto &[name, gauge] : gauges_) {
+            out["gauges"][name] = gauge->value();
+        }
+        for (const auto &[name, histogram] : histograms_) {
+            out["histograms"][name] = latency_json(*histogram);
+        }
+        for (const auto &[name, binding] : bindings_) {
+            nlohmann::json errors = nlohmann::json::object();
+            for (const auto &[code, count] : binding->errors()) {
+                errors[std::to_string(code)] = count;
+            }
+            if (binding->errors_other.value() > 0) {
+                errors["other"] = binding->errors_other.value();
+            }
+            out["bindings"][name] = {
+                {"calls", binding->calls.value()},
+                {"errors", binding->error_count()},
+                {"errorsByCode", std::move(errors)},
+                {"requestBytes", binding->request_bytes.value()},
+                {"responseBytes", binding->response_bytes.value()},
+                {"latencyUs", latency_json(binding->latency)}};
+        }
+        return out;
+    }
+
+    // Formato texto, uma amostra por linha (estilo Prometheus)
+    [[nodiscard]] std::string to_text() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        std::string out;
+        char line[256];
+        for (const auto &[name, counter] : counters_) {
+            std::snprintf(line, sizeof(line), "%s %llu\n", name.c_str(),
+                          static_cast<unsigned long long>(counter->value()));
+            out += line;
+        }
+        for (const auto &[name, gauge] : gauges_) {
+            std::snprintf(line, sizeof(line), "%s %lld\n", name.c_str(),
+                          static_cast<long long>(gauge->value()));
+            out += line;
+        }
+        for (const auto &[name, histogram] : histograms_) {
+            append_quantiles(out, name.c_str(), "", *histogram);
+        }
+        for (const auto &[name, binding] : bindings_) {
+            const std::string label = "{binding=\"" + name + "\"";
+            append_sample(out, "binding_calls", label + "}",
+                          binding->calls.value());
+            for (const auto &[code, count] : binding->errors()) {
+                append_sample(out, "binding_errors",
+                              label + ",code=\"" + std::to_string(code) +
+                                  "\"}",
+                              count);
+            }
+            if (binding->errors_other.value() > 0) {
+                append_sample(out, "binding_errors",
+                              label + ",code=\"other\"}",
+                              binding->errors_other.value());
+            }
+            append_sample(out, "binding_request_bytes", label + "}",
+                          binding->request_bytes.value());
+            append_sample(out, "binding_response_bytes", label + "}",
+                          binding->response_bytes.value());
+            append_quantiles(out, "binding_latency_us", label + ",",
+                             binding->latency);
+        }
+        return out;
+    }
+
+    // false se o arquivo não pôde ser escrito
+    bool write_text(const std::string &path) const {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << to_text();
+        return static_cast<bool>(file);
+    }
+
+  private:
+    template <typename T>
+    T &get(std::map<std::string, std::unique_ptr<T>, std::less<>> &map,
+           std::string_view name) {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = map.find(name);
+        if (it == map.end()) {
+            it = map.emplace(std::string(name), std::make_unique<T>()).first;
+        }
+        return *it->second;
+    }
+
+    static double to_us(std::uint64_t ns) {
+        return static_cast<double>(ns) / 1000.0;
+    }
+
+    static nlohmann::json latency_json(const LatencyHistogram &histogram) {
+        const std::uint64_t count = histogram.count();
+        return {{"count", count},
+                {"mean", count ? to_us(histogram.sum()) /
+                                     static_cast<double>(count)
+                               : 0.0},
+                {"p50", to_us(histogram.percentile(0.50))},
+                {"p99", to_us(histogram.percentile(0.99))},
+                {"p999", to_us(histogram.percentile(0.999))},
+                {"max", to_us(histogram.max())}};
+    }
+
+    static void append_sample(std::string &out, const char *metric,
+                              const std::string &labels,
+                              std::uint64_t value) {
+        out += metric;
+        out += labels;
+        out += ' ';
+        out += std::to_string(value);
+        out += '\n';
+    }
+
+    // `labels_prefix` é "" ou "{chave=\"valor\"," (o quantile fecha)
+    static void append_quantiles(std::string &out, const char *metric,
+                                 const std::string &labels_prefix,
+                                 const LatencyHistogram &histogram) {
+        static constexpr std::array<std::pair<const char *, double>, 3>
+            QUANTILES = {{{"0.5", 0.50}, {"0.99", 0.99}, {"0.999", 0.999}}};
+        const std::string open = labels_prefix.empty() ? "{" : labels_prefix;
+        char value[32];
+        for (const auto &[label, q] : QUANTILES) {
+            std::snprintf(value, sizeof(value), "%.1f",
+                          to_us(histogram.percentile(q)));
+            out += metric;
+            out += open;
+            out += "quantile=\"";
+            out += label;
+            out += "\"} ";
+            out += value;
+            out += '\n';
+        }
+        const std::string close =
+            labels_prefix.empty()
+                ? ""
+                : labels_prefix.substr(0, labels_prefix.size() - 1) + "}";
+        append_sample(out, (std::string(metric) + "_count").c_str(), close,
+                      histogram.count());
+    }
+
+    mutable std::mutex mu_;
+    std::map<std::string, std::unique_ptr<Counter>, std::less<>> counters_;
+    std::map<std::string, std::unique_ptr<Gauge>, std::less<>> gauges_;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>, std::less<>>
+        histograms_;
+    std::map<std::string, std::unique_ptr<BindingMetrics>, std::less<>>
+        bindings_;
+};
+
+inline Registry &registry() {
+    static Registry instance;
+    return instance;
+}
+
+} // namespace app::metrics
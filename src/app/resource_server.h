@@ -0,0 +1,339 @@
+#pragma once
+// =============================================================================
+// ResourceServer - Serve a UI embarcada via esquema customizado (app://)
+// =============================================================================
+// Lógica pura (sem WebKit): resolve o path, escolhe MIME, gera ETag,
+// trata If-None-Match e Range. O adaptador de plataforma fica em
+// scheme_handler.cpp e apenas traduz Request/Response para a API nativa.
+// =============================================================================
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace app::resources {
+
+// Esquema e URL de entrada da UI embarcada
+inline constexpr std::string_view SCHEME = "app";
+inline constexpr std::string_view ENTRY_URL = "app://ui/index.html";
+
+// Asset servido pelo ResourceServer. `data` aponta para memória que vive
+// mais que o servidor (ex: .rodata), então nenhuma cópia é feita ao servir.
+// Conteúdo dinâmico (ex: blobs) mantém `data`/`etag`/`mime` vivos por
+// `owner`, que segue na Response até o engine terminar de ler.
+struct Asset {
+    std::string_view path;
+    std::string_view data;
+    std::string_view etag;
+    std::string_view mime{}; // vazio = pela extensão do path
+    bool immutable = false;  // endereçado por conteúdo: cache para sempre
+    std::shared_ptr<const void> owner{};
+};
+
+using AssetLookup = std::function<std::optional<Asset>(std::string_view)>;
+
+struct Request {
+    std::string_view method = "GET";
+    std::string_view path;
+    std::string_view range;
+    std::string_view if_none_match;
+    std::string_view body; // POST (WebKitGTK >= 2.40)
+};
+
+struct Response {
+    int status = 200;
+    std::string_view mime;
+    std::string_view body;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::shared_ptr<const void> owner; // mantém `body` vivo (Asset::owner)
+};
+
+// Endpoint dinâmico consultado antes dos assets (ex: canal binário). nullopt
+// = não é com ele, segue para os assets.
+using DynamicHandler =
+    std::function<std::optional<Response>(const Request &, std::string_view)>;
+
+struct ServerOptions {
+    // Envia COOP/COEP/CORP em todas as respostas: a página fica
+    // crossOriginIsolated e libera SharedArrayBuffer/Atomics.wait.
+    bool cross_origin_isolated = false;
+    DynamicHandler dynamic;
+};
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+[[nodiscard]] inline std::string_view mime_type_for(std::string_view path) {
+    struct Entry {
+        std::string_view ext;
+        std::string_view mime;
+    };
+    static constexpr Entry table[] = {
+        {".html", "text/html; charset=utf-8"},
+        {".js", "text/javascript; charset=utf-8"},
+        {".mjs", "text/javascript; charset=utf-8"},
+        {".css", "text/css; charset=utf-8"},
+        {".json", "application/json"},
+        {".map", "application/json"},
+        {".svg", "image/svg+xml"},
+        {".png", "image/png"},
+        {".jpg", "image/jpeg"},
+        {".jpeg", "image/jpeg"},
+        {".gif", "image/gif"},
+        {".webp", "image/webp"},
+        {".ico", "image/x-icon"},
+        {".woff", "font/woff"},
+        {".woff2", "font/woff2"},
+        {".ttf", "font/ttf"},
+        {".wasm", "application/wasm"},
+        {".txt", "text/plain; charset=utf-8"},
+    };
+
+    const auto dot = path.rfind('.');
+    if (dot == std::string_view::npos) {
+        return "application/octet-stream";
+    }
+    const std::string_view ext = path.substr(dot);
+    for (const auto &entry : table) {
+        if (entry.ext == ext) {
+            return entry.mime;
+        }
+    }
+    return "application/octet-stream";
+}
+
+// ETag forte baseado em FNV-1a 64 bits (estável entre builds iguais)
+[[nodiscard]] inline std::string make_etag(std::string_view data) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string out = "\"";
+    for (int shift = 60; shift >= 0; shift -= 4) {
+        out.push_back(digits[(hash >> shift) & 0xFU]);
+    }
+    out.push_back('"');
+    return out;
+}
+
+// Normaliza o path da requisição: remove query/fragment, mapeia "/" para
+// "/index.html" e rejeita travessia de diretório.
+[[nodiscard]] inline std::optional<std::string>
+normalize_path(std::string_view raw) {
+    const auto cut = raw.find_first_of("?#");
+    if (cut != std::string_view::npos) {
+        raw = raw.substr(0, cut);
+    }
+    if (raw.empty() || raw == "/") {
+        return std::string("/index.html");
+    }
+    if (raw.find("..") != std::string_view::npos) {
+        return std::nullopt;
+    }
+    std::string path;
+    if (raw.front() != '/') {
+        path.push_back('/');
+    }
+    path.append(raw);
+    return path;
+}
+
+struct ByteRange {
+    std::size_t first = 0;
+    std::size_t last = 0; // inclusivo
+};
+
+enum class RangeKind { None, Satisfiable, Unsatisfiable };
+
+struct RangeResult {
+    RangeKind kind = RangeKind::None;
+    ByteRange range;
+};
+
+// Suporta um único intervalo "bytes=a-b", "bytes=a-" ou "bytes=-n".
+// Múltiplos intervalos e sintaxe inválida são ignorados (resposta 200
+// completa), como permitido pela RFC 9110.
+[[nodiscard]] inline RangeResult parse_range(std::string_view header,
+                                             std::size_t size) {
+    constexpr std::string_view prefix = "bytes=";
+    if (header.substr(0, prefix.size()) != prefix) {
+        return {};
+    }
+    header.remove_prefix(prefix.size());
+    if (header.find(',') != std::string_view::npos) {
+        return {};
+    }
+    const auto dash = header.find('-');
+    if (dash == std::string_view::npos) {
+        return {};
+    }
+
+    auto parse_number = [](std::string_view text,
+                           std::size_t &out) -> bool {
+        if (text.empty()) {
+            return false;
+        }
+        const auto *end = text.data() + text.size();
+        auto [ptr, ec] = std::from_chars(text.data(), end, out);
+        return ec == std::errc() && ptr == end;
+    };
+
+    const std::string_view first_text = header.substr(0, dash);
+    const std::string_view last_text = header.substr(dash + 1);
+
+    if (first_text.empty()) {
+        // Sufixo: últimos n bytes
+        std::size_t suffix = 0;
+        if (!parse_number(last_text, suffix)) {
+            return {};
+        }
+        if (suffix == 0 || size == 0) {
+            return {RangeKind::Unsatisfiable, {}};
+        }
+        suffix = std::min(suffix, size);
+        return {RangeKind::Satisfiable, {size - suffix, size - 1}};
+    }
+
+    std::size_t first = 0;
+    if (!parse_number(first_text, first)) {
+        return {};
+    }
+    std::size_t last = size == 0 ? 0 : size - 1;
+    if (!last_text.empty()) {
+        if (!parse_number(last_text, last) || last < first) {
+            return {};
+        }
+    }
+    if (first >= size) {
+        return {RangeKind::Unsatisfiable, {}};
+    }
+    return {RangeKind::Satisfiable, {first, std::min(last, size - 1)}};
+}
+
+// =============================================================================
+// ResourceServer
+// =============================================================================
+
+class ResourceServer {
+  public:
+    explicit ResourceServer(AssetLookup lookup, ServerOptions options = {})
+        : lookup_(std::move(lookup)), options_(options) {}
+
+    [[nodiscard]] Response serve(const Request &request) const {
+        Response response;
+        const auto path = normalize_path(request.path);
+        bool handled = false;
+        if (path && options_.dynamic) {
+            if (auto dynamic = options_.dynamic(request, *path)) {
+                response = std::move(*dynamic);
+                handled = true;
+            }
+        }
+        if (options_.cross_origin_isolated) {
+            // Também em erros: o documento precisa dos headers, e
+            // subrecursos precisam de CORP para passar pelo require-corp.
+            response.headers.emplace_back("Cross-Origin-Opener-Policy",
+                                          "same-origin");
+            response.headers.emplace_back("Cross-Origin-Embedder-Policy",
+                                          "require-corp");
+            response.headers.emplace_back("Cross-Origin-Resource-Policy",
+                                          "same-origin");
+        }
+        if (handled) {
+            return response;
+        }
+        if (request.method != "GET" && request.method != "HEAD") {
+            response.status = 405;
+            response.headers.emplace_back("Allow", "GET, HEAD");
+            return response;
+        }
+
+        const auto asset =
+            path && lookup_ ? lookup_(*path) : std::optional<Asset>{};
+        if (!asset) {
+            response.status = 404;
+            response.mime = "text/plain; charset=utf-8";
+            return response;
+        }
+
+        response.owner = asset->owner;
+        response.mime =
+            asset->mime.empty() ? mime_type_for(*path) : asset->mime;
+        response.headers.emplace_back("Cache-Control",
+                                      asset->immutable ? IMMUTABLE_CACHE
+                                                       : cache_control(*path));
+        response.headers.emplace_back("Accept-Ranges", "bytes");
+        if (!asset->etag.empty()) {
+            response.headers.emplace_back("ETag", std::string(asset->etag));
+            if (etag_matches(request.if_none_match, asset->etag)) {
+                response.status = 304;
+                return response;
+            }
+        }
+
+        const std::size_t size = asset->data.size();
+        const RangeResult range = parse_range(request.range, size);
+        if (range.kind == RangeKind::Unsatisfiable) {
+            response.status = 416;
+            response.headers.emplace_back("Content-Range",
+                                          "bytes */" + std::to_string(size));
+            return response;
+        }
+
+        std::string_view body = asset->data;
+        if (range.kind == RangeKind::Satisfiable) {
+            const std::size_t length = range.range.last - range.range.first + 1;
+            body = body.substr(range.range.first, length);
+            response.status = 206;
+            response.headers.emplace_back(
+                "Content-Range", "bytes " + std::to_string(range.range.first) +
+                                     "-" + std::to_string(range.range.last) +
+                                     "/" + std::to_string(size));
+        }
+        response.headers.emplace_back("Content-Length",
+                                      std::to_string(body.size()));
+        if (request.method != "HEAD") {
+            response.body = body;
+        }
+        return response;
+    }
+
+  private:
+    // Assets do Vite em /assets/ têm hash no nome: podem ser imutáveis.
+    // O resto (index.html) precisa revalidar via ETag.
+    static constexpr const char *IMMUTABLE_CACHE =
+        "public, max-age=31536000, immutable";
+
+    static std::string cache_control(std::string_view path) {
+        if (path.substr(0, 8) == "/assets/") {
+            return IMMUTABLE_CACHE;
+        }
+        return "no-cache";
+    }
+
+    static bool etag_matches(std::string_view header, std::string_view etag) {
+        if (header.empty()) {
+            return false;
+        }
+        if (header == "*") {
+            return true;
+        }
+        return header.find(etag) != std::string_view::npos;
+    }
+
+    AssetLookup lookup_;
+    ServerOptions options_;
+};
+
+} // namespace app::resources
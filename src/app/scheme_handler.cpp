@@ -0,0 +1,192 @@
+#include "app/scheme_handler.h"
+#include <memory>
+#include <string>
+
+#if defined(__linux__)
+#include <gtk/gtk.h>
+#if GTK_MAJOR_VERSION >= 4
+#include <webkit/webkit.h>
+#else
+#include <webkit2/webkit2.h>
+#endif
+#endif
+
+namespace app {
+namespace {
+
+#if defined(__linux__)
+
+// Servidor compartilhado por todas as janelas (um único WebKitWebContext)
+std::shared_ptr<const resources::ResourceServer> &shared_server() {
+    static std::shared_ptr<const resources::ResourceServer> server;
+    return server;
+}
+
+std::string_view header_or_empty(const char *value) {
+    return value ? std::string_view(value) : std::string_view();
+}
+
+void finish_with_error(WebKitURISchemeRequest *request, int status) {
+    GError *error =
+        g_error_new(G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                    "app:// request failed with status %d", status);
+    webkit_uri_scheme_request_finish_error(request, error);
+    g_error_free(error);
+}
+
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+// Corpo do POST (canal binário). O WebKit já o tem em memória: a leitura
+// não bloqueia a UI.
+bool read_request_body(WebKitURISchemeRequest *request, std::string &out) {
+    GInputStream *input = webkit_uri_scheme_request_get_http_body(request);
+    if (!input) {
+        return true;
+    }
+    char buffer[64 * 1024];
+    for (;;) {
+        const gssize n = g_input_stream_read(input, buffer, sizeof(buffer),
+                                             nullptr, nullptr);
+        if (n < 0) {
+            return false;
+        }
+        if (n == 0) {
+            return true;
+        }
+        out.append(buffer, static_cast<std::size_t>(n));
+    }
+}
+#endif
+
+void on_scheme_request(WebKitURISchemeRequest *request, gpointer) {
+    const auto &server = shared_server();
+    if (!server) {
+        finish_with_error(request, 503);
+        return;
+    }
+
+    resources::Request req;
+    req.path = header_or_empty(webkit_uri_scheme_request_get_path(request));
+#if WEBKIT_CHECK_VERSION(2, 36, 0)
+    req.method =
+        header_or_empty(webkit_uri_scheme_request_get_http_method(request));
+    if (req.method.empty()) {
+        req.method = "GET";
+    }
+    if (auto *headers = webkit_uri_scheme_request_get_http_headers(request)) {
+        req.range =
+            header_or_empty(soup_message_headers_get_one(headers, "Range"));
+        req.if_none_match = header_or_empty(
+            soup_message_headers_get_one(headers, "If-None-Match"));
+    }
+#endif
+    std::string body;
+    if (req.method == "POST") {
+#if WEBKIT_CHECK_VERSION(2, 40, 0)
+        if (!read_request_body(request, body)) {
+            finish_with_error(request, 400);
+            return;
+        }
+        req.body = body;
+#else
+        // Sem acesso ao corpo: o JS cai para o bridge
+        finish_with_error(request, 501);
+        return;
+#endif
+    }
+
+    const resources::Response res = server->serve(req);
+
+    // Stream sem cópia: os dados vivem em .rodata (ou no cache do servidor);
+    // conteúdo dinâmico (blobs) fica vivo pelo owner até o WebKit soltar
+    GInputStream *stream = nullptr;
+    if (res.owner) {
+        GBytes *bytes = g_bytes_new_with_free_func(
+            res.body.data(), res.body.size(),
+            [](gpointer owner) {
+                delete static_cast<std::shared_ptr<const void> *>(owner);
+            },
+            new std::shared_ptr<const void>(res.owner));
+        stream = g_memory_input_stream_new_from_bytes(bytes);
+        g_bytes_unref(bytes);
+    } else {
+        stream = g_memory_input_stream_new_from_data(
+            res.body.data(), static_cast<gssize>(res.body.size()), nullptr);
+    }
+
+#if WEBKIT_CHECK_VERSION(2, 36, 0)
+    WebKitURISchemeResponse *response = webkit_uri_scheme_response_new(
+        stream, static_cast<gint64>(res.body.size()));
+    webkit_uri_scheme_response_set_status(
+        response, static_cast<guint>(res.status), nullptr);
+    if (!res.mime.empty()) {
+        const std::string mime(res.mime);
+        webkit_uri_scheme_response_set_content_type(response, mime.c_str());
+    }
+    SoupMessageHeaders *headers =
+        soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+    for (const auto &[name, value] : res.headers) {
+        soup_message_headers_append(headers, name.c_str(), value.c_str());
+    }
+    webkit_uri_scheme_response_set_http_headers(response, headers);
+    webkit_uri_scheme_request_finish_with_response(request, response);
+    g_object_unref(response);
+#else
+    // WebKitGTK antigo: sem status/headers, só corpo + MIME
+    if (res.status >= 400) {
+        finish_with_error(request, res.status);
+    } else {
+        const std::string mime(res.mime);
+        webkit_uri_scheme_request_finish(
+            request, stream, static_cast<gint64>(res.body.size()),
+            mime.empty() ? nullptr : mime.c_str());
+    }
+#endif
+    g_object_unref(stream);
+}
+
+#endif
+
+} // namespace
+
+bool register_resource_scheme(
+    void *browser_controller,
+    std::shared_ptr<const resources::ResourceServer> server) {
+#if defined(__linux__)
+    static bool registered = false;
+    if (registered) {
+        return true;
+    }
+    if (!browser_controller || !server) {
+        return false;
+    }
+
+    WebKitWebContext *context =
+        webkit_web_view_get_context(WEBKIT_WEB_VIEW(browser_controller));
+    if (!context) {
+        return false;
+    }
+
+    shared_server() = std::move(server);
+    const std::string scheme(resources::SCHEME);
+    webkit_web_context_register_uri_scheme(context, scheme.c_str(),
+                                           on_scheme_request, nullptr, nullptr);
+
+    // Contexto seguro (necessário para APIs como crypto.subtle/workers) e
+    // fetch() com CORS a partir de outras origens (ex: dev server).
+    WebKitSecurityManager *security =
+        webkit_web_context_get_security_manager(context);
+    webkit_security_manager_register_uri_scheme_as_secure(security,
+                                                          scheme.c_str());
+    webkit_security_manager_register_uri_scheme_as_cors_enabled(
+        security, scheme.c_str());
+
+    registered = true;
+    return true;
+#else
+    (void)browser_controller;
+    (void)server;
+    return false;
+#endif
+}
+
+} // namespace app
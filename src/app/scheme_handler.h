@@ -0,0 +1,23 @@
+#pragma once
+// =============================================================================
+// Scheme handler - registra app:// no engine nativo (código nativo no .cpp)
+// =============================================================================
+
+#include "app/resource_server.h"
+#include <memory>
+
+namespace app {
+
+// Registra o esquema app:// no contexto WebKit da webview informada
+// (`browser_controller` = webview::webview::browser_controller()). O registro
+// é feito uma única vez por processo: depois do primeiro sucesso, as
+// chamadas seguintes retornam true sem registrar de novo (e ignoram o
+// `server` passado). Uma falha não fica guardada; a próxima chamada tenta
+// outra vez. Retorna false quando a plataforma não suporta esquemas
+// customizados ou o contexto não está disponível: o chamador deve cair
+// para set_html.
+bool register_resource_scheme(
+    void *browser_controller,
+    std::shared_ptr<const resources::ResourceServer> server);
+
+} // namespace app
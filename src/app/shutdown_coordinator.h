@@ -0,0 +1,242 @@
+#pragma once
+// =============================================================================
+// ShutdownCoordinator - Encerramento em fases com prazo
+// =============================================================================
+// Lógica pura (sem GTK). A Application registra as fases em ordem; cada uma
+// tem um `begin` (opcional) e um `done` (opcional) consultado a cada step()
+// até retornar true ou o orçamento da fase/prazo total estourar. step() é
+// chamado de um timer no main loop enquanto ele roda (ex: esperar os acks
+// das janelas) e run() conduz o restante depois que o loop termina. Estourar
+// o prazo não trava o encerramento: a fase é encerrada e marcada no
+// relatório, com a duração de cada uma.
+//
+// CallGate conta as chamadas de binding em andamento e, uma vez fechado,
+// recusa novas.
+// =============================================================================
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+class CallGate {
+  public:
+    // RAII: mantém a chamada contada enquanto vive. Vazio se o gate fechou.
+    class Ticket {
+      public:
+        Ticket() = default;
+        explicit Ticket(CallGate *gate) : gate_(gate) {}
+        Ticket(Ticket &&other) noexcept
+            : gate_(std::exchange(other.gate_, nullptr)) {}
+        Ticket &operator=(Ticket &&other) noexcept {
+            if (this != &other) {
+                release();
+                gate_ = std::exchange(other.gate_, nullptr);
+            }
+            return *this;
+        }
+        Ticket(const Ticket &) = delete;
+        Ticket &operator=(const Ticket &) = delete;
+        ~Ticket() { release(); }
+
+        explicit operator bool() const { return gate_ != nullptr; }
+
+      private:
+        void release() {
+            if (gate_) {
+                gate_->leave();
+                gate_ = nullptr;
+            }
+        }
+
+        CallGate *gate_ = nullptr;
+    };
+
+    [[nodiscard]] Ticket try_enter() {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (closed_) {
+            return {};
+        }
+        ++in_flight_;
+        return Ticket(this);
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mu_);
+        closed_ = true;
+    }
+
+    [[nodiscard]] bool closed() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        return closed_;
+    }
+
+    [[nodiscard]] std::size_t in_flight() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        return in_flight_;
+    }
+
+    // Espera as chamadas em andamento terminarem. false se o prazo venceu.
+    bool wait_idle(std::chrono::steady_clock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(mu_);
+        return idle_.wait_until(lock, deadline,
+                                [this] { return in_flight_ == 0; });
+    }
+
+  private:
+    void leave() {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (--in_flight_ == 0) {
+            idle_.notify_all();
+        }
+    }
+
+    mutable std::mutex mu_;
+    std::condition_variable idle_;
+    std::size_t in_flight_ = 0;
+    bool closed_ = false;
+};
+
+struct ShutdownPhase {
+    std::string name;
+    std::function<void()> begin{}; // roda uma vez ao entrar na fase
+    std::function<bool()> done{};  // nulo = fase termina no begin
+    // 0 = limitada só pelo prazo total
+    std::chrono::milliseconds budget{0};
+};
+
+struct ShutdownPhaseReport {
+    std::string name;
+    std::chrono::microseconds duration{0};
+    bool timed_out = false;
+};
+
+class ShutdownCoordinator {
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Now = std::function<Clock::time_point()>;
+
+    // `now` permite relógio falso nos testes
+    explicit ShutdownCoordinator(
+        std::chrono::milliseconds deadline,
+        Now now = [] { return Clock::now(); })
+        : deadline_budget_(deadline), now_(std::move(now)) {}
+
+    void set_deadline(std::chrono::milliseconds deadline) {
+        deadline_budget_ = deadline;
+    }
+
+    // Fases podem ser acrescentadas depois de um step() que terminou (ex: as
+    // que só fazem sentido depois que o main loop saiu).
+    void add_phase(ShutdownPhase phase) { phases_.push_back(std::move(phase)); }
+
+    [[nodiscard]] bool started() const { return started_; }
+    [[nodiscard]] bool finished() const { return current_ == phases_.size(); }
+
+    // Avança o quanto der sem bloquear. true quando todas as fases acabaram.
+    bool step() {
+        if (!started_) {
+            started_ = true;
+            deadline_ = now_() + deadline_budget_;
+        }
+        while (current_ < phases_.size()) {
+            ShutdownPhase &phase = phases_[current_];
+            if (!phase_started_) {
+                phase_started_ = true;
+                phase_start_ = now_();
+                if (phase.begin) {
+                    phase.begin();
+                }
+            }
+            if (!phase.done || phase.done()) {
+                finish_phase(false);
+                continue;
+            }
+            if (now_() >= phase_deadline()) {
+                finish_phase(true);
+                continue;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    // Conduz as fases restantes bloqueando a thread atual
+    void run(std::chrono::milliseconds poll = std::chrono::milliseconds(1)) {
+        while (!step()) {
+            std::this_thread::sleep_for(poll);
+        }
+    }
+
+    [[nodiscard]] const std::vector<ShutdownPhaseReport> &report() const {
+        return report_;
+    }
+
+    // "stop-calls 0.1ms, persist-state 12.0ms (timeout) | total 12.1ms"
+    [[nodiscard]] std::string summary() const {
+        std::string out;
+        std::chrono::microseconds total{0};
+        for (const auto &phase : report_) {
+            if (!out.empty()) {
+                out += ", ";
+            }
+            out += phase.name;
+            out += ' ';
+            out += format_ms(phase.duration);
+            if (phase.timed_out) {
+                out += " (timeout)";
+            }
+            total += phase.duration;
+        }
+        out += " | total ";
+        out += format_ms(total);
+        return out;
+    }
+
+  private:
+    Clock::time_point phase_deadline() const {
+        const ShutdownPhase &phase = phases_[current_];
+        if (phase.budget.count() > 0 &&
+            phase_start_ + phase.budget < deadline_) {
+            return phase_start_ + phase.budget;
+        }
+        return deadline_;
+    }
+
+    void finish_phase(bool timed_out) {
+        report_.push_back(
+            {phases_[current_].name,
+             std::chrono::duration_cast<std::chrono::microseconds>(
+                 now_() - phase_start_),
+             timed_out});
+        ++current_;
+        phase_started_ = false;
+    }
+
+    static std::string format_ms(std::chrono::microseconds value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.1fms",
+                      static_cast<double>(value.count()) / 1000.0);
+        return buffer;
+    }
+
+    std::chrono::milliseconds deadline_budget_;
+    Now now_;
+    std::vector<ShutdownPhase> phases_;
+    std::vector<ShutdownPhaseReport> report_;
+    std::size_t current_ = 0;
+    bool started_ = false;
+    bool phase_started_ = false;
+    Clock::time_point deadline_;
+    Clock::time_point phase_start_;
+};
+
+} // namespace app
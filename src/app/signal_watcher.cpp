@@ -0,0 +1,161 @@
+#include "app/signal_watcher.h"
+#include <atomic>
+#include <csignal>
+
+#if defined(__linux__)
+#include <glib-unix.h>
+#include <pthread.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+#elif !defined(_WIN32)
+#include <pthread.h>
+#include <thread>
+#endif
+
+namespace app {
+
+struct SignalWatcher::State {
+    Callback on_signal;
+    std::atomic<int> received{0};
+#if defined(__linux__)
+    sigset_t mask{};
+    int fd = -1;
+    guint source = 0;
+#elif !defined(_WIN32)
+    sigset_t mask{};
+    std::atomic<bool> stopping{false};
+    std::thread waiter;
+#endif
+};
+
+namespace {
+
+#if !defined(_WIN32)
+void force_default_action(int signal) {
+    std::signal(signal, SIG_DFL);
+    sigset_t only{};
+    sigemptyset(&only);
+    sigaddset(&only, signal);
+    pthread_sigmask(SIG_UNBLOCK, &only, nullptr);
+    raise(signal);
+}
+#endif
+
+void deliver(SignalWatcher::State &state, int signal) {
+    if (state.received.fetch_add(1) == 0) {
+        if (state.on_signal) {
+            state.on_signal(signal);
+        }
+        return;
+    }
+#if !defined(_WIN32)
+    force_default_action(signal);
+#endif
+}
+
+#if defined(__linux__)
+gboolean on_signalfd(gint fd, GIOCondition, gpointer data) {
+    auto *state = static_cast<SignalWatcher::State *>(data);
+    signalfd_siginfo info{};
+    while (read(fd, &info, sizeof(info)) == sizeof(info)) {
+        deliver(*state, static_cast<int>(info.ssi_signo));
+    }
+    return G_SOURCE_CONTINUE;
+}
+#elif defined(_WIN32)
+// O CRT do Windows executa o handler de SIGINT/SIGBREAK numa thread nova
+// e restaura SIG_DFL antes de chamá-lo.
+std::atomic<SignalWatcher::State *> g_state{nullptr};
+
+void on_console_signal(int signal) {
+    if (auto *state = g_state.load()) {
+        deliver(*state, signal);
+    }
+}
+#endif
+
+} // namespace
+
+SignalWatcher::SignalWatcher() = default;
+
+SignalWatcher::~SignalWatcher() { stop(); }
+
+bool SignalWatcher::start(Callback on_signal) {
+    stop();
+    state_ = std::make_unique<State>();
+    state_->on_signal = std::move(on_signal);
+
+#if defined(__linux__)
+    sigemptyset(&state_->mask);
+    sigaddset(&state_->mask, SIGINT);
+    sigaddset(&state_->mask, SIGTERM);
+    if (pthread_sigmask(SIG_BLOCK, &state_->mask, nullptr) != 0) {
+        state_.reset();
+        return false;
+    }
+    state_->fd = signalfd(-1, &state_->mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (state_->fd < 0) {
+        pthread_sigmask(SIG_UNBLOCK, &state_->mask, nullptr);
+        state_.reset();
+        return false;
+    }
+    state_->source =
+        g_unix_fd_add(state_->fd, G_IO_IN, on_signalfd, state_.get());
+    return true;
+#elif defined(_WIN32)
+    g_state.store(state_.get());
+    std::signal(SIGINT, on_console_signal);
+    std::signal(SIGTERM, on_console_signal);
+    std::signal(SIGBREAK, on_console_signal);
+    return true;
+#else
+    sigemptyset(&state_->mask);
+    sigaddset(&state_->mask, SIGINT);
+    sigaddset(&state_->mask, SIGTERM);
+    if (pthread_sigmask(SIG_BLOCK, &state_->mask, nullptr) != 0) {
+        state_.reset();
+        return false;
+    }
+    state_->waiter = std::thread([state = state_.get()] {
+        int signal = 0;
+        while (sigwait(&state->mask, &signal) == 0) {
+            if (state->stopping.load()) {
+                return;
+            }
+            deliver(*state, signal);
+        }
+    });
+    return true;
+#endif
+}
+
+void SignalWatcher::stop() {
+    if (!state_) {
+        return;
+    }
+#if defined(__linux__)
+    if (state_->source != 0) {
+        g_source_remove(state_->source);
+    }
+    if (state_->fd >= 0) {
+        close(state_->fd);
+    }
+    pthread_sigmask(SIG_UNBLOCK, &state_->mask, nullptr);
+#elif defined(_WIN32)
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    std::signal(SIGBREAK, SIG_DFL);
+    g_state.store(nullptr);
+#else
+    // Acorda o sigwait() com um sinal do próprio conjunto
+    state_->stopping.store(true);
+    if (state_->waiter.joinable()) {
+        pthread_kill(state_->waiter.native_handle(), SIGTERM);
+        state_->waiter.join();
+    }
+    pthread_sigmask(SIG_UNBLOCK, &state_->mask, nullptr);
+#endif
+    state_.reset();
+}
+
+} // namespace app
@@ -0,0 +1,40 @@
+#pragma once
+// =============================================================================
+// SignalWatcher - SIGINT/SIGTERM entregues como eventos (código nativo no .cpp)
+// =============================================================================
+// Linux: os sinais ficam bloqueados e chegam por um signalfd registrado como
+// fonte no main loop GLib - o callback roda na thread da UI, sem thread
+// extra nem polling. Outros POSIX: uma thread parada em sigwait() (zero
+// wakeups). Windows: o handler de console já roda numa thread própria.
+//
+// O primeiro sinal chama o callback; um segundo restaura a ação padrão e
+// encerra o processo (Ctrl+C duplo força a saída se o shutdown travar).
+// =============================================================================
+
+#include <functional>
+#include <memory>
+
+namespace app {
+
+class SignalWatcher {
+  public:
+    using Callback = std::function<void(int signal)>;
+
+    SignalWatcher();
+    ~SignalWatcher();
+
+    SignalWatcher(const SignalWatcher &) = delete;
+    SignalWatcher &operator=(const SignalWatcher &) = delete;
+
+    // Deve ser chamado antes de criar threads: no POSIX a máscara de sinais
+    // bloqueados é herdada, garantindo que nenhuma outra thread os receba.
+    bool start(Callback on_signal);
+    void stop();
+
+    struct State; // definido no .cpp
+
+  private:
+    std::unique_ptr<State> state_;
+};
+
+} // namespace app
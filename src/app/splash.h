@@ -0,0 +1,58 @@
+#pragma once
+// =============================================================================
+// Splash - Páginas nativas (dev server subindo, UI indisponível)
+// =============================================================================
+// HTML autocontido (sem rede, sem JS): a janela aparece já com a webview
+// criada e navega para o dev server assim que ele sinaliza prontidão.
+// UI_UNAVAILABLE_HTML substitui a UI embarcada quando ela não tem como
+// carregar (build com code splitting sem o esquema app://).
+// =============================================================================
+
+#include <string_view>
+
+namespace app::splash {
+
+inline constexpr std::string_view DEV_SERVER_HTML = R"html(<!doctype html>
+<html>
+<head>
+<meta charset="utf-8">
+<style>
+  html, body { height: 100%; margin: 0; }
+  body {
+    display: flex; align-items: center; justify-content: center;
+    gap: 12px; background: #1e1f22; color: #9da0a6;
+    font: 13px system-ui, sans-serif;
+  }
+  .spinner {
+    width: 14px; height: 14px; border-radius: 50%;
+    border: 2px solid #3b3d42; border-top-color: #9da0a6;
+    animation: spin 0.8s linear infinite;
+  }
+  @keyframes spin { to { transform: rotate(360deg); } }
+</style>
+</head>
+<body><div class="spinner"></div>Iniciando dev server...</body>
+</html>)html";
+
+inline constexpr std::string_view UI_UNAVAILABLE_HTML = R"html(<!doctype html>
+<html>
+<head>
+<meta charset="utf-8">
+<style>
+  html, body { height: 100%; margin: 0; }
+  body {
+    display: flex; flex-direction: column; align-items: center;
+    justify-content: center; gap: 8px; background: #1e1f22;
+    color: #9da0a6; font: 13px system-ui, sans-serif;
+  }
+  h1 { margin: 0; font-size: 15px; color: #e06c75; }
+</style>
+</head>
+<body>
+<h1>Não foi possível carregar a interface</h1>
+<div>O esquema app:// não pôde ser registrado nesta webview.</div>
+<div>Veja o log da aplicação para detalhes.</div>
+</body>
+</html>)html";
+
+} // namespace app::splash
@@ -0,0 +1,119 @@
+#include "app/stack_sampler.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <csignal>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <pthread.h>
+#endif
+
+namespace app {
+
+#if defined(__linux__) || defined(__APPLE__)
+
+namespace {
+
+constexpr int MAX_FRAMES = 48;
+// handler + trampolim do sinal
+constexpr int SKIPPED_FRAMES = 2;
+
+void *g_frames[MAX_FRAMES];
+std::atomic<int> g_depth{-1};
+std::atomic<bool> g_installed{false};
+pthread_t g_target;
+std::mutex g_sample_mu;
+
+void on_sample_signal(int) {
+    const int depth = backtrace(g_frames, MAX_FRAMES);
+    g_depth.store(depth, std::memory_order_release);
+}
+
+// "binario(_ZN3app3fooEv+0x1f) [0x...]" -> "binario(app::foo()+0x1f) ..."
+std::string demangle_frame(const char *symbol) {
+    std::string line(symbol);
+    const auto open = line.find('(');
+    const auto plus = line.find('+', open);
+    if (open == std::string::npos || plus == std::string::npos ||
+        plus == open + 1) {
+        return line;
+    }
+    const std::string mangled = line.substr(open + 1, plus - open - 1);
+    int status = 0;
+    char *name =
+        abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+    if (status == 0 && name) {
+        line.replace(open + 1, mangled.size(), name);
+    }
+    std::free(name);
+    return line;
+}
+
+} // namespace
+
+bool install_stack_sampler() {
+    // A primeira chamada de backtrace() pode alocar (carrega o unwinder);
+    // fazê-la aqui deixa o handler livre disso
+    void *warmup[1];
+    backtrace(warmup, 1);
+
+    struct sigaction action{};
+    action.sa_handler = on_sample_signal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGURG, &action, nullptr) != 0) {
+        return false;
+    }
+    g_target = pthread_self();
+    g_installed.store(true, std::memory_order_release);
+    return true;
+}
+
+std::vector<std::string>
+sample_target_stack(std::chrono::milliseconds timeout) {
+    std::vector<std::string> stack;
+    if (!g_installed.load(std::memory_order_acquire)) {
+        return stack;
+    }
+    std::lock_guard<std::mutex> lock(g_sample_mu);
+    g_depth.store(-1, std::memory_order_relaxed);
+    if (pthread_kill(g_target, SIGURG) != 0) {
+        return stack;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    int depth = -1;
+    while ((depth = g_depth.load(std::memory_order_acquire)) < 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return stack;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    if (depth <= SKIPPED_FRAMES) {
+        return stack;
+    }
+    char **symbols = backtrace_symbols(g_frames + SKIPPED_FRAMES,
+                                       depth - SKIPPED_FRAMES);
+    if (!symbols) {
+        return stack;
+    }
+    for (int i = 0; i < depth - SKIPPED_FRAMES; ++i) {
+        stack.push_back(demangle_frame(symbols[i]));
+    }
+    std::free(symbols);
+    return stack;
+}
+
+#else
+
+bool install_stack_sampler() { return false; }
+
+std::vector<std::string> sample_target_stack(std::chrono::milliseconds) {
+    return {};
+}
+
+#endif
+
+} // namespace app
@@ -0,0 +1,27 @@
+#pragma once
+// =============================================================================
+// Stack sampler - Amostra a pilha de outra thread (código nativo no .cpp)
+// =============================================================================
+// Linux/macOS: a thread alvo recebe SIGURG (ignorado por padrão, então um
+// sinal perdido não derruba o processo) e o handler grava os endereços com
+// backtrace(); quem pediu a amostra simboliza fora do handler. Nomes de
+// funções do executável exigem símbolos exportados (ENABLE_EXPORTS no
+// CMake). Demais plataformas: sem amostra.
+// =============================================================================
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace app {
+
+// Registra a thread atual como alvo das amostras. false se a plataforma não
+// suporta.
+bool install_stack_sampler();
+
+// Pilha da thread registrada, do frame mais interno para fora. Vazia se não
+// houver alvo ou se a thread não responder dentro de `timeout`.
+std::vector<std::string>
+sample_target_stack(std::chrono::milliseconds timeout);
+
+} // namespace app
@@ -0,0 +1,257 @@
+#pragma once
+// =============================================================================
+// StallWatchdog - Detecta travamentos do main loop e aponta o culpado
+// =============================================================================
+// Todas as janelas dividem o mesmo main loop: um handler lento, um eval
+// grande ou a criação síncrona de uma janela congelam tudo. Um timer na
+// thread da UI bate o heartbeat(); a thread do watchdog acorda a cada
+// `poll` e, se o último batimento passou do limite, registra a tarefa
+// nativa em execução (TaskScope) e uma amostra da pilha da thread da UI.
+// Quando o loop volta a bater, o relatório ganha a duração total.
+//
+// As janelas reportam gaps de requestAnimationFrame (record_frame_gap); um
+// gap que coincide com um travamento nativo herda a tarefa dele.
+// =============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+namespace watchdog {
+
+// Tarefa nativa em execução na thread da UI (nome estável: literal ou
+// trace::intern). Escrita só pela thread da UI, lida pelo watchdog.
+inline std::atomic<const char *> current_task{nullptr};
+
+// RAII: marca a tarefa e restaura a anterior (tarefas aninhadas, ex: um
+// binding chamado dentro de um dispatch)
+class TaskScope {
+  public:
+    explicit TaskScope(const char *name)
+        : previous_(current_task.exchange(name, std::memory_order_relaxed)) {}
+    TaskScope(const TaskScope &) = delete;
+    TaskScope &operator=(const TaskScope &) = delete;
+    ~TaskScope() { current_task.store(previous_, std::memory_order_relaxed); }
+
+  private:
+    const char *previous_;
+};
+
+} // namespace watchdog
+
+struct StallReport {
+    std::string task; // vazio = nenhuma tarefa instrumentada em execução
+    std::chrono::steady_clock::time_point begin;
+    std::chrono::milliseconds duration{0}; // até agora, se `ongoing`
+    bool ongoing = true;
+    std::vector<std::string> stack; // amostra no momento da detecção
+};
+
+struct FrameGap {
+    std::string window_id;
+    double gap_ms = 0;
+    std::chrono::steady_clock::time_point at;
+    std::string task; // do travamento nativo sobreposto, se houver
+};
+
+class StallWatchdog {
+  public:
+    using Clock = std::chrono::steady_clock;
+    // Pilha da thread da UI, chamada da thread do watchdog
+    using StackSampler = std::function<std::vector<std::string>()>;
+    // Detecção (ongoing) e fim de cada travamento; roda na thread do
+    // watchdog e na da UI, respectivamente
+    using Listener = std::function<void(const StallReport &)>;
+
+    static constexpr std::size_t MAX_REPORTS = 32;
+
+    explicit StallWatchdog(std::chrono::milliseconds threshold)
+        : threshold_(threshold), origin_(Clock::now()) {}
+    ~StallWatchdog() { stop(); }
+
+    StallWatchdog(const StallWatchdog &) = delete;
+    StallWatchdog &operator=(const StallWatchdog &) = delete;
+
+    [[nodiscard]] std::chrono::milliseconds threshold() const {
+        return threshold_;
+    }
+    void set_threshold(std::chrono::milliseconds threshold) {
+        threshold_ = threshold;
+    }
+    void set_stack_sampler(StackSampler sampler) {
+        sampler_ = std::move(sampler);
+    }
+    void set_listener(Listener listener) { listener_ = std::move(listener); }
+
+    // Thread da UI, a cada tick do timer do main loop
+    void heartbeat(Clock::time_point now = Clock::now()) {
+        last_beat_.store(now.time_since_epoch().count(),
+                         std::memory_order_relaxed);
+        std::optional<StallReport> finished;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if (stalled_) {
+                stalled_ = false;
+                StallReport &report = stalls_.back();
+                report.ongoing = false;
+                report.duration = to_ms(now - report.begin);
+                finished = report;
+            }
+        }
+        if (finished && listener_) {
+            listener_(*finished);
+        }
+    }
+
+    // Thread do watchdog. true quando um novo travamento foi registrado.
+    bool check(Clock::time_point now = Clock::now()) {
+        const Clock::time_point beat{
+            Clock::duration(last_beat_.load(std::memory_order_relaxed))};
+        if (beat == Clock::time_point{} || now - beat <= threshold_) {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if (stalled_) {
+                stalls_.back().duration = to_ms(now - beat);
+                return false;
+            }
+        }
+
+        StallReport report;
+        const char *task =
+            watchdog::current_task.load(std::memory_order_relaxed);
+        report.task = task ? task : "";
+        report.begin = beat;
+        report.duration = to_ms(now - beat);
+        if (sampler_) {
+            report.stack = sampler_();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            stalled_ = true;
+            stalls_.push_back(report);
+            while (stalls_.size() > MAX_REPORTS) {
+                stalls_.pop_front();
+            }
+        }
+        if (listener_) {
+            listener_(report);
+        }
+        return true;
+    }
+
+    void record_frame_gap(std::string window_id, double gap_ms,
+                          Clock::time_point now = Clock::now()) {
+        FrameGap gap{std::move(window_id), gap_ms, now, {}};
+        const auto gap_begin =
+            now - std::chrono::duration_cast<Clock::duration>(
+                      std::chrono::duration<double, std::milli>(gap_ms));
+        std::lock_guard<std::mutex> lock(mu_);
+        for (auto it = stalls_.rbegin(); it != stalls_.rend(); ++it) {
+            const auto end = it->ongoing ? now : it->begin + it->duration;
+            if (it->begin <= now && end >= gap_begin) {
+                gap.task = it->task;
+                break;
+            }
+        }
+        frame_gaps_.push_back(std::move(gap));
+        while (frame_gaps_.size() > MAX_REPORTS) {
+            frame_gaps_.pop_front();
+        }
+    }
+
+    [[nodiscard]] std::vector<StallReport> stalls() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        return {stalls_.begin(), stalls_.end()};
+    }
+
+    [[nodiscard]] std::vector<FrameGap> frame_gaps() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        return {frame_gaps_.begin(), frame_gaps_.end()};
+    }
+
+    // Tempos em ms relativos à criação do watchdog
+    [[nodiscard]] nlohmann::json to_json() const {
+        nlohmann::json stalls = nlohmann::json::array();
+        for (const auto &report : this->stalls()) {
+            stalls.push_back({{"task", report.task},
+                              {"atMs", since_origin_ms(report.begin)},
+                              {"durationMs", report.duration.count()},
+                              {"ongoing", report.ongoing},
+                              {"stack", report.stack}});
+        }
+        nlohmann::json gaps = nlohmann::json::array();
+        for (const auto &gap : frame_gaps()) {
+            gaps.push_back({{"windowId", gap.window_id},
+                            {"gapMs", gap.gap_ms},
+                            {"atMs", since_origin_ms(gap.at)},
+                            {"task", gap.task}});
+        }
+        return {{"thresholdMs", threshold_.count()},
+                {"stalls", std::move(stalls)},
+                {"frameGaps", std::move(gaps)}};
+    }
+
+    // Thread de vigia; o primeiro heartbeat() arma a detecção
+    void start(std::chrono::milliseconds poll) {
+        if (thread_.joinable()) {
+            return;
+        }
+        thread_ = std::jthread([this, poll](std::stop_token stop) {
+            std::mutex wait_mu;
+            std::condition_variable_any wake;
+            std::unique_lock<std::mutex> lock(wait_mu);
+            while (!stop.stop_requested()) {
+                // Só acorda antes do `poll` no stop
+                wake.wait_for(lock, stop, poll, [] { return false; });
+                if (!stop.stop_requested()) {
+                    check();
+                }
+            }
+        });
+    }
+
+    void stop() {
+        if (thread_.joinable()) {
+            thread_.request_stop();
+            thread_.join();
+        }
+    }
+
+  private:
+    static std::chrono::milliseconds to_ms(Clock::duration value) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(value);
+    }
+
+    [[nodiscard]] long long since_origin_ms(Clock::time_point at) const {
+        return to_ms(at - origin_).count();
+    }
+
+    std::chrono::milliseconds threshold_;
+    Clock::time_point origin_;
+    StackSampler sampler_;
+    Listener listener_;
+    std::atomic<Clock::rep> last_beat_{0};
+    mutable std::mutex mu_;
+    bool stalled_ = false;
+    std::deque<StallReport> stalls_;
+    std::deque<FrameGap> frame_gaps_;
+    std::jthread thread_;
+};
+
+} // namespace app
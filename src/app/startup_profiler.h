@@ -0,0 +1,162 @@
+#pragma once
+// =============================================================================
+// StartupProfiler - Onde vai o tempo do cold start (--profile-startup)
+// =============================================================================
+// Registra spans e marcos com timestamps monotônicos relativos à criação do
+// profiler. Desabilitado, cada chamada é um teste de bool. Habilitado, usa
+// um mutex: são algumas dezenas de eventos por execução, vindos da thread
+// da UI, da thread do dev server e dos marcos reportados pelo JS.
+// =============================================================================
+
+#include "app/chrome_trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+class StartupProfiler {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // Trilhas (tid no trace)
+    enum Track : std::uint32_t { Main = 1, DevServer = 2, Js = 3 };
+
+    struct Entry {
+        std::string name;
+        Track track = Main;
+        Clock::duration start{};
+        Clock::duration duration{}; // zero = marco
+        bool instant = false;
+        nlohmann::json args;
+    };
+
+    // Span RAII; inerte se o profiler for nulo ou estiver desabilitado
+    class Scope {
+      public:
+        Scope(StartupProfiler *profiler, std::string name,
+              Track track = Main)
+            : profiler_(profiler && profiler->enabled() ? profiler : nullptr),
+              name_(std::move(name)), track_(track) {
+            if (profiler_) {
+                begin_ = Clock::now();
+            }
+        }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+        ~Scope() {
+            if (profiler_) {
+                profiler_->span(std::move(name_), begin_, Clock::now(),
+                                track_);
+            }
+        }
+
+      private:
+        StartupProfiler *profiler_;
+        std::string name_;
+        Track track_;
+        Clock::time_point begin_;
+    };
+
+    explicit StartupProfiler(bool enabled = false,
+                             Clock::time_point origin = Clock::now())
+        : enabled_(enabled), origin_(origin) {}
+
+    [[nodiscard]] bool enabled() const { return enabled_; }
+    [[nodiscard]] Clock::time_point origin() const { return origin_; }
+
+    void span(std::string name, Clock::time_point begin,
+              Clock::time_point end, Track track = Main,
+              nlohmann::json args = nullptr) {
+        if (!enabled_) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mu_);
+        entries_.push_back({std::move(name), track, begin - origin_,
+                            end - begin, false, std::move(args)});
+    }
+
+    void mark(std::string name, Track track = Main,
+              nlohmann::json args = nullptr) {
+        if (!enabled_) {
+            return;
+        }
+        const auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(mu_);
+        entries_.push_back({std::move(name), track, now - origin_,
+                            Clock::duration::zero(), true, std::move(args)});
+    }
+
+    [[nodiscard]] std::vector<Entry> entries() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        std::vector<Entry> sorted = entries_;
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [](const Entry &a, const Entry &b) {
+                             return a.start < b.start;
+                         });
+        return sorted;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        return entries_.size();
+    }
+
+    // Tabela "início / duração / fase" em ms, ordenada pelo início
+    [[nodiscard]] std::string breakdown() const {
+        std::string out = "    início(ms)  duração(ms)  fase\n";
+        char line[64];
+        for (const auto &entry : entries()) {
+            std::snprintf(line, sizeof(line), "  %12.1f", to_ms(entry.start));
+            out += line;
+            if (entry.instant) {
+                out += "            -  ";
+            } else {
+                std::snprintf(line, sizeof(line), "  %11.1f  ",
+                              to_ms(entry.duration));
+                out += line;
+            }
+            out += entry.name;
+            out += '\n';
+        }
+        return out;
+    }
+
+    [[nodiscard]] std::vector<trace::ChromeEvent> chrome_events() const {
+        std::vector<trace::ChromeEvent> events;
+        for (auto &entry : entries()) {
+            events.push_back({std::move(entry.name), "startup",
+                              entry.instant ? 'i' : 'X', to_us(entry.start),
+                              to_us(entry.duration),
+                              static_cast<std::uint32_t>(entry.track),
+                              std::move(entry.args)});
+        }
+        return events;
+    }
+
+    [[nodiscard]] static trace::ThreadNames thread_names() {
+        return {{Main, "ui"}, {DevServer, "dev-server"}, {Js, "js"}};
+    }
+
+  private:
+    static double to_ms(Clock::duration value) {
+        return std::chrono::duration<double, std::milli>(value).count();
+    }
+    static std::int64_t to_us(Clock::duration value) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(value)
+            .count();
+    }
+
+    bool enabled_;
+    Clock::time_point origin_;
+    mutable std::mutex mu_;
+    std::vector<Entry> entries_;
+};
+
+} // namespace app
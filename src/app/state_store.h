@@ -0,0 +1,378 @@
+#pragma once
+// =============================================================================
+// StateStore - Estado chave/valor compartilhado entre janelas, por deltas
+// =============================================================================
+// Lógica pura (sem GTK). O processo nativo é a única autoridade: toda
+// escrita passa por set/patch/erase, ganha uma versão global monotônica e
+// vira um delta JSON Patch (RFC 6902) relativo ao valor anterior da chave:
+// set calcula o diff (json_patch.h, com o hash estrutural do valor guardado
+// em cache), patch repassa o do escritor, que já o fez contra uma versão
+// conhecida (sem mandar o documento inteiro pelo bridge). As janelas
+// assinam prefixos de chave: subscribe devolve o snapshot do prefixo e,
+// dali em diante, cada escrita numa chave assinada chega como evento
+// `state.delta` só com o patch:
+//
+//   {"type":"state.delta","version":V,"key":"...","base":B,"patch":[...]}
+//
+// `base` é a versão anterior da chave (0 = não existia): se o valor local
+// da janela não está em `base`, ela perdeu deltas e pede since(versão),
+// que devolve o log de patches desde então. Só quando o log já descartou
+// esse trecho (LOG_CAPACITY / LOG_MAX_BYTES) a resposta é um snapshot.
+// Remoção: "deleted":true e patch vazio.
+//
+// O sink é chamado com o lock do store travado, para cada janela receber
+// os deltas na ordem das versões: só enfileira, nunca volta ao store.
+// =============================================================================
+
+#include "app/json_patch.h"
+#include "app/metrics.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+class StateStore {
+  public:
+    using json = nlohmann::json;
+    // Entrega um evento já serializado à janela
+    using Sink = std::function<void(const std::string &window_id,
+                                    std::string event)>;
+
+    static constexpr std::size_t LOG_CAPACITY = 1024;
+    static constexpr std::size_t LOG_MAX_BYTES = 8 * 1024 * 1024;
+
+    struct Stats {
+        std::uint64_t version = 0;
+        std::size_t keys = 0;
+        std::size_t subscribers = 0;
+        std::size_t log_entries = 0;
+        std::size_t log_bytes = 0;
+        std::uint64_t deltas_sent = 0;
+        std::uint64_t resyncs = 0;
+    };
+
+    StateStore()
+        : keys_gauge_(metrics::registry().gauge("state_keys")),
+          delta_bytes_(metrics::registry().counter("state_delta_bytes")) {}
+
+    StateStore(const StateStore &) = delete;
+    StateStore &operator=(const StateStore &) = delete;
+
+    void set_sink(Sink sink) {
+        std::lock_guard<std::mutex> lock(mu_);
+        sink_ = std::move(sink);
+    }
+
+    // Grava o valor inteiro; o delta é o diff contra o anterior. Retorna a
+    // versão da chave (a atual, se o valor não mudou).
+    std::uint64_t set(const std::string &key, json value) {
+        StructuralHash hashes(value); // fora do lock: percorre o valor todo
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = entries_.find(key);
+        json patch;
+        if (it == entries_.end()) {
+            patch = json_diff(json(), StructuralHash(json()), value, hashes);
+            it = entries_.emplace(key, Entry{}).first;
+        } else {
+            Entry &entry = it->second;
+            if (!entry.hashes) {
+                entry.hashes.emplace(entry.value);
+            }
+            if (entry.hashes->root() == hashes.root()) {
+                return entry.version;
+            }
+            patch = json_diff(entry.value, *entry.hashes, value, hashes);
+        }
+        it->second.value = std::move(value);
+        it->second.hashes = std::move(hashes);
+        publish_locked(key, it->second, patch, false);
+        keys_gauge_.set(static_cast<std::int64_t>(entries_.size()));
+        return it->second.version;
+    }
+
+    // Aplica o patch do escritor, feito contra a versão `base` da chave (0 =
+    // não existe), e o repassa como delta. nullopt = a chave já saiu de
+    // `base` (outra escrita chegou antes); JsonPatchError = o patch não se
+    // aplica, nada muda.
+    std::optional<std::uint64_t> patch(const std::string &key,
+                                       std::uint64_t base, const json &ops) {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = entries_.find(key);
+        const std::uint64_t current =
+            it == entries_.end() ? 0 : it->second.version;
+        if (base != current) {
+            return std::nullopt;
+        }
+        if (!ops.is_array()) {
+            throw JsonPatchError("Patch must be an array");
+        }
+        if (ops.empty()) {
+            return current;
+        }
+        if (it == entries_.end()) {
+            json value;
+            apply_json_patch(value, ops);
+            it = entries_.emplace(key, Entry{}).first;
+            it->second.value = std::move(value);
+        } else {
+            apply_json_patch(it->second.value, ops);
+            it->second.hashes.reset(); // recalculado no próximo set
+        }
+        publish_locked(key, it->second, ops, false);
+        keys_gauge_.set(static_cast<std::int64_t>(entries_.size()));
+        return it->second.version;
+    }
+
+    // Versão da remoção; 0 se a chave não existia
+    std::uint64_t erase(const std::string &key) {
+        std::lock_guard<std::mutex> lock(mu_);
+        const auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            return 0;
+        }
+        Entry entry = std::move(it->second);
+        entries_.erase(it);
+        publish_locked(key, entry, json::array(), true);
+        keys_gauge_.set(static_cast<std::int64_t>(entries_.size()));
+        return entry.version;
+    }
+
+    // Remove as chaves do prefixo (ex: as de uma janela fechada), cada uma
+    // com seu delta de remoção. Retorna quantas saíram.
+    std::size_t erase_prefix(const std::string &prefix) {
+        std::lock_guard<std::mutex> lock(mu_);
+        std::size_t erased = 0;
+        auto it = entries_.lower_bound(prefix);
+        while (it != entries_.end() && matches(it->first, prefix)) {
+            const std::string key = it->first;
+            Entry entry = std::move(it->second);
+            it = entries_.erase(it);
+            publish_locked(key, entry, json::array(), true);
+            ++erased;
+        }
+        keys_gauge_.set(static_cast<std::int64_t>(entries_.size()));
+        return erased;
+    }
+
+    // Assina o prefixo ("" = tudo) e devolve o snapshot dele, atômico com
+    // a assinatura: nenhuma escrita cai entre os dois
+    [[nodiscard]] std::string subscribe(const std::string &window_id,
+                                        const std::string &prefix) {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto &prefixes = subscribers_[window_id];
+        bool known = false;
+        for (const auto &p : prefixes) {
+            known = known || p == prefix;
+        }
+        if (!known) {
+            prefixes.push_back(prefix);
+        }
+        return snapshot_locked(prefix, false);
+    }
+
+    bool unsubscribe(const std::string &window_id, const std::string &prefix) {
+        std::lock_guard<std::mutex> lock(mu_);
+        const auto it = subscribers_.find(window_id);
+        if (it == subscribers_.end()) {
+            return false;
+        }
+        auto &prefixes = it->second;
+        const auto before = prefixes.size();
+        std::erase(prefixes, prefix);
+        const bool removed = prefixes.size() != before;
+        if (prefixes.empty()) {
+            subscribers_.erase(it);
+        }
+        return removed;
+    }
+
+    // Janela fechada: some das assinaturas
+    void remove_window(const std::string &window_id) {
+        std::lock_guard<std::mutex> lock(mu_);
+        subscribers_.erase(window_id);
+    }
+
+    // Cópia do valor atual da chave
+    [[nodiscard]] std::optional<json> get(const std::string &key) const {
+        std::lock_guard<std::mutex> lock(mu_);
+        const auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            return std::nullopt;
+        }
+        return it->second.value;
+    }
+
+    [[nodiscard]] std::string snapshot(const std::string &prefix) const {
+        std::lock_guard<std::mutex> lock(mu_);
+        return snapshot_locked(prefix, false);
+    }
+
+    // Deltas do prefixo com versão > `version`, na ordem:
+    //   {"version":V,"deltas":[{"version":..,"key":..,"base":..,...}]}
+    // Se o log não cobre mais esse trecho, o snapshot do prefixo com
+    // "resync":true.
+    [[nodiscard]] std::string since(std::uint64_t version,
+                                    const std::string &prefix) {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (version < log_floor_ || version > version_) {
+            ++stats_.resyncs;
+            return snapshot_locked(prefix, true);
+        }
+        std::string out = R"({"version":)";
+        out += std::to_string(version_);
+        out += R"(,"deltas":[)";
+        bool first = true;
+        for (const auto &delta : log_) {
+            if (delta.version <= version ||
+                !matches(delta.key, prefix)) {
+                continue;
+            }
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            out += *delta.text;
+        }
+        out += "]}";
+        return out;
+    }
+
+    [[nodiscard]] std::uint64_t version() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        return version_;
+    }
+
+    [[nodiscard]] Stats stats() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        Stats out = stats_;
+        out.version = version_;
+        out.keys = entries_.size();
+        out.subscribers = subscribers_.size();
+        out.log_entries = log_.size();
+        out.log_bytes = log_bytes_;
+        return out;
+    }
+
+  private:
+    struct Entry {
+        json value;
+        std::uint64_t version = 0;
+        // Hash estrutural de `value`; vazio depois de um patch
+        std::optional<StructuralHash> hashes;
+    };
+
+    struct Delta {
+        std::uint64_t version;
+        std::string key;
+        // {"version":..,"key":..,"base":..,"patch":..}: vai igual para o
+        // log, o since e (com o type) os eventos
+        std::shared_ptr<const std::string> text;
+    };
+
+    static bool matches(std::string_view key, std::string_view prefix) {
+        return key.substr(0, prefix.size()) == prefix;
+    }
+
+    // mu_ travado: nova versão, entrada no log e eventos para as janelas
+    // que assinam a chave
+    void publish_locked(const std::string &key, Entry &entry,
+                        const json &patch, bool deleted) {
+        const std::uint64_t base = entry.version;
+        entry.version = ++version_;
+
+        std::string text = R"({"version":)";
+        text += std::to_string(entry.version);
+        text += R"(,"key":)";
+        text += json(key).dump();
+        text += R"(,"base":)";
+        text += std::to_string(base);
+        if (deleted) {
+            text += R"(,"deleted":true)";
+        }
+        text += R"(,"patch":)";
+        text += patch.dump();
+        text += '}';
+        auto shared = std::make_shared<const std::string>(std::move(text));
+
+        log_bytes_ += shared->size();
+        log_.push_back({entry.version, key, shared});
+        while (log_.size() > LOG_CAPACITY ||
+               (log_bytes_ > LOG_MAX_BYTES && log_.size() > 1)) {
+            log_floor_ = log_.front().version;
+            log_bytes_ -= log_.front().text->size();
+            log_.pop_front();
+        }
+
+        if (!sink_) {
+            return;
+        }
+        for (const auto &[window_id, prefixes] : subscribers_) {
+            bool wanted = false;
+            for (const auto &prefix : prefixes) {
+                wanted = wanted || matches(key, prefix);
+            }
+            if (!wanted) {
+                continue;
+            }
+            std::string event = R"({"type":"state.delta",)";
+            event.append(*shared, 1);
+            delta_bytes_.add(event.size());
+            ++stats_.deltas_sent;
+            sink_(window_id, std::move(event));
+        }
+    }
+
+    // {"version":V,["resync":true,]"entries":{"key":{"value":..,
+    // "version":..}}}
+    std::string snapshot_locked(const std::string &prefix,
+                                bool resync) const {
+        std::string out = R"({"version":)";
+        out += std::to_string(version_);
+        if (resync) {
+            out += R"(,"resync":true)";
+        }
+        out += R"(,"entries":{)";
+        bool first = true;
+        for (auto it = entries_.lower_bound(prefix);
+             it != entries_.end() && matches(it->first, prefix); ++it) {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            out += json(it->first).dump();
+            out += R"(:{"value":)";
+            out += it->second.value.dump();
+            out += R"(,"version":)";
+            out += std::to_string(it->second.version);
+            out += '}';
+        }
+        out += "}}";
+        return out;
+    }
+
+    metrics::Gauge &keys_gauge_;
+    metrics::Counter &delta_bytes_;
+    mutable std::mutex mu_;
+    Sink sink_;
+    std::uint64_t version_ = 0;
+    std::map<std::string, Entry, std::less<>> entries_;
+    std::map<std::string, std::vector<std::string>> subscribers_;
+    std::deque<Delta> log_;
+    std::size_t log_bytes_ = 0;
+    // Maior versão que já saiu do log: since() abaixo dela exige snapshot
+    std::uint64_t log_floor_ = 0;
+    Stats stats_;
+};
+
+} // namespace app
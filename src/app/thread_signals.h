@@ -0,0 +1,29 @@
+#pragma once
+// =============================================================================
+// Sinais nas threads internas
+// =============================================================================
+// SIGINT/SIGTERM chegam pelo SignalWatcher, que os bloqueia na thread da UI
+// (a máscara é herdada pelas threads criadas depois). Um sinal de processo
+// vai para qualquer thread que não o bloqueie: as que nascem antes do
+// SignalWatcher::start (pool do executor, escrita do log) receberiam o
+// sinal com a ação padrão e o processo morreria sem o shutdown em fases.
+// Elas bloqueiam tudo ao começar.
+// =============================================================================
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+namespace app {
+
+// Primeira instrução do corpo de uma thread interna
+inline void block_thread_signals() {
+#if !defined(_WIN32)
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, nullptr);
+#endif
+}
+
+} // namespace app
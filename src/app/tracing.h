@@ -0,0 +1,289 @@
+#pragma once
+// =============================================================================
+// Tracing - Spans e contadores de baixo custo, exportados como Chrome trace
+// =============================================================================
+// Cada thread grava num ring buffer próprio (um único produtor, sem locks);
+// o dump copia os anéis a partir de qualquer thread e descarta os slots que
+// o produtor sobrescreveu durante a cópia. Desligado (padrão), um span custa
+// um load relaxed e um branch. Ligado com --trace; dump sob demanda via
+// binding e no encerramento.
+//
+// Nomes e categorias são `const char *` que vivem até o fim do processo:
+// literais ou intern() (nomes de binding, marcas do JS).
+// =============================================================================
+
+#include "app/chrome_trace.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace app::trace {
+
+inline constexpr std::size_t RING_CAPACITY = 8192; // eventos por thread
+
+namespace detail {
+
+inline std::atomic<bool> enabled{false};
+
+inline std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Campos atômicos (relaxed): o dump lê slots que o produtor pode estar
+// reescrevendo; a validação pelo head descarta esses.
+struct Slot {
+    std::atomic<const char *> category{nullptr};
+    std::atomic<const char *> name{nullptr};
+    std::atomic<std::int64_t> ts_ns{0};
+    std::atomic<std::int64_t> value{0}; // duração ("X") ou valor ("C")
+    std::atomic<char> phase{0};
+};
+
+struct ThreadRing {
+    std::uint32_t tid = 0;
+    std::string name; // protegido pelo mutex do Registry
+    std::atomic<std::uint64_t> head{0};
+    std::array<Slot, RING_CAPACITY> slots;
+
+    void push(char phase, const char *category, const char *event_name,
+              std::int64_t ts, std::int64_t value) {
+        const std::uint64_t index = head.load(std::memory_order_relaxed);
+        Slot &slot = slots[index % RING_CAPACITY];
+        slot.category.store(category, std::memory_order_relaxed);
+        slot.name.store(event_name, std::memory_order_relaxed);
+        slot.ts_ns.store(ts, std::memory_order_relaxed);
+        slot.value.store(value, std::memory_order_relaxed);
+        slot.phase.store(phase, std::memory_order_relaxed);
+        head.store(index + 1, std::memory_order_release);
+    }
+};
+
+struct Registry {
+    std::mutex mu;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    std::uint32_t next_tid = 1;
+    std::unordered_set<std::string> interned;
+    std::int64_t origin_ns = now_ns();
+    // Eventos vindos do JS: trilha própria, gravada sob lock (baixa
+    // frequência, e não necessariamente da mesma thread)
+    std::mutex js_mu;
+    std::shared_ptr<ThreadRing> js_ring;
+};
+
+inline Registry &registry() {
+    static Registry instance;
+    return instance;
+}
+
+inline thread_local std::string thread_name;
+
+inline std::shared_ptr<ThreadRing> make_ring(std::string name) {
+    auto ring = std::make_shared<ThreadRing>();
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mu);
+    ring->tid = reg.next_tid++;
+    ring->name = std::move(name);
+    reg.rings.push_back(ring);
+    return ring;
+}
+
+// Alocado no primeiro evento da thread (nunca com o tracing desligado)
+inline std::shared_ptr<ThreadRing> &local_ring_slot() {
+    thread_local std::shared_ptr<ThreadRing> ring;
+    return ring;
+}
+
+inline ThreadRing &local_ring() {
+    auto &ring = local_ring_slot();
+    if (!ring) {
+        ring = make_ring(thread_name.empty() ? "thread" : thread_name);
+    }
+    return *ring;
+}
+
+} // namespace detail
+
+[[nodiscard]] inline bool enabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+inline void set_enabled(bool value) {
+    detail::enabled.store(value, std::memory_order_relaxed);
+}
+
+// Nome exibido na trilha da thread atual
+inline void set_thread_name(std::string name) {
+    detail::thread_name = name;
+    if (auto &ring = detail::local_ring_slot()) {
+        std::lock_guard<std::mutex> lock(detail::registry().mu);
+        ring->name = std::move(name);
+    }
+}
+
+// Cópia estável de `text` (vive até o fim do processo)
+[[nodiscard]] inline const char *intern(std::string_view text) {
+    detail::Registry &reg = detail::registry();
+    std::lock_guard<std::mutex> lock(reg.mu);
+    return reg.interned.emplace(text).first->c_str();
+}
+
+inline void complete(const char *category, const char *name,
+                     std::int64_t start_ns, std::int64_t duration_ns) {
+    if (enabled()) {
+        detail::local_ring().push('X', category, name, start_ns, duration_ns);
+    }
+}
+
+inline void counter(const char *category, const char *name,
+                    std::int64_t value) {
+    if (enabled()) {
+        detail::local_ring().push('C', category, name, detail::now_ns(),
+                                  value);
+    }
+}
+
+inline void instant(const char *category, const char *name) {
+    if (enabled()) {
+        detail::local_ring().push('i', category, name, detail::now_ns(), 0);
+    }
+}
+
+// Converte um instante em ms desde a epoch (performance.timeOrigin +
+// startTime no JS) para a base monotônica dos eventos
+[[nodiscard]] inline std::int64_t from_epoch_ms(double epoch_ms) {
+    const auto system_now =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    const auto epoch_ns = static_cast<std::int64_t>(epoch_ms * 1e6);
+    return detail::now_ns() - (system_now - epoch_ns);
+}
+
+// Evento do JS (performance.mark/measure) na trilha "js". duration_ns < 0
+// vira instante.
+inline void add_js_event(std::string_view name, std::int64_t start_ns,
+                         std::int64_t duration_ns) {
+    if (!enabled()) {
+        return;
+    }
+    const char *interned = intern(name);
+    detail::Registry &reg = detail::registry();
+    std::lock_guard<std::mutex> lock(reg.js_mu);
+    if (!reg.js_ring) {
+        reg.js_ring = detail::make_ring("js");
+    }
+    if (duration_ns < 0) {
+        reg.js_ring->push('i', "js", interned, start_ns, 0);
+    } else {
+        reg.js_ring->push('X', "js", interned, start_ns, duration_ns);
+    }
+}
+
+// Span RAII. Ex: APP_TRACE_SPAN("window", "create");
+class Span {
+  public:
+    Span(const char *category, const char *name) {
+        if (enabled()) {
+            category_ = category;
+            name_ = name;
+            start_ns_ = detail::now_ns();
+        }
+    }
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+    ~Span() {
+        if (name_) {
+            detail::local_ring().push('X', category_, name_, start_ns_,
+                                      detail::now_ns() - start_ns_);
+        }
+    }
+
+  private:
+    const char *category_ = nullptr;
+    const char *name_ = nullptr;
+    std::int64_t start_ns_ = 0;
+};
+
+#define APP_TRACE_CONCAT_INNER(a, b) a##b
+#define APP_TRACE_CONCAT(a, b) APP_TRACE_CONCAT_INNER(a, b)
+#define APP_TRACE_SPAN(category, name)                                         \
+    ::app::trace::Span APP_TRACE_CONCAT(_trace_span_, __LINE__)(category, name)
+
+// Copia os anéis de todas as threads. Pode rodar com produtores ativos.
+[[nodiscard]] inline std::vector<ChromeEvent>
+snapshot(ThreadNames *thread_names = nullptr) {
+    detail::Registry &reg = detail::registry();
+    std::vector<std::shared_ptr<detail::ThreadRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(reg.mu);
+        rings = reg.rings;
+        if (thread_names) {
+            for (const auto &ring : rings) {
+                thread_names->emplace_back(ring->tid, ring->name);
+            }
+        }
+    }
+
+    std::vector<ChromeEvent> events;
+    for (const auto &ring : rings) {
+        const std::uint64_t head = ring->head.load(std::memory_order_acquire);
+        const std::uint64_t first =
+            head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+        std::vector<ChromeEvent> copied;
+        copied.reserve(static_cast<std::size_t>(head - first));
+        for (std::uint64_t i = first; i < head; ++i) {
+            const detail::Slot &slot = ring->slots[i % RING_CAPACITY];
+            ChromeEvent event;
+            event.phase = slot.phase.load(std::memory_order_relaxed);
+            const char *category =
+                slot.category.load(std::memory_order_relaxed);
+            const char *name = slot.name.load(std::memory_order_relaxed);
+            event.category = category ? category : "";
+            event.name = name ? name : "";
+            const std::int64_t value =
+                slot.value.load(std::memory_order_relaxed);
+            event.ts_us =
+                (slot.ts_ns.load(std::memory_order_relaxed) - reg.origin_ns) /
+                1000;
+            if (event.phase == 'X') {
+                event.dur_us = value / 1000;
+            } else if (event.phase == 'C') {
+                event.args = {{"value", value}};
+            }
+            event.tid = ring->tid;
+            copied.push_back(std::move(event));
+        }
+        // Slots com índice < novo head + 1 - capacidade podem ter sido
+        // reescritos durante a cópia (o +1 cobre a escrita em andamento)
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t head_after =
+            ring->head.load(std::memory_order_relaxed);
+        const std::uint64_t valid_from = head_after + 1 > RING_CAPACITY
+                                             ? head_after + 1 - RING_CAPACITY
+                                             : 0;
+        const std::uint64_t skip = valid_from > first ? valid_from - first : 0;
+        for (std::size_t i = static_cast<std::size_t>(skip); i < copied.size();
+             ++i) {
+            events.push_back(std::move(copied[i]));
+        }
+    }
+    return events;
+}
+
+// Grava o conteúdo atual dos anéis. false se o arquivo não pôde ser escrito.
+inline bool dump(const std::string &path) {
+    ThreadNames names;
+    auto events = snapshot(&names);
+    return write_chrome_trace(path, events, names);
+}
+
+} // namespace app::trace
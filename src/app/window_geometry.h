@@ -0,0 +1,190 @@
+#pragma once
+// =============================================================================
+// WindowGeometryIndex - Retângulos das janelas com ordem de empilhamento
+// =============================================================================
+// Lógica pura (sem GTK): o WindowManager alimenta o índice a partir dos
+// eventos nativos (configure/foco/unmap) e o DragTracker consulta a cada
+// tick. Mudanças reconstroem uma decomposição em faixas verticais (slabs):
+// o hit test faz uma busca binária na faixa do x e percorre só as janelas
+// que a cobrem, já ordenadas do topo para o fundo. Sem alocações na
+// consulta.
+// =============================================================================
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+struct WindowPoint {
+    int x = 0;
+    int y = 0;
+
+    friend bool operator==(const WindowPoint &, const WindowPoint &) = default;
+};
+
+struct WindowRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    // Intervalo semiaberto: janelas adjacentes não disputam a borda
+    [[nodiscard]] bool contains(int px, int py) const {
+        return px >= x && px < x + width && py >= y && py < y + height;
+    }
+
+    [[nodiscard]] bool empty() const { return width <= 0 || height <= 0; }
+
+    friend bool operator==(const WindowRect &, const WindowRect &) = default;
+};
+
+class WindowGeometryIndex {
+  public:
+    struct Entry {
+        std::string id;
+        WindowRect rect;
+        std::uint64_t z = 0; // maior = mais ao topo
+    };
+
+    // Insere ou atualiza o retângulo. Retorna false se nada mudou.
+    bool update(std::string_view id, const WindowRect &rect) {
+        if (Entry *entry = find(id)) {
+            if (entry->rect == rect) {
+                return false;
+            }
+            entry->rect = rect;
+        } else {
+            entries_.push_back({std::string(id), rect, ++z_counter_});
+        }
+        rebuild();
+        return true;
+    }
+
+    // Traz a janela para o topo (foco/ativação)
+    bool raise(std::string_view id) {
+        Entry *entry = find(id);
+        if (!entry || entry->z == z_counter_) {
+            return false;
+        }
+        entry->z = ++z_counter_;
+        rebuild();
+        return true;
+    }
+
+    bool remove(std::string_view id) {
+        const auto it =
+            std::find_if(entries_.begin(), entries_.end(),
+                         [id](const Entry &entry) { return entry.id == id; });
+        if (it == entries_.end()) {
+            return false;
+        }
+        entries_.erase(it);
+        rebuild();
+        return true;
+    }
+
+    void clear() {
+        entries_.clear();
+        rebuild();
+    }
+
+    // Janela visível mais ao topo sob o ponto, ou nullptr
+    [[nodiscard]] const Entry *hit_test(int x, int y) const {
+        const auto edge = std::upper_bound(edges_.begin(), edges_.end(), x);
+        if (edge == edges_.begin() || edge == edges_.end()) {
+            return nullptr;
+        }
+        const auto slab = static_cast<std::size_t>(edge - edges_.begin()) - 1;
+        for (std::size_t i = slab_offsets_[slab]; i < slab_offsets_[slab + 1];
+             ++i) {
+            const Entry &entry = entries_[slab_items_[i]];
+            if (entry.rect.contains(x, y)) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] std::optional<WindowRect> bounds(std::string_view id) const {
+        for (const auto &entry : entries_) {
+            if (entry.id == id) {
+                return entry.rect;
+            }
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] const std::vector<Entry> &entries() const {
+        return entries_;
+    }
+    [[nodiscard]] std::uint64_t version() const { return version_; }
+
+  private:
+    Entry *find(std::string_view id) {
+        for (auto &entry : entries_) {
+            if (entry.id == id) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    // Reconstrói as faixas. Chamado só em mudanças de geometria/ordem (raras
+    // comparadas aos hit tests); poucas janelas, então O(n² log n) é ok.
+    void rebuild() {
+        ++version_;
+        edges_.clear();
+        slab_offsets_.clear();
+        slab_items_.clear();
+
+        for (const auto &entry : entries_) {
+            if (entry.rect.empty()) {
+                continue;
+            }
+            edges_.push_back(entry.rect.x);
+            edges_.push_back(entry.rect.x + entry.rect.width);
+        }
+        std::sort(edges_.begin(), edges_.end());
+        edges_.erase(std::unique(edges_.begin(), edges_.end()), edges_.end());
+
+        std::vector<std::uint32_t> by_z(entries_.size());
+        for (std::size_t i = 0; i < by_z.size(); ++i) {
+            by_z[i] = static_cast<std::uint32_t>(i);
+        }
+        std::sort(by_z.begin(), by_z.end(),
+                  [this](std::uint32_t a, std::uint32_t b) {
+                      return entries_[a].z > entries_[b].z;
+                  });
+
+        slab_offsets_.push_back(0);
+        for (std::size_t s = 0; s + 1 < edges_.size(); ++s) {
+            const int left = edges_[s];
+            for (const std::uint32_t index : by_z) {
+                const WindowRect &rect = entries_[index].rect;
+                if (!rect.empty() && rect.x <= left &&
+                    left < rect.x + rect.width) {
+                    slab_items_.push_back(index);
+                }
+            }
+            slab_offsets_.push_back(slab_items_.size());
+        }
+    }
+
+    std::vector<Entry> entries_;
+    std::uint64_t z_counter_ = 0;
+    std::uint64_t version_ = 0;
+
+    // Faixa s cobre [edges_[s], edges_[s+1]); seus itens (índices em
+    // entries_, topo primeiro) ficam em slab_items_[offsets[s]..offsets[s+1])
+    std::vector<int> edges_;
+    std::vector<std::size_t> slab_offsets_;
+    std::vector<std::uint32_t> slab_items_;
+};
+
+} // namespace app
@@ -3,33 +3,70 @@
 // WindowManager - Gerencia janelas nativas adicionais (multi-janela)
 // =============================================================================
 
+#include "app/bindings.h"
+#include "app/drag_events.h"
 #include "app/drag_tracker.h"
+#include "app/drop_zones.h"
+#include "app/event_channel.h"
+#include "app/executor.h"
+#include "app/log.h"
+#include "app/metrics.h"
+#include "app/stall_watchdog.h"
+#include "app/startup_profiler.h"
+#include "app/tracing.h"
 #include "app/window_platform.h"
 #include "webview/webview.h"
 #include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <functional>
-#include <iostream>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #if !defined(APP_DEV_MODE) && !defined(APP_NO_EMBEDDED_UI)
+#include "app/splash.h"
 #include "embedded_resources.h"
 #endif
 
+// 1 = o Vite gerou um index.html autocontido (plataformas sem app://)
+#ifndef APP_UI_SINGLEFILE
+#define APP_UI_SINGLEFILE 0
+#endif
+
 namespace app {
 
+#if !defined(APP_DEV_MODE) && !defined(APP_NO_EMBEDDED_UI)
+// Documento para set_html quando app:// não está disponível. O build com
+// code splitting referencia chunks em /assets que só o esquema resolve:
+// carregar esse index.html daria uma janela em branco sem erro, então a
+// janela mostra uma página de erro e o log diz o motivo.
+inline std::string embedded_fallback_html() {
+    if (APP_UI_SINGLEFILE) {
+        return embedded::index_html();
+    }
+    APP_LOG_ERROR("APP", "app:// indisponível e a UI embarcada depende dele "
+                         "(chunks em /assets); exibindo página de erro");
+    return std::string(splash::UI_UNAVAILABLE_HTML);
+}
+#endif
+
 class WindowManager {
   public:
     using json = nlohmann::json;
     using BindingsSetup = std::function<void(webview::webview &)>;
+    // Janela filha fechada (thread da UI), ex: cancelar os jobs dela
+    using ClosedListener = std::function<void(const std::string &window_id)>;
 
     WindowManager(webview::webview &main_window, bool dev_mode,
                   std::string dev_url, std::string custom_url,
@@ -40,16 +77,52 @@ class WindowManager {
           title_base_(std::move(title_base)), main_title_(title_base_),
           drag_tracker_(
               main_window_, [this]() { return collect_drag_windows(); },
+              [this](const DragCursor &cursor, std::string &out) {
+                  hit_test_window(cursor, out);
+              },
               [this](const std::string &hovered_id) {
                   on_drag_hover_change(hovered_id);
-              }) {}
+              }) {
+        drag_tracker_.set_move_callback([this](const std::string &hovered_id) {
+            on_drag_move(hovered_id);
+        });
+        auto handle = main_window_.window();
+        if (handle.ok()) {
+            track_window_geometry(main_window_id_, handle.value());
+        }
+    }
 
-    ~WindowManager() { stop_drag_tracking(); }
+    ~WindowManager() {
+        stop_drag_tracking();
+        // Espera o timer em curso; o que ele já despachou para a UI vê o
+        // token vencido e não toca no manager
+        cursor_flush_.cancel();
+        cursor_flush_.wait();
+        alive_.reset();
+        // Desconecta antes das janelas (a principal vive mais que o manager)
+        std::lock_guard<std::mutex> lock(geometry_mu_);
+        geometry_watches_.clear();
+    }
 
     void set_bindings_setup(BindingsSetup setup) {
         bindings_setup_ = std::move(setup);
     }
 
+    void set_closed_listener(ClosedListener listener) {
+        closed_listener_ = std::move(listener);
+    }
+
+    // URL da UI embarcada servida via app:// (vazio = usar set_html)
+    void set_embedded_url(std::string url) { embedded_url_ = std::move(url); }
+
+    // --profile-startup: fases da criação de cada janela filha
+    void set_startup_profiler(StartupProfiler *profiler) {
+        profiler_ = profiler;
+    }
+
+    // URL efetiva do Vite, conhecida só depois que ele sobe (thread da UI)
+    void set_dev_url(std::string url) { dev_url_ = std::move(url); }
+
     std::string create_window(json bootstrap) {
         if (!bootstrap.is_object()) {
             bootstrap = json::object();
@@ -98,25 +171,115 @@ class WindowManager {
     }
 
     bool post_event(const std::string &window_id, const json &event) {
-        const std::string payload = event.dump();
+        if (!event.is_object()) {
+            // Sem objeto não há onde pôr o seq: vai direto, fora do fluxo
+            return dispatch_event(window_id, event.dump());
+        }
+        std::string type;
+        const auto type_it = event.find("type");
+        if (type_it != event.end() && type_it->is_string()) {
+            type = type_it->get<std::string>();
+        }
+        return post_raw_event(window_id, event.dump(), type);
+    }
+
+    // Evento já serializado (objeto JSON válido): evita json intermediário.
+    // Passa pelo canal da janela (seq + créditos, ver event_channel.h);
+    // `type` vazio = lido do prefixo {"type":"...".
+    bool post_raw_event(const std::string &window_id, std::string event,
+                        std::string_view type = {}) {
+        APP_TRACE_SPAN("window", "post_event");
+        static metrics::Counter &posted =
+            metrics::registry().counter("window_events_posted");
+        posted.add();
+        auto channel = event_channel(window_id);
+        if (!channel) {
+            return false;
+        }
+        const std::string event_type(type.empty() ? raw_event_type(event)
+                                                  : type);
+        channel->push(event_type, event_policy(event_type), std::move(event));
+        return true;
+    }
+
+    // ackNativeEvents: o JS consumiu tudo até `seq` (0 = página recarregou)
+    bool ack_events(const std::string &window_id, std::uint64_t seq) {
+        std::shared_ptr<EventChannel> channel;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            auto it = channels_.find(window_id);
+            if (it == channels_.end()) {
+                return false;
+            }
+            channel = it->second;
+        }
+        channel->ack(seq);
+        return true;
+    }
+
+    // Créditos e fila de uma janela (getNativeEventStats)
+    json event_stats(const std::string &window_id) {
+        std::shared_ptr<EventChannel> channel;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            auto it = channels_.find(window_id);
+            if (it != channels_.end()) {
+                channel = it->second;
+            }
+        }
+        if (!channel) {
+            return nullptr;
+        }
+        const auto stats = channel->stats();
+        return {{"sent", stats.sent},           {"acked", stats.acked},
+                {"coalesced", stats.coalesced}, {"dropped", stats.dropped},
+                {"inFlight", stats.in_flight},  {"queued", stats.queued}};
+    }
+
+  private:
+    // Canal da janela, criado no primeiro evento; nulo se ela não existe
+    std::shared_ptr<EventChannel> event_channel(const std::string &window_id) {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = channels_.find(window_id);
+        if (it != channels_.end()) {
+            return it->second;
+        }
+        if (window_id != main_window_id_ &&
+            windows_.find(window_id) == windows_.end()) {
+            return nullptr;
+        }
+        auto channel = std::make_shared<EventChannel>(
+            [this, window_id](std::string event) {
+                dispatch_event(window_id, std::move(event));
+            });
+        channels_.emplace(window_id, channel);
+        return channel;
+    }
+
+    // Agenda o eval do evento na thread da UI
+    bool dispatch_event(const std::string &window_id,
+                        const std::string &event) {
+        std::string script =
+            "window.dispatchEvent(new CustomEvent('native-event', { detail: ";
+        script += event;
+        script += " }));";
+
         if (window_id == main_window_id_) {
-            main_window_.dispatch([this, payload] {
-                main_window_.eval("window.dispatchEvent(new "
-                                  "CustomEvent('native-event', { detail: " +
-                                  payload + " }));");
+            main_window_.dispatch([this, script = std::move(script)] {
+                APP_TRACE_SPAN("window", "eval_event");
+                const watchdog::TaskScope task("window.eval_event");
+                main_window_.eval(script);
             });
             return true;
         }
 
-        bool exists = false;
         {
             std::lock_guard<std::mutex> lock(mu_);
-            exists = windows_.find(window_id) != windows_.end();
-        }
-        if (!exists) {
-            return false;
+            if (windows_.find(window_id) == windows_.end()) {
+                return false;
+            }
         }
-        main_window_.dispatch([this, window_id, payload] {
+        main_window_.dispatch([this, window_id, script = std::move(script)] {
             webview::webview *target = nullptr;
             {
                 std::lock_guard<std::mutex> lock(mu_);
@@ -125,16 +288,16 @@ class WindowManager {
                     target = it->second.get();
                 }
             }
-            if (!target) {
-                return;
+            if (target) {
+                APP_TRACE_SPAN("window", "eval_event");
+                const watchdog::TaskScope task("window.eval_event");
+                target->eval(script);
             }
-            target->eval("window.dispatchEvent(new CustomEvent('native-event', "
-                         "{ detail: " +
-                         payload + " }));");
         });
         return true;
     }
 
+  public:
     bool close_window(const std::string &window_id) {
         bool exists = false;
         {
@@ -146,6 +309,8 @@ class WindowManager {
         }
 
         main_window_.dispatch([this, window_id] {
+            APP_TRACE_SPAN("window", "close");
+            const watchdog::TaskScope task("window.close");
             std::unique_ptr<webview::webview> window;
             bool removed = false;
             {
@@ -157,9 +322,19 @@ class WindowManager {
                 window = std::move(it->second);
                 windows_.erase(it);
                 window_info_.erase(window_id);
+                drop_targets_.erase(window_id);
+                channels_.erase(window_id);
                 removed = true;
+                trace::counter("window", "open_windows",
+                               static_cast<std::int64_t>(windows_.size()));
+                metrics::registry().gauge("windows_open").set(
+                    static_cast<std::int64_t>(windows_.size()));
             }
+            untrack_window_geometry(window_id);
             if (removed) {
+                if (closed_listener_) {
+                    closed_listener_(window_id);
+                }
                 emit_main_event({{"type", "native-window.closed"},
                                  {"windowId", window_id}});
             }
@@ -167,112 +342,208 @@ class WindowManager {
         return true;
     }
 
-    void start_drag_tracking(const std::string &origin_window_id,
-                             json drag_payload) {
+    // Encerramento: criações ainda na fila de dispatch passam a ser
+    // descartadas (o gate de bindings já impede novas)
+    void begin_shutdown() {
+        shutting_down_.store(true);
+        stop_drag_tracking();
+    }
+
+    // Destrói as janelas filhas na thread da UI, antes da principal. Saem
+    // do mapa sob o lock e são destruídas fora dele: destruir uma webview
+    // pode rodar callbacks que voltam ao manager.
+    std::size_t close_all_windows() {
+        begin_shutdown();
+        std::vector<std::pair<std::string, std::unique_ptr<webview::webview>>>
+            closing;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            closing.reserve(windows_.size());
+            for (auto &entry : windows_) {
+                closing.emplace_back(entry.first, std::move(entry.second));
+            }
+            windows_.clear();
+            window_info_.clear();
+            bootstraps_.clear();
+            drop_targets_.clear();
+            // Só os das filhas: a principal ainda recebe eventos
+            for (auto it = channels_.begin(); it != channels_.end();) {
+                it = it->first == main_window_id_ ? std::next(it)
+                                                  : channels_.erase(it);
+            }
+        }
+        for (auto &[window_id, window] : closing) {
+            // Desconecta os sinais de geometria antes do widget sumir
+            untrack_window_geometry(window_id);
+            window.reset();
+            if (closed_listener_) {
+                closed_listener_(window_id);
+            }
+        }
+        return closing.size();
+    }
+
+    // O payload é serializado uma única vez aqui e compartilhado (imutável)
+    // até o fim do drag. Retorna o id do drag (vai nos eventos dock.*).
+    std::uint64_t start_drag_tracking(const std::string &origin_window_id,
+                                      const json &drag_payload) {
+        drag::SharedPayload payload = drag::share_payload(drag_payload);
+        std::uint64_t drag_id = 0;
         {
             std::lock_guard<std::mutex> lock(mu_);
-            drag_payload_ = std::move(drag_payload);
+            drag_id = ++next_drag_id_;
+            drag_id_ = drag_id;
+            drag_payload_ = std::move(payload);
             drag_origin_id_ = origin_window_id;
             drag_hovered_id_ = origin_window_id;
         }
+        refresh_unwatched_geometry();
+        reset_drop_preview();
         drag_tracker_.start(origin_window_id);
+        return drag_id;
     }
 
-    json complete_drag_tracking(const std::string &target_window_id) {
-        json payload;
+    bindings::RawJson
+    complete_drag_tracking(const std::string &target_window_id) {
+        drag::SharedPayload payload;
+        std::uint64_t drag_id = 0;
         std::string origin_id;
         std::string hovered_id;
         {
             std::lock_guard<std::mutex> lock(mu_);
-            payload = drag_payload_;
-            origin_id = drag_origin_id_;
-            hovered_id = drag_hovered_id_;
-            drag_payload_ = json();
-            drag_origin_id_.clear();
-            drag_hovered_id_.clear();
+            payload = std::move(drag_payload_);
+            drag_id = drag_id_;
+            origin_id = std::move(drag_origin_id_);
+            hovered_id = std::move(drag_hovered_id_);
+            clear_drag_locked();
         }
 
         drag_tracker_.stop();
 
         if (!hovered_id.empty() && hovered_id != origin_id) {
-            post_event(hovered_id,
-                       {{"type", "dock.dragLeave"},
-                        {"payload", {{"originWindowId", origin_id}}}});
+            post_raw_event(hovered_id,
+                           drag::hover_event("dock.dragLeave", drag_id,
+                                             origin_id, hovered_id));
         }
 
-        if (!origin_id.empty() && !payload.is_null()) {
-            post_event(origin_id, {{"type", "dock.dragComplete"},
-                                   {"payload",
-                                    {{"originWindowId", origin_id},
-                                     {"targetWindowId", target_window_id},
-                                     {"dragPayload", payload}}}});
+        if (!origin_id.empty() && payload) {
+            post_raw_event(origin_id,
+                           drag::complete_event(drag_id, origin_id,
+                                                target_window_id, payload));
         }
 
-        return payload;
+        return {std::move(payload)};
     }
 
-    json complete_drag_outside(const std::string &origin_window_id) {
-        const std::string hovered_now =
-            drag_tracker_.current_hovered_id(collect_drag_windows());
+    bindings::RawJson
+    complete_drag_outside(const std::string &origin_window_id) {
+        const std::string hovered_now = drag_tracker_.current_hovered_id();
         const auto cursor = drag_tracker_.current_cursor_position();
-        json payload;
-        bool should_stop = false;
+        drag::SharedPayload payload;
+        std::uint64_t drag_id = 0;
         std::string origin_id;
         std::string previous_hovered;
         {
             std::lock_guard<std::mutex> lock(mu_);
-            origin_id = drag_origin_id_;
-            previous_hovered = drag_hovered_id_;
-            if (origin_id != origin_window_id) {
-                return json();
-            }
-            if (!hovered_now.empty()) {
-                return json();
-            }
-            if (drag_payload_.is_null()) {
-                return json();
+            if (drag_origin_id_ != origin_window_id || !hovered_now.empty() ||
+                !drag_payload_) {
+                return {};
             }
-            payload = drag_payload_;
-            drag_payload_ = json();
-            drag_origin_id_.clear();
-            drag_hovered_id_.clear();
-            should_stop = true;
-        }
-        if (should_stop) {
-            drag_tracker_.stop();
+            payload = std::move(drag_payload_);
+            drag_id = drag_id_;
+            origin_id = std::move(drag_origin_id_);
+            previous_hovered = std::move(drag_hovered_id_);
+            clear_drag_locked();
         }
+        drag_tracker_.stop();
         if (!previous_hovered.empty() && previous_hovered != origin_id) {
-            post_event(previous_hovered,
-                       {{"type", "dock.dragLeave"},
-                        {"payload", {{"originWindowId", origin_id}}}});
+            post_raw_event(previous_hovered,
+                           drag::hover_event("dock.dragLeave", drag_id,
+                                             origin_id, previous_hovered));
         }
-        json result = json::object();
-        result["payload"] = payload;
+
+        // {"payload": <texto compartilhado>, "drop": {...}}
+        std::string result;
+        result.reserve(payload->size() + 48);
+        result += R"({"payload":)";
+        result += *payload;
         if (cursor) {
-            result["drop"] = {{"x", cursor->x}, {"y", cursor->y}};
+            result += R"(,"drop":{"x":)" + std::to_string(cursor->x) +
+                      R"(,"y":)" + std::to_string(cursor->y) + "}";
         }
-        return result;
+        result += '}';
+        return {std::make_shared<const std::string>(std::move(result))};
     }
 
     void stop_drag_tracking() {
+        std::uint64_t drag_id = 0;
         std::string origin_id;
         std::string hovered_id;
         {
             std::lock_guard<std::mutex> lock(mu_);
-            origin_id = drag_origin_id_;
-            hovered_id = drag_hovered_id_;
-            drag_payload_ = json();
-            drag_origin_id_.clear();
-            drag_hovered_id_.clear();
+            drag_id = drag_id_;
+            origin_id = std::move(drag_origin_id_);
+            hovered_id = std::move(drag_hovered_id_);
+            clear_drag_locked();
         }
 
         drag_tracker_.stop();
 
         if (!hovered_id.empty() && hovered_id != origin_id) {
-            post_event(hovered_id,
-                       {{"type", "dock.dragLeave"},
-                        {"payload", {{"originWindowId", origin_id}}}});
+            post_raw_event(hovered_id,
+                           drag::hover_event("dock.dragLeave", drag_id,
+                                             origin_id, hovered_id));
+        }
+    }
+
+    // Retângulos dos grupos do dock da janela (px CSS, locais à janela):
+    // [{id, left, top, width, height}, ...]. Substitui o registro anterior.
+    void register_drop_targets(const std::string &window_id,
+                               const json &targets) {
+        std::vector<dock::DropTarget> parsed;
+        if (targets.is_array()) {
+            parsed.reserve(targets.size());
+            for (const auto &target : targets) {
+                if (!target.is_object() || !target.contains("id")) {
+                    continue;
+                }
+                auto coord = [&target](const char *key) {
+                    return static_cast<int>(
+                        std::lround(target.value(key, 0.0)));
+                };
+                parsed.push_back({target["id"].get<std::string>(),
+                                  {coord("left"), coord("top"), coord("width"),
+                                   coord("height")}});
+            }
         }
+        std::lock_guard<std::mutex> lock(mu_);
+        drop_targets_[window_id] = std::move(parsed);
+    }
+
+    // Retângulo da janela em coordenadas de tela (null se desconhecido)
+    json window_geometry(const std::string &window_id) {
+        std::optional<WindowRect> rect;
+        {
+            std::lock_guard<std::mutex> lock(geometry_mu_);
+            rect = geometry_.bounds(window_id);
+        }
+        if (!rect) {
+            // Sem eventos nativos (ou janela ainda não configurada)
+            void *handle = find_window_handle(window_id);
+            rect = handle ? get_window_bounds(handle) : std::nullopt;
+        }
+        return rect ? rect_to_json(*rect) : json();
+    }
+
+    // Medições do último drag (ticks, eventos de movimento, latência)
+    json drag_stats() const {
+        const DragStats stats = drag_tracker_.stats();
+        return {{"active", drag_tracker_.active()},
+                {"ticks", stats.ticks},
+                {"motionEvents", stats.motion_events},
+                {"hoverChanges", stats.hover_changes},
+                {"maxTickLatenessUs", stats.max_tick_lateness.count()},
+                {"maxHoverLatencyUs", stats.max_hover_latency.count()}};
     }
 
   private:
@@ -369,8 +640,9 @@ class WindowManager {
         }
 
         if (base.empty()) {
-            base = !custom_url_.empty() ? custom_url_
-                                        : (dev_mode_ ? dev_url_ : "");
+            base = !custom_url_.empty()
+                       ? custom_url_
+                       : (dev_mode_ ? dev_url_ : embedded_url_);
         }
         if (base.empty()) {
             return {};
@@ -399,17 +671,12 @@ class WindowManager {
 #elif defined(APP_NO_EMBEDDED_UI)
         window.set_html("<!doctype html><html><body></body></html>");
 #else
-        window.set_html(INDEX_HTML);
+        window.set_html(embedded_fallback_html());
 #endif
     }
 
     void emit_main_event(const json &detail) {
-        const std::string payload = detail.dump();
-        main_window_.dispatch([this, payload]() {
-            main_window_.eval("window.dispatchEvent(new CustomEvent("
-                              "'native-event', { detail: " +
-                              payload + " }));");
-        });
+        post_raw_event(main_window_id_, detail.dump());
     }
 
     void handle_window_creation_failure(const std::string &window_id,
@@ -420,17 +687,23 @@ class WindowManager {
             windows_.erase(window_id);
             window_info_.erase(window_id);
         }
-        std::cerr << "[WindowManager] Failed to create window '" << window_id
-                  << "': " << message << std::endl;
+        APP_LOG_ERROR("WindowManager", "Failed to create window '",
+                      window_id, "': ", message);
         emit_main_event({{"type", "native-window.error"},
                          {"windowId", window_id},
                          {"message", message}});
     }
 
     void create_window_on_ui_thread(const std::string &window_id) {
+        APP_TRACE_SPAN("window", "create");
+        const watchdog::TaskScope task("window.create");
         json bootstrap_snapshot;
         {
             std::lock_guard<std::mutex> lock(mu_);
+            if (shutting_down_.load()) {
+                bootstraps_.erase(window_id);
+                return;
+            }
             auto it = bootstraps_.find(window_id);
             if (it != bootstraps_.end()) {
                 bootstrap_snapshot = it->second;
@@ -441,6 +714,9 @@ class WindowManager {
             resolve_window_config(bootstrap_snapshot, window_id);
 
         try {
+            const std::string span_prefix = "window " + window_id;
+            StartupProfiler::Scope total(profiler_, span_prefix);
+            auto phase = std::chrono::steady_clock::now();
             auto window =
                 std::make_unique<webview::webview>(dev_mode_, nullptr);
             window->set_title(cfg.title);
@@ -453,16 +729,26 @@ class WindowManager {
                                         child_handle.value());
             }
 
+            phase = profile_phase(span_prefix + ": create-webview", phase);
+
             if (bindings_setup_) {
                 bindings_setup_(*window);
             }
+            phase = profile_phase(span_prefix + ": register-bindings", phase);
             load_content(*window, window_id, bootstrap_snapshot);
+            profile_phase(span_prefix + ": load-content", phase);
 
+            void *handle = child_handle.ok() ? child_handle.value() : nullptr;
             {
                 std::lock_guard<std::mutex> lock(mu_);
                 windows_[window_id] = std::move(window);
                 window_info_[window_id] = WindowInfo{cfg.title};
+                trace::counter("window", "open_windows",
+                               static_cast<std::int64_t>(windows_.size()));
+                metrics::registry().gauge("windows_open").set(
+                    static_cast<std::int64_t>(windows_.size()));
             }
+            track_window_geometry(window_id, handle);
         } catch (const std::exception &e) {
             handle_window_creation_failure(window_id, e.what());
         } catch (...) {
@@ -470,6 +756,17 @@ class WindowManager {
         }
     }
 
+    // Fecha o span `name` iniciado em `begin`; devolve o início do próximo
+    std::chrono::steady_clock::time_point
+    profile_phase(const std::string &name,
+                  std::chrono::steady_clock::time_point begin) {
+        const auto now = std::chrono::steady_clock::now();
+        if (profiler_) {
+            profiler_->span(name, begin, now);
+        }
+        return now;
+    }
+
     std::string next_id() {
         const unsigned int value = next_id_.fetch_add(1);
         return "w" + std::to_string(value);
@@ -495,54 +792,341 @@ class WindowManager {
         return windows;
     }
 
+    // =========================================================================
+    // Geometria das janelas (índice para hit test do drag)
+    // =========================================================================
+
+    static json rect_to_json(const WindowRect &rect) {
+        return {{"left", rect.x},
+                {"top", rect.y},
+                {"width", rect.width},
+                {"height", rect.height}};
+    }
+
+    void *find_window_handle(const std::string &window_id) {
+        if (window_id == main_window_id_) {
+            auto handle = main_window_.window();
+            return handle.ok() ? handle.value() : nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = windows_.find(window_id);
+        if (it == windows_.end() || !it->second) {
+            return nullptr;
+        }
+        auto handle = it->second->window();
+        return handle.ok() ? handle.value() : nullptr;
+    }
+
+    void track_window_geometry(const std::string &window_id, void *handle) {
+        if (!handle) {
+            return;
+        }
+        auto watch = watch_window_geometry(
+            handle, [this, window_id](const WindowGeometryEvent &event) {
+                on_window_geometry(window_id, event);
+            });
+        const auto rect = get_window_bounds(handle);
+        std::lock_guard<std::mutex> lock(geometry_mu_);
+        if (rect) {
+            geometry_.update(window_id, *rect);
+        }
+        if (watch) {
+            geometry_watches_[window_id] = std::move(watch);
+        }
+    }
+
+    void untrack_window_geometry(const std::string &window_id) {
+        WindowGeometryWatchPtr watch; // desconectado fora do lock
+        {
+            std::lock_guard<std::mutex> lock(geometry_mu_);
+            geometry_.remove(window_id);
+            auto it = geometry_watches_.find(window_id);
+            if (it != geometry_watches_.end()) {
+                watch = std::move(it->second);
+                geometry_watches_.erase(it);
+            }
+        }
+    }
+
+    // Janelas sem eventos nativos (Windows/macOS) são consultadas no início
+    // de cada drag; durante o drag elas não se movem.
+    void refresh_unwatched_geometry() {
+        for (const auto &window : collect_drag_windows()) {
+            {
+                std::lock_guard<std::mutex> lock(geometry_mu_);
+                if (geometry_watches_.count(window.id) != 0) {
+                    continue;
+                }
+            }
+            if (const auto rect = get_window_bounds(window.handle)) {
+                std::lock_guard<std::mutex> lock(geometry_mu_);
+                geometry_.update(window.id, *rect);
+            }
+        }
+    }
+
+    void on_window_geometry(const std::string &window_id,
+                            const WindowGeometryEvent &event) {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(geometry_mu_);
+            switch (event.kind) {
+            case WindowGeometryEvent::Kind::Configured:
+                changed = geometry_.update(window_id, event.rect);
+                break;
+            case WindowGeometryEvent::Kind::Raised:
+                geometry_.update(window_id, event.rect);
+                geometry_.raise(window_id);
+                break;
+            case WindowGeometryEvent::Kind::Hidden:
+                geometry_.remove(window_id);
+                break;
+            }
+            // Coalesce rajadas de configure (arrastar/redimensionar a janela)
+            // numa única notificação por janela
+            if (!changed || !geometry_pending_.insert(window_id).second) {
+                return;
+            }
+        }
+        dispatch_if_alive([this, window_id] {
+            std::optional<WindowRect> rect;
+            {
+                std::lock_guard<std::mutex> lock(geometry_mu_);
+                geometry_pending_.erase(window_id);
+                rect = geometry_.bounds(window_id);
+            }
+            if (rect) {
+                post_event(window_id, {{"type", "native-window.geometry"},
+                                       {"payload",
+                                        {{"windowId", window_id},
+                                         {"bounds", rect_to_json(*rect)}}}});
+            }
+        });
+    }
+
+    void hit_test_window(const DragCursor &cursor, std::string &out) {
+        std::lock_guard<std::mutex> lock(geometry_mu_);
+        const auto *entry = geometry_.hit_test(cursor.x, cursor.y);
+        if (entry) {
+            out.assign(entry->id);
+        }
+    }
+
+    // Hover só carrega ids: o payload fica no lado nativo até o drop
     void on_drag_hover_change(const std::string &hovered_id) {
+        std::uint64_t drag_id = 0;
         std::string origin_id;
         std::string previous_id;
-        json payload;
+        bool has_payload = false;
         {
             std::lock_guard<std::mutex> lock(mu_);
-            origin_id = drag_origin_id_;
-            previous_id = drag_hovered_id_;
-            payload = drag_payload_;
-            if (hovered_id == previous_id) {
+            if (hovered_id == drag_hovered_id_) {
                 return;
             }
-            drag_hovered_id_ = hovered_id;
+            drag_id = drag_id_;
+            origin_id = drag_origin_id_;
+            previous_id = std::exchange(drag_hovered_id_, hovered_id);
+            has_payload = drag_payload_ != nullptr;
         }
 
         if (!previous_id.empty() && previous_id != origin_id) {
-            post_event(previous_id,
-                       {{"type", "dock.dragLeave"},
-                        {"payload", {{"originWindowId", origin_id}}}});
+            post_raw_event(previous_id,
+                           drag::hover_event("dock.dragLeave", drag_id,
+                                             origin_id, previous_id));
+        }
+        if (!hovered_id.empty() && hovered_id != origin_id && has_payload) {
+            post_raw_event(hovered_id,
+                           drag::hover_event("dock.dragHover", drag_id,
+                                             origin_id, hovered_id));
+        }
+    }
+
+    // Stream do cursor (local à janela) e zona de drop para a janela sob o
+    // drag. Cursor: no máximo um evento por frame; zona: só mudanças.
+    void on_drag_move(const std::string &hovered_id) {
+        static constexpr auto FRAME = std::chrono::milliseconds(16);
+        APP_TRACE_SPAN("drag", "move");
+        const watchdog::TaskScope task("drag.move");
+
+        std::uint64_t drag_id = 0;
+        std::string origin_id;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            drag_id = drag_id_;
+            origin_id = drag_origin_id_;
+        }
+        if (drag_id == 0) {
+            return;
+        }
+
+        // Saiu da janela que exibia a prévia: limpa a zona lá
+        if (!drop_window_id_.empty() && drop_window_id_ != hovered_id) {
+            if (drop_zone_ != dock::DropZone::None) {
+                post_raw_event(drop_window_id_,
+                               drag::drop_zone_event(
+                                   drag_id, {},
+                                   dock::to_string(dock::DropZone::None)));
+            }
+            reset_drop_preview();
         }
-        if (!hovered_id.empty() && hovered_id != origin_id &&
-            !payload.is_null()) {
-            post_event(hovered_id,
-                       {{"type", "dock.dragHover"},
-                        {"payload", {{"originWindowId", origin_id}}}});
+        if (hovered_id.empty() || hovered_id == origin_id) {
+            return;
+        }
+
+        const auto point = pointer_in_window(find_window_handle(hovered_id));
+        if (!point) {
+            return;
+        }
+        drop_window_id_ = hovered_id;
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto elapsed = now - last_stream_time_;
+        if (*point == last_stream_point_) {
+            pending_stream_point_.reset();
+        } else if (elapsed >= FRAME) {
+            pending_stream_point_.reset();
+            last_stream_point_ = *point;
+            last_stream_time_ = now;
+            post_raw_event(hovered_id,
+                           drag::cursor_event(drag_id, point->x, point->y));
+        } else {
+            // Dentro do frame: guarda a última amostra e agenda o envio no
+            // fim dele (senão o ponto em que o cursor parou se perde)
+            pending_stream_point_ = *point;
+            if (!cursor_flush_ || cursor_flush_.done()) {
+                schedule_cursor_flush(
+                    drag_id,
+                    std::chrono::ceil<std::chrono::milliseconds>(FRAME -
+                                                                 elapsed));
+            }
         }
+
+        dock::DropZone zone = dock::DropZone::None;
+        bool target_changed = false;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            auto it = drop_targets_.find(hovered_id);
+            if (it != drop_targets_.end()) {
+                const auto hit =
+                    dock::compute_drop_zone(it->second, point->x, point->y);
+                zone = hit.zone;
+                const std::string_view target_id =
+                    hit.target ? std::string_view(hit.target->id)
+                               : std::string_view();
+                if (target_id != drop_target_id_) {
+                    drop_target_id_.assign(target_id);
+                    target_changed = true;
+                }
+            }
+        }
+        if (zone == drop_zone_ && !target_changed) {
+            return;
+        }
+        drop_zone_ = zone;
+        post_raw_event(hovered_id,
+                       drag::drop_zone_event(drag_id, drop_target_id_,
+                                             dock::to_string(zone)));
+    }
+
+    // Timer único do executor; o envio volta para a thread da UI
+    void schedule_cursor_flush(std::uint64_t drag_id,
+                               std::chrono::milliseconds delay) {
+        cursor_flush_ = executor().schedule_after(
+            delay, Lane::High, "drag.cursorFlush", [this, drag_id] {
+                dispatch_if_alive(
+                    [this, drag_id] { flush_cursor_stream(drag_id); });
+            });
+    }
+
+    // Despacha para a thread da UI, mas só roda se o manager ainda existir
+    // (a fila do GTK pode entregar depois do destrutor)
+    template <typename F> void dispatch_if_alive(F &&fn) {
+        main_window_.dispatch([alive = std::weak_ptr<bool>(alive_),
+                               fn = std::forward<F>(fn)]() mutable {
+            if (!alive.expired()) {
+                fn();
+            }
+        });
+    }
+
+    void flush_cursor_stream(std::uint64_t drag_id) {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if (drag_id_ != drag_id) {
+                return;
+            }
+        }
+        if (!pending_stream_point_ || drop_window_id_.empty()) {
+            return;
+        }
+        last_stream_point_ = *pending_stream_point_;
+        last_stream_time_ = std::chrono::steady_clock::now();
+        pending_stream_point_.reset();
+        post_raw_event(drop_window_id_,
+                       drag::cursor_event(drag_id, last_stream_point_.x,
+                                          last_stream_point_.y));
+    }
+
+    void reset_drop_preview() {
+        drop_window_id_.clear();
+        drop_target_id_.clear();
+        drop_zone_ = dock::DropZone::None;
+        last_stream_point_ = {-1, -1};
+        pending_stream_point_.reset();
+        cursor_flush_.cancel();
+    }
+
+    void clear_drag_locked() {
+        drag_id_ = 0;
+        drag_payload_.reset();
+        drag_origin_id_.clear();
+        drag_hovered_id_.clear();
     }
 
     webview::webview &main_window_;
     bool dev_mode_ = false;
     std::string dev_url_;
     std::string custom_url_;
+    std::string embedded_url_;
     int default_width_ = 0;
     int default_height_ = 0;
     std::string title_base_;
     std::string main_window_id_ = "main";
     std::string main_title_;
     std::atomic_uint next_id_{1};
+    std::atomic<bool> shutting_down_{false};
 
     std::mutex mu_;
     std::unordered_map<std::string, std::unique_ptr<webview::webview>> windows_;
     std::unordered_map<std::string, WindowInfo> window_info_;
     std::unordered_map<std::string, json> bootstraps_;
-    json drag_payload_;
+    std::unordered_map<std::string, std::shared_ptr<EventChannel>> channels_;
+    std::mutex geometry_mu_;
+    WindowGeometryIndex geometry_;
+    std::unordered_map<std::string, WindowGeometryWatchPtr> geometry_watches_;
+    std::unordered_set<std::string> geometry_pending_;
+    std::uint64_t next_drag_id_ = 0;
+    std::uint64_t drag_id_ = 0;
+    drag::SharedPayload drag_payload_;
+    std::unordered_map<std::string, std::vector<dock::DropTarget>>
+        drop_targets_;
     std::string drag_origin_id_;
     std::string drag_hovered_id_;
+    // Prévia de drop (somente thread da UI)
+    std::string drop_window_id_;
+    std::string drop_target_id_;
+    dock::DropZone drop_zone_ = dock::DropZone::None;
+    WindowPoint last_stream_point_{-1, -1};
+    std::chrono::steady_clock::time_point last_stream_time_;
+    // Última amostra retida pelo limite de um evento por frame
+    std::optional<WindowPoint> pending_stream_point_;
+    Task cursor_flush_;
+    // Token de vida das tarefas despachadas (ver dispatch_if_alive)
+    std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
     DragTracker drag_tracker_;
     BindingsSetup bindings_setup_;
+    ClosedListener closed_listener_;
+    StartupProfiler *profiler_ = nullptr;
 };
 
 } // namespace app
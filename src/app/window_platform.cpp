@@ -1,9 +1,15 @@
 #include "app/window_platform.h"
 
+#include <utility>
+#include <vector>
+
 #if defined(__linux__)
 #include <gtk/gtk.h>
 #elif defined(_WIN32)
 #include <windows.h>
+#elif defined(__APPLE__)
+#include <objc/message.h>
+#include <objc/objc-runtime.h>
 #endif
 
 namespace app {
@@ -62,4 +68,250 @@ void move_window_to(void *window, int left, int top) {
 #endif
 }
 
+std::optional<WindowRect> get_window_bounds(void *window) {
+    if (!window) {
+        return std::nullopt;
+    }
+
+#if defined(_WIN32)
+    RECT rect{};
+    if (!GetWindowRect(static_cast<HWND>(window), &rect)) {
+        return std::nullopt;
+    }
+    return WindowRect{rect.left, rect.top, rect.right - rect.left,
+                      rect.bottom - rect.top};
+#elif defined(__APPLE__)
+    struct NSPoint {
+        double x;
+        double y;
+    };
+    struct NSSize {
+        double width;
+        double height;
+    };
+    struct NSRect {
+        NSPoint origin;
+        NSSize size;
+    };
+
+    // On x86_64, structs larger than 16 bytes must use objc_msgSend_stret.
+    NSRect frame{};
+#if defined(__x86_64__)
+    using SendStret = void (*)(NSRect *, id, SEL);
+    auto send_frame = reinterpret_cast<SendStret>(objc_msgSend_stret);
+    send_frame(&frame, static_cast<id>(window), sel_registerName("frame"));
+#else
+    frame = reinterpret_cast<NSRect (*)(id, SEL)>(objc_msgSend)(
+        static_cast<id>(window), sel_registerName("frame"));
+#endif
+    return WindowRect{static_cast<int>(frame.origin.x),
+                      static_cast<int>(frame.origin.y),
+                      static_cast<int>(frame.size.width),
+                      static_cast<int>(frame.size.height)};
+#elif defined(__linux__)
+#if GTK_MAJOR_VERSION >= 4
+    // GDK4 não expõe a posição global da surface (Wayland)
+    return std::nullopt;
+#else
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    gtk_window_get_position(GTK_WINDOW(window), &x, &y);
+    gtk_window_get_size(GTK_WINDOW(window), &width, &height);
+    return WindowRect{x, y, width, height};
+#endif
+#else
+    return std::nullopt;
+#endif
+}
+
+std::optional<WindowPoint> pointer_in_window(void *window) {
+    if (!window) {
+        return std::nullopt;
+    }
+
+#if defined(_WIN32)
+    POINT pt{};
+    if (!GetCursorPos(&pt) || !ScreenToClient(static_cast<HWND>(window), &pt)) {
+        return std::nullopt;
+    }
+    return WindowPoint{pt.x, pt.y};
+#elif defined(__APPLE__)
+    struct NSPoint {
+        double x;
+        double y;
+    };
+    struct NSSize {
+        double width;
+        double height;
+    };
+    struct NSRect {
+        NSPoint origin;
+        NSSize size;
+    };
+
+    Class ns_event = objc_getClass("NSEvent");
+    if (!ns_event) {
+        return std::nullopt;
+    }
+    const NSPoint screen = reinterpret_cast<NSPoint (*)(id, SEL)>(
+        objc_msgSend)(reinterpret_cast<id>(ns_event),
+                      sel_registerName("mouseLocation"));
+    const NSPoint local =
+        reinterpret_cast<NSPoint (*)(id, SEL, NSPoint)>(objc_msgSend)(
+            static_cast<id>(window),
+            sel_registerName("convertPointFromScreen:"), screen);
+
+    // Cocoa usa origem no canto inferior esquerdo; o JS, no superior
+    id content = reinterpret_cast<id (*)(id, SEL)>(objc_msgSend)(
+        static_cast<id>(window), sel_registerName("contentView"));
+    if (!content) {
+        return std::nullopt;
+    }
+    NSRect frame{};
+#if defined(__x86_64__)
+    using SendStret = void (*)(NSRect *, id, SEL);
+    reinterpret_cast<SendStret>(objc_msgSend_stret)(&frame, content,
+                                                    sel_registerName("frame"));
+#else
+    frame = reinterpret_cast<NSRect (*)(id, SEL)>(objc_msgSend)(
+        content, sel_registerName("frame"));
+#endif
+    return WindowPoint{static_cast<int>(local.x),
+                       static_cast<int>(frame.size.height - local.y)};
+#elif defined(__linux__)
+#if GTK_MAJOR_VERSION >= 4
+    auto *native = GTK_NATIVE(window);
+    auto *surface = gtk_native_get_surface(native);
+    if (!surface) {
+        return std::nullopt;
+    }
+    auto *seat = gdk_display_get_default_seat(gdk_surface_get_display(surface));
+    auto *pointer = seat ? gdk_seat_get_pointer(seat) : nullptr;
+    double x = 0;
+    double y = 0;
+    if (!pointer ||
+        !gdk_surface_get_device_position(surface, pointer, &x, &y, nullptr)) {
+        return std::nullopt;
+    }
+    // Desconta sombra/decoração client-side
+    double offset_x = 0;
+    double offset_y = 0;
+    gtk_native_get_surface_transform(native, &offset_x, &offset_y);
+    return WindowPoint{static_cast<int>(x - offset_x),
+                       static_cast<int>(y - offset_y)};
+#else
+    GtkWidget *content = gtk_bin_get_child(GTK_BIN(window));
+    if (!content) {
+        content = GTK_WIDGET(window);
+    }
+    GdkWindow *gdk_window = gtk_widget_get_window(content);
+    auto *seat = gdk_display_get_default_seat(gtk_widget_get_display(content));
+    auto *pointer = seat ? gdk_seat_get_pointer(seat) : nullptr;
+    if (!gdk_window || !pointer) {
+        return std::nullopt;
+    }
+    int x = 0;
+    int y = 0;
+    gdk_window_get_device_position(gdk_window, pointer, &x, &y, nullptr);
+    if (!gtk_widget_get_has_window(content)) {
+        // Widget sem GdkWindow própria: coordenadas vêm relativas ao pai
+        GtkAllocation allocation{};
+        gtk_widget_get_allocation(content, &allocation);
+        x -= allocation.x;
+        y -= allocation.y;
+    }
+    return WindowPoint{x, y};
+#endif
+#else
+    return std::nullopt;
+#endif
+}
+
+// =============================================================================
+// Eventos de geometria
+// =============================================================================
+
+struct WindowGeometryWatch {
+    void *target = nullptr; // weak pointer: zerado quando a janela morre
+    WindowGeometryListener listener;
+#if defined(__linux__)
+    std::vector<gulong> handlers;
+#endif
+};
+
+#if defined(__linux__) && GTK_MAJOR_VERSION < 4
+namespace {
+
+void emit_geometry(WindowGeometryWatch *watch, WindowGeometryEvent::Kind kind) {
+    WindowGeometryEvent event;
+    event.kind = kind;
+    if (kind != WindowGeometryEvent::Kind::Hidden) {
+        event.rect = get_window_bounds(watch->target).value_or(WindowRect{});
+    }
+    watch->listener(event);
+}
+
+gboolean on_configure(GtkWidget *, GdkEventConfigure *, gpointer data) {
+    emit_geometry(static_cast<WindowGeometryWatch *>(data),
+                  WindowGeometryEvent::Kind::Configured);
+    return FALSE;
+}
+
+gboolean on_focus_in(GtkWidget *, GdkEventFocus *, gpointer data) {
+    emit_geometry(static_cast<WindowGeometryWatch *>(data),
+                  WindowGeometryEvent::Kind::Raised);
+    return FALSE;
+}
+
+gboolean on_unmap(GtkWidget *, GdkEvent *, gpointer data) {
+    emit_geometry(static_cast<WindowGeometryWatch *>(data),
+                  WindowGeometryEvent::Kind::Hidden);
+    return FALSE;
+}
+
+} // namespace
+#endif
+
+WindowGeometryWatchPtr watch_window_geometry(void *window,
+                                             WindowGeometryListener listener) {
+#if defined(__linux__) && GTK_MAJOR_VERSION < 4
+    if (!window || !listener) {
+        return nullptr;
+    }
+    WindowGeometryWatchPtr watch(new WindowGeometryWatch{});
+    watch->target = window;
+    watch->listener = std::move(listener);
+    auto *raw = watch.get();
+    watch->handlers.push_back(g_signal_connect(
+        window, "configure-event", G_CALLBACK(on_configure), raw));
+    watch->handlers.push_back(g_signal_connect(
+        window, "focus-in-event", G_CALLBACK(on_focus_in), raw));
+    watch->handlers.push_back(
+        g_signal_connect(window, "unmap-event", G_CALLBACK(on_unmap), raw));
+    g_object_add_weak_pointer(G_OBJECT(window), &watch->target);
+    return watch;
+#else
+    // GTK4 não tem configure-event nem posição global; Windows/macOS não
+    // expõem o loop de mensagens da webview. Sem eventos: consulta sob
+    // demanda.
+    (void)window;
+    (void)listener;
+    return nullptr;
+#endif
+}
+
+void WindowGeometryWatchDeleter::operator()(WindowGeometryWatch *watch) const {
+#if defined(__linux__)
+    if (watch && watch->target) {
+        for (const gulong id : watch->handlers) {
+            g_signal_handler_disconnect(watch->target, id);
+        }
+        g_object_remove_weak_pointer(G_OBJECT(watch->target), &watch->target);
+    }
+#endif
+    delete watch;
+}
+
 } // namespace app
@@ -3,9 +3,43 @@
 // Window platform helpers - keep native code in .cpp
 // =============================================================================
 
+#include "app/window_geometry.h"
+#include <functional>
+#include <memory>
+#include <optional>
+
 namespace app {
 
 void attach_window_to_parent(void *parent_window, void *child_window);
 void move_window_to(void *window, int left, int top);
 
+// Posição/tamanho da janela em coordenadas de tela (consulta síncrona)
+std::optional<WindowRect> get_window_bounds(void *window);
+
+// Posição do ponteiro relativa à área de conteúdo (webview) da janela, em
+// px lógicos - o mesmo espaço de clientX/clientY no JS
+std::optional<WindowPoint> pointer_in_window(void *window);
+
+struct WindowGeometryEvent {
+    enum class Kind { Configured, Raised, Hidden };
+    Kind kind = Kind::Configured;
+    WindowRect rect;
+};
+
+using WindowGeometryListener = std::function<void(const WindowGeometryEvent &)>;
+
+// Assinatura dos eventos nativos de geometria/empilhamento de uma janela.
+// Destruir o handle desconecta; se a janela morrer antes, o handle vira
+// no-op. Retorna nullptr onde não há eventos nativos (Windows/macOS): o
+// chamador deve consultar get_window_bounds sob demanda.
+struct WindowGeometryWatch;
+struct WindowGeometryWatchDeleter {
+    void operator()(WindowGeometryWatch *watch) const;
+};
+using WindowGeometryWatchPtr =
+    std::unique_ptr<WindowGeometryWatch, WindowGeometryWatchDeleter>;
+
+WindowGeometryWatchPtr watch_window_geometry(void *window,
+                                             WindowGeometryListener listener);
+
 } // namespace app
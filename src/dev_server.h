@@ -3,14 +3,25 @@
 // Dev Server Manager - Gerencia o Vite dev server para hot reload
 // =============================================================================
 
+#include "app/log.h"
+#include "app/main_loop.h"
+#include <atomic>
+#include <cerrno>
 #include <chrono>
+#include <condition_variable>
 #include <csignal>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -18,8 +29,11 @@
 #pragma comment(lib, "winhttp.lib")
 #else
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -46,8 +60,21 @@ struct ServerConfig {
     std::string command{default_command};
     std::string working_dir{""}; // diretório do UI
     std::chrono::seconds timeout{30};
+    // Variáveis extras repassadas ao processo do dev server
+    std::vector<std::pair<std::string, std::string>> environment;
 };
 
+// Linha "Local:" do Vite: URL efetiva do servidor
+struct ReadyInfo {
+    std::string url; // sem a barra final
+    std::string host;
+    int port = 0;
+};
+
+namespace detail {
+struct OutputPump;
+}
+
 struct ServerProcess {
     ServerState state = ServerState::Stopped;
 #ifdef _WIN32
@@ -57,8 +84,280 @@ struct ServerProcess {
     pid_t pid = -1;
 #endif
     bool owned = false; // true se nós iniciamos o processo
+    std::string url;    // URL efetiva (pode diferir de ServerConfig::dev_url)
+    // stdout/stderr do filho (nulo se o pipe não pôde ser criado)
+    std::shared_ptr<detail::OutputPump> output;
 };
 
+// =============================================================================
+// Saída do Vite - detecta a URL real em vez de sondar a porta
+// =============================================================================
+
+// Remove sequências de escape ANSI (cores, caso FORCE_COLOR esteja ativo)
+inline std::string strip_ansi(std::string_view line) {
+    std::string out;
+    out.reserve(line.size());
+    for (std::size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == '\x1b' && i + 1 < line.size() && line[i + 1] == '[') {
+            i += 2;
+            while (i < line.size() && (line[i] < '@' || line[i] > '~')) {
+                ++i;
+            }
+            continue;
+        }
+        out += line[i];
+    }
+    return out;
+}
+
+// "  ➜  Local:   http://127.0.0.1:5174/" -> {url, host, port}. O Vite
+// imprime "ready in N ms" e logo em seguida esta linha; só ela tem a URL.
+inline std::optional<ReadyInfo> parse_vite_ready_line(std::string_view raw) {
+    const std::string line = strip_ansi(raw);
+    const std::size_t label = line.find("Local:");
+    if (label == std::string::npos) {
+        return std::nullopt;
+    }
+    const std::size_t start = line.find("http", label);
+    if (start == std::string::npos) {
+        return std::nullopt;
+    }
+    std::size_t end = line.find_first_of(" \t\r", start);
+    if (end == std::string::npos) {
+        end = line.size();
+    }
+    std::string url = line.substr(start, end - start);
+    const std::size_t scheme = url.find("://");
+    if (scheme == std::string::npos) {
+        return std::nullopt;
+    }
+    if (url.size() > scheme + 3 && url.back() == '/') {
+        url.pop_back();
+    }
+
+    ReadyInfo info;
+    const std::size_t host_start = scheme + 3;
+    std::size_t host_end = url.find_first_of(":/", host_start);
+    if (url[host_start] == '[') { // IPv6: [::1]:5173
+        host_end = url.find(']', host_start);
+        if (host_end == std::string::npos) {
+            return std::nullopt;
+        }
+        ++host_end;
+    }
+    if (host_end == std::string::npos) {
+        host_end = url.size();
+    }
+    info.host = url.substr(host_start, host_end - host_start);
+    if (info.host.empty()) {
+        return std::nullopt;
+    }
+    info.port = url.compare(0, 5, "https") == 0 ? 443 : 80;
+    if (host_end < url.size() && url[host_end] == ':') {
+        int port = 0;
+        std::size_t i = host_end + 1;
+        for (; i < url.size() && url[i] >= '0' && url[i] <= '9'; ++i) {
+            port = port * 10 + (url[i] - '0');
+        }
+        if (i == host_end + 1 || port <= 0 || port > 65535) {
+            return std::nullopt;
+        }
+        info.port = port;
+    }
+    info.url = std::move(url);
+    return info;
+}
+
+namespace detail {
+
+// Lê o pipe do filho: repassa cada linha ao log (o pipe precisa ser drenado
+// sempre, senão o Vite trava ao escrever) e sinaliza a primeira linha
+// "Local:". Com main loop o pipe é uma fonte do reactor, lida no pool; sem
+// ele (Windows, macOS), uma thread dedicada.
+struct OutputPump {
+    std::mutex mu;
+    std::condition_variable cv;
+    std::optional<ReadyInfo> ready;
+    bool closed = false; // EOF: o filho (e quem herdou o pipe) saiu
+    std::atomic<bool> stopping{false};
+    std::thread thread;
+#ifdef _WIN32
+    HANDLE read_handle = nullptr;
+#else
+    int fd = -1;
+    app::FdWatchId watch = 0;
+#endif
+
+    OutputPump() = default;
+    OutputPump(const OutputPump &) = delete;
+    OutputPump &operator=(const OutputPump &) = delete;
+    ~OutputPump() { stop(); }
+
+    // Espera a URL até `timeout`. nullopt se ainda não apareceu ou se o pipe
+    // fechou (ver is_closed).
+    std::optional<ReadyInfo> wait_ready(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mu);
+        cv.wait_for(lock, timeout, [this] { return ready || closed; });
+        return ready;
+    }
+
+    bool is_closed() {
+        std::lock_guard<std::mutex> lock(mu);
+        return closed;
+    }
+
+    void start() {
+#ifndef _WIN32
+        watch = app::add_fd_watch(
+            fd, app::FdReadable, [this](unsigned) { return on_readable(); },
+            app::FdDispatch::Worker);
+        if (watch != 0) {
+            return;
+        }
+#endif
+        thread = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        stopping.store(true);
+#ifndef _WIN32
+        if (watch != 0) {
+            // Espera um callback em andamento; só então fecha o fd (fechar
+            // antes deixaria o número livre para reuso ainda no epoll)
+            app::remove_fd_watch(watch);
+            watch = 0;
+            finish();
+            return;
+        }
+#endif
+        if (!thread.joinable()) {
+            return;
+        }
+#ifdef _WIN32
+        // ReadFile bloqueia; cancela a leitura pendente da thread
+        CancelSynchronousIo(thread.native_handle());
+#endif
+        thread.join();
+    }
+
+  private:
+    std::string pending; // linha incompleta
+
+#ifndef _WIN32
+    // Pool, via reactor (edge-triggered): lê até EAGAIN. false no EOF; o fd
+    // é fechado em stop().
+    bool on_readable() {
+        char buffer[4096];
+        while (true) {
+            const ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                feed(buffer, static_cast<std::size_t>(n));
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && errno == EAGAIN) {
+                return true;
+            }
+            mark_closed(); // EOF ou erro
+            return false;
+        }
+    }
+#endif
+
+    void run() {
+        char buffer[4096];
+#ifdef _WIN32
+        DWORD count = 0;
+        while (!stopping.load() &&
+               ReadFile(read_handle, buffer, sizeof(buffer), &count,
+                        nullptr) &&
+               count > 0) {
+            feed(buffer, count);
+        }
+        CloseHandle(read_handle);
+        read_handle = nullptr;
+        mark_closed();
+#else
+        while (!stopping.load()) {
+            pollfd pfd{fd, POLLIN, 0};
+            const int rc = poll(&pfd, 1, 100);
+            if (rc == 0 || (rc < 0 && errno == EINTR)) {
+                continue;
+            }
+            if (rc < 0) {
+                break;
+            }
+            const ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                feed(buffer, static_cast<std::size_t>(n));
+                continue;
+            }
+            if (n < 0 && (errno == EINTR || errno == EAGAIN)) {
+                continue;
+            }
+            break; // EOF
+        }
+        finish();
+#endif
+    }
+
+#ifndef _WIN32
+    void finish() {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+        mark_closed();
+    }
+#endif
+
+    void mark_closed() {
+        if (!pending.empty()) {
+            emit_line(pending);
+            pending.clear();
+        }
+        std::lock_guard<std::mutex> lock(mu);
+        closed = true;
+        cv.notify_all();
+    }
+
+    void feed(const char *data, std::size_t size) {
+        pending.append(data, size);
+        std::size_t begin = 0;
+        std::size_t newline = 0;
+        while ((newline = pending.find('\n', begin)) != std::string::npos) {
+            emit_line(std::string_view(pending).substr(begin, newline - begin));
+            begin = newline + 1;
+        }
+        pending.erase(0, begin);
+    }
+
+    void emit_line(std::string_view line) {
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        // Sem rate limit: a saída do Vite (ex: stack de erro) vai inteira
+        if (app::log::enabled(app::log::Level::Info)) {
+            app::log::write(app::log::Level::Info, "VITE", 0, line);
+        }
+        bool notify = false;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            if (!ready) {
+                ready = parse_vite_ready_line(line);
+                notify = ready.has_value();
+            }
+        }
+        if (notify) {
+            cv.notify_all();
+        }
+    }
+};
+
+} // namespace detail
+
 // =============================================================================
 // Health check - verifica se o servidor está respondendo
 // =============================================================================
@@ -102,40 +401,60 @@ inline bool is_server_responding(const std::string &host, int port) {
 
     return success;
 #else
-    // POSIX: socket simples
-    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
-    if (sockfd < 0)
-        return false;
-
-    // Timeout de conexão
-    struct timeval tv;
-    tv.tv_sec = 1;
-    tv.tv_usec = 0;
-    setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-    setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    // POSIX: socket não bloqueante; connect, envio e resposta dividem um
+    // prazo total de 1s
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    const auto wait_for = [&deadline](int fd, short events) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        pollfd pfd{fd, events, 0};
+        return left.count() > 0 &&
+               poll(&pfd, 1, static_cast<int>(left.count())) == 1 &&
+               (pfd.revents & events) != 0;
+    };
 
     struct sockaddr_in serv_addr {};
     serv_addr.sin_family = AF_INET;
     serv_addr.sin_port = htons(static_cast<uint16_t>(port));
-
     if (inet_pton(AF_INET, host.c_str(), &serv_addr.sin_addr) <= 0) {
-        close(sockfd);
         return false;
     }
 
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0)
+        return false;
+    fcntl(sockfd, F_SETFL, fcntl(sockfd, F_GETFL, 0) | O_NONBLOCK);
+
     bool connected =
-        (connect(sockfd, reinterpret_cast<struct sockaddr *>(&serv_addr),
-                 sizeof(serv_addr)) == 0);
+        connect(sockfd, reinterpret_cast<struct sockaddr *>(&serv_addr),
+                sizeof(serv_addr)) == 0;
+    if (!connected && errno == EINPROGRESS && wait_for(sockfd, POLLOUT)) {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        connected =
+            getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &error, &len) == 0 &&
+            error == 0;
+    }
 
     if (connected) {
-        // Envia request HTTP básico
+        // Envia request HTTP básico (cabe no buffer do socket recém-aberto)
         const char *request =
             "GET / HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n";
-        send(sockfd, request, strlen(request), 0);
+        const auto length = static_cast<ssize_t>(strlen(request));
+        connected = send(sockfd, request, strlen(request), 0) == length;
+    }
 
+    if (connected) {
         // Lê resposta
         char buffer[256];
-        ssize_t bytes = recv(sockfd, buffer, sizeof(buffer) - 1, 0);
+        ssize_t bytes = -1;
+        while (wait_for(sockfd, POLLIN)) {
+            bytes = recv(sockfd, buffer, sizeof(buffer) - 1, 0);
+            if (bytes >= 0 || (errno != EAGAIN && errno != EINTR)) {
+                break;
+            }
+        }
         if (bytes > 0) {
             buffer[bytes] = '\0';
             // Verifica se é HTTP response válido
@@ -150,30 +469,94 @@ inline bool is_server_responding(const std::string &host, int port) {
 #endif
 }
 
+// Connect não bloqueante com prazo curto: porta fechada em localhost é
+// recusada na hora, sem o request HTTP nem o timeout de 1s acima. No Windows
+// cai para o health check HTTP.
+inline bool is_port_open(const std::string &host, int port,
+                         std::chrono::milliseconds timeout) {
+#ifdef _WIN32
+    (void)timeout;
+    return is_server_responding(host, port);
+#else
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) <= 0) {
+        return false;
+    }
+
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        return false;
+    }
+    fcntl(sockfd, F_SETFL, fcntl(sockfd, F_GETFL, 0) | O_NONBLOCK);
+
+    bool open = connect(sockfd, reinterpret_cast<struct sockaddr *>(&addr),
+                        sizeof(addr)) == 0;
+    if (!open && errno == EINPROGRESS) {
+        pollfd pfd{sockfd, POLLOUT, 0};
+        if (poll(&pfd, 1, static_cast<int>(timeout.count())) == 1) {
+            int error = 0;
+            socklen_t len = sizeof(error);
+            open = getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &error, &len) ==
+                       0 &&
+                   error == 0;
+        }
+    }
+    close(sockfd);
+    return open;
+#endif
+}
+
 // =============================================================================
 // Spawn do processo
 // =============================================================================
 
 inline bool spawn_server(const ServerConfig &cfg, ServerProcess &proc) {
-    std::cout << "[DEV] Iniciando Vite dev server..." << std::endl;
-    std::cout << "[DEV] Comando: " << cfg.command << std::endl;
-    std::cout << "[DEV] Diretório: " << cfg.working_dir << std::endl;
+    APP_LOG_INFO("DEV", "Iniciando Vite dev server...");
+    APP_LOG_INFO("DEV", "Comando: ", cfg.command);
+    APP_LOG_INFO("DEV", "Diretório: ", cfg.working_dir);
 
 #ifdef _WIN32
     STARTUPINFOA si{};
     PROCESS_INFORMATION pi{};
     si.cb = sizeof(si);
 
+    // stdout/stderr do filho num pipe (só a ponta de escrita é herdada)
+    SECURITY_ATTRIBUTES sa{sizeof(sa), nullptr, TRUE};
+    HANDLE read_handle = nullptr;
+    HANDLE write_handle = nullptr;
+    const bool piped =
+        CreatePipe(&read_handle, &write_handle, &sa, 0) &&
+        SetHandleInformation(read_handle, HANDLE_FLAG_INHERIT, 0);
+    if (piped) {
+        si.dwFlags |= STARTF_USESTDHANDLES;
+        si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+        si.hStdOutput = write_handle;
+        si.hStdError = write_handle;
+    }
+
+    // O filho herda o ambiente do processo atual
+    for (const auto &[name, value] : cfg.environment) {
+        SetEnvironmentVariableA(name.c_str(), value.c_str());
+    }
+
     // Monta comando com cd + comando
     std::string full_cmd =
         "cmd /c cd /d \"" + cfg.working_dir + "\" && " + cfg.command;
 
-    if (!CreateProcessA(nullptr, const_cast<char *>(full_cmd.c_str()), nullptr,
-                        nullptr, FALSE,
-                        CREATE_NEW_PROCESS_GROUP | CREATE_NO_WINDOW, nullptr,
-                        nullptr, &si, &pi)) {
-        std::cerr << "[DEV] Erro ao iniciar processo: " << GetLastError()
-                  << std::endl;
+    const BOOL created = CreateProcessA(
+        nullptr, const_cast<char *>(full_cmd.c_str()), nullptr, nullptr,
+        piped ? TRUE : FALSE, CREATE_NEW_PROCESS_GROUP | CREATE_NO_WINDOW,
+        nullptr, nullptr, &si, &pi);
+    if (write_handle) {
+        CloseHandle(write_handle);
+    }
+    if (!created) {
+        APP_LOG_ERROR("DEV", "Erro ao iniciar processo: ", GetLastError());
+        if (read_handle) {
+            CloseHandle(read_handle);
+        }
         proc.state = ServerState::Failed;
         return false;
     }
@@ -181,18 +564,54 @@ inline bool spawn_server(const ServerConfig &cfg, ServerProcess &proc) {
     proc.process_handle = pi.hProcess;
     proc.process_id = pi.dwProcessId;
     CloseHandle(pi.hThread);
+    if (piped) {
+        proc.output = std::make_shared<detail::OutputPump>();
+        proc.output->read_handle = read_handle;
+        proc.output->start();
+    } else if (read_handle) {
+        CloseHandle(read_handle);
+    }
 #else
+    // stdout/stderr do filho num pipe. Sem pipe, segue sem captura e a
+    // espera cai para o connect na porta configurada. As duas pontas já
+    // nascem O_CLOEXEC (atômico: nenhum fork de outra thread as herda); o
+    // dup2 no filho cria cópias sem a flag, que sobrevivem ao exec.
+    int pipe_fds[2] = {-1, -1};
+    if (pipe2(pipe_fds, O_CLOEXEC) != 0) {
+        APP_LOG_WARN("DEV", "Aviso: sem pipe para a saída do Vite: ",
+                     strerror(errno));
+        pipe_fds[0] = pipe_fds[1] = -1;
+    }
+
     pid_t pid = fork();
 
     if (pid < 0) {
-        std::cerr << "[DEV] Erro no fork: " << strerror(errno) << std::endl;
+        APP_LOG_ERROR("DEV", "Erro no fork: ", strerror(errno));
+        if (pipe_fds[0] >= 0) {
+            close(pipe_fds[0]);
+            close(pipe_fds[1]);
+        }
         proc.state = ServerState::Failed;
         return false;
     }
 
     if (pid == 0) {
-        // Processo filho
+        // Processo filho. O app bloqueia SIGINT/SIGTERM (entregues via
+        // signalfd); a máscara sobrevive ao exec, então o Vite precisa dela
+        // limpa para poder ser encerrado por sinal.
+        sigset_t empty_mask;
+        sigemptyset(&empty_mask);
+        sigprocmask(SIG_SETMASK, &empty_mask, nullptr);
+
+        if (pipe_fds[1] >= 0) {
+            dup2(pipe_fds[1], STDOUT_FILENO);
+            dup2(pipe_fds[1], STDERR_FILENO);
+            close(pipe_fds[0]);
+            close(pipe_fds[1]);
+        }
+
         if (!cfg.working_dir.empty()) {
+            // Processo filho: sem a thread de escrita do log, vai direto
             if (chdir(cfg.working_dir.c_str()) != 0) {
                 std::cerr << "[DEV] Erro ao mudar diretório: "
                           << strerror(errno) << std::endl;
@@ -200,6 +619,10 @@ inline bool spawn_server(const ServerConfig &cfg, ServerProcess &proc) {
             }
         }
 
+        for (const auto &[name, value] : cfg.environment) {
+            setenv(name.c_str(), value.c_str(), 1);
+        }
+
         // Cria novo grupo de processo
         setsid();
 
@@ -212,6 +635,12 @@ inline bool spawn_server(const ServerConfig &cfg, ServerProcess &proc) {
     }
 
     proc.pid = pid;
+    if (pipe_fds[0] >= 0) {
+        close(pipe_fds[1]);
+        proc.output = std::make_shared<detail::OutputPump>();
+        proc.output->fd = pipe_fds[0];
+        proc.output->start();
+    }
 #endif
 
     proc.state = ServerState::Starting;
@@ -225,14 +654,14 @@ inline bool spawn_server(const ServerConfig &cfg, ServerProcess &proc) {
 
 inline void stop_server(ServerProcess &proc) {
     if (!proc.owned) {
-        std::cout << "[DEV] Servidor externo, não será encerrado." << std::endl;
+        APP_LOG_INFO("DEV", "Servidor externo, não será encerrado.");
         return;
     }
 
 #ifdef _WIN32
     if (proc.process_handle) {
-        std::cout << "[DEV] Encerrando Vite dev server (PID: "
-                  << proc.process_id << ")..." << std::endl;
+        APP_LOG_INFO("DEV", "Encerrando Vite dev server (PID: ",
+                     proc.process_id, ")...");
 
         // Tenta terminar graciosamente primeiro
         GenerateConsoleCtrlEvent(CTRL_BREAK_EVENT, proc.process_id);
@@ -249,8 +678,8 @@ inline void stop_server(ServerProcess &proc) {
     }
 #else
     if (proc.pid > 0) {
-        std::cout << "[DEV] Encerrando Vite dev server (PID: " << proc.pid
-                  << ")..." << std::endl;
+        APP_LOG_INFO("DEV", "Encerrando Vite dev server (PID: ", proc.pid,
+                     ")...");
 
         // Envia SIGTERM para o grupo de processos
         kill(-proc.pid, SIGTERM);
@@ -273,23 +702,36 @@ inline void stop_server(ServerProcess &proc) {
     }
 #endif
 
+    // Processo encerrado: para a thread que lê a saída dele
+    if (proc.output) {
+        proc.output->stop();
+        proc.output.reset();
+    }
+    proc.url.clear();
     proc.state = ServerState::Stopped;
     proc.owned = false;
-    std::cout << "[DEV] Vite dev server encerrado." << std::endl;
+    APP_LOG_INFO("DEV", "Vite dev server encerrado.");
 }
 
 // =============================================================================
 // Garantir que o servidor está rodando
 // =============================================================================
 
-inline bool ensure_server_running(const ServerConfig &cfg,
-                                  ServerProcess &proc) {
-    // 1. Já tem algo respondendo?
-    if (is_server_responding(cfg.host, cfg.port)) {
-        std::cout << "[DEV] Servidor já está rodando em " << cfg.dev_url
-                  << std::endl;
+// Bloqueia até o servidor responder. Pode rodar numa thread de fundo:
+// `stop` cancela a espera (encerrando o processo que iniciamos).
+inline bool ensure_server_running(const ServerConfig &cfg, ServerProcess &proc,
+                                  std::stop_token stop = {}) {
+    constexpr auto probe_timeout = std::chrono::milliseconds(100);
+    constexpr auto fallback_interval = std::chrono::milliseconds(250);
+
+    // 1. Já tem algo respondendo? O connect não bloqueante descarta a porta
+    // livre na hora; o health check HTTP só roda se ela estiver ocupada.
+    const bool port_busy = is_port_open(cfg.host, cfg.port, probe_timeout);
+    if (port_busy && is_server_responding(cfg.host, cfg.port)) {
+        APP_LOG_INFO("DEV", "Servidor já está rodando em ", cfg.dev_url);
         proc.state = ServerState::Running;
         proc.owned = false; // Não fomos nós que iniciamos
+        proc.url = cfg.dev_url;
         return true;
     }
 
@@ -301,30 +743,50 @@ inline bool ensure_server_running(const ServerConfig &cfg,
         }
     }
 
-    // 3. Esperar ficar de pé
-    std::cout << "[DEV] Aguardando servidor ficar disponível..." << std::endl;
-    auto start = std::chrono::steady_clock::now();
-    int dots = 0;
+    // 3. Esperar a linha "Local:" do Vite, que traz a porta real (outra se
+    // a configurada estiver ocupada). O connect na porta configurada fica só
+    // como fallback (sem pipe, formato desconhecido) e apenas se ela estava
+    // livre antes do spawn - senão acusaria o processo que já a ocupa.
+    APP_LOG_INFO("DEV", "Aguardando servidor ficar disponível...");
+    const auto deadline = std::chrono::steady_clock::now() + cfg.timeout;
 
-    while (!is_server_responding(cfg.host, cfg.port)) {
-        auto elapsed = std::chrono::steady_clock::now() - start;
-        if (elapsed > cfg.timeout) {
-            std::cerr << "\n[DEV] Timeout: servidor não respondeu em "
-                      << cfg.timeout.count() << " segundos." << std::endl;
-            proc.state = ServerState::Failed;
+    while (true) {
+        if (stop.stop_requested()) {
+            APP_LOG_INFO("DEV", "Espera pelo dev server cancelada.");
             stop_server(proc);
             return false;
         }
+        if (proc.output) {
+            if (auto ready = proc.output->wait_ready(fallback_interval)) {
+                proc.url = ready->url;
+                break;
+            }
+            if (proc.output->is_closed()) {
+                APP_LOG_ERROR("DEV", "O dev server encerrou antes de ficar "
+                                     "disponível.");
+                proc.state = ServerState::Failed;
+                stop_server(proc);
+                return false;
+            }
+        } else {
+            std::this_thread::sleep_for(fallback_interval);
+        }
 
-        // Feedback visual
-        if (++dots % 4 == 0) {
-            std::cout << "." << std::flush;
+        if (!port_busy && is_port_open(cfg.host, cfg.port, probe_timeout)) {
+            proc.url = cfg.dev_url;
+            break;
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        if (std::chrono::steady_clock::now() > deadline) {
+            APP_LOG_ERROR("DEV", "Timeout: servidor não respondeu em ",
+                          cfg.timeout.count(), " segundos.");
+            proc.state = ServerState::Failed;
+            stop_server(proc);
+            return false;
+        }
     }
 
-    std::cout << "\n[DEV] Servidor disponível em " << cfg.dev_url << std::endl;
+    APP_LOG_INFO("DEV", "Servidor disponível em ", proc.url);
     proc.state = ServerState::Running;
     return true;
 }
@@ -0,0 +1,56 @@
+// =============================================================================
+// embedded_resources.cpp - Descompressão e cache dos assets embarcados
+// =============================================================================
+// Não referencia os símbolos gerados (asset_entries): recebe a entrada já
+// resolvida, então a lib continua linkável em builds sem UI embarcada.
+// =============================================================================
+
+#include "embedded_resources.h"
+#include <brotli/decode.h>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace embedded {
+namespace {
+
+std::string decompress_brotli(const AssetEntry &entry) {
+    std::string out(entry.raw_size, '\0');
+    std::size_t decoded_size = out.size();
+    const auto result = BrotliDecoderDecompress(
+        entry.stored_size, entry.data, &decoded_size,
+        reinterpret_cast<std::uint8_t *>(out.data()));
+    if (result != BROTLI_DECODER_RESULT_SUCCESS ||
+        decoded_size != entry.raw_size) {
+        throw std::runtime_error("Falha ao descomprimir asset embarcado: " +
+                                 std::string(entry.path));
+    }
+    return out;
+}
+
+} // namespace
+
+std::string_view contents(const AssetEntry &entry) {
+    if (entry.encoding == Encoding::Identity) {
+        return stored_bytes(entry);
+    }
+
+    // Cache por entrada: unique_ptr mantém o endereço estável mesmo com
+    // rehash, então as views entregues continuam válidas.
+    static std::mutex mu;
+    static std::unordered_map<const AssetEntry *, std::unique_ptr<std::string>>
+        cache;
+
+    std::lock_guard<std::mutex> lock(mu);
+    auto it = cache.find(&entry);
+    if (it == cache.end()) {
+        it = cache
+                 .emplace(&entry, std::make_unique<std::string>(
+                                      decompress_brotli(entry)))
+                 .first;
+    }
+    return *it->second;
+}
+
+} // namespace embedded
@@ -1,6 +1,1158 @@
+#include "app/base64.h"
+#include "app/binary_channel.h"
+#include "app/bindings.h"
+#include "app/blob_store.h"
+#include "app/drag_events.h"
+#include "app/drop_zones.h"
+#include "app/event_channel.h"
+#include "app/executor.h"
+#include "app/job_manager.h"
+#include "app/json_patch.h"
+#include "app/log.h"
+#include "app/main_loop.h"
+#include "app/metrics.h"
+#include "app/resource_server.h"
+#include "app/shutdown_coordinator.h"
+#include "app/stall_watchdog.h"
+#include "app/startup_profiler.h"
+#include "app/state_store.h"
+#include "app/tracing.h"
+#include "app/window_geometry.h"
+#include "dev_server.h"
+#include <functional>
+#include <future>
 #include <gtest/gtest.h>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 
 TEST(SampleTest, BasicAssertions) {
     EXPECT_TRUE(true);
     EXPECT_EQ(1 + 1, 2);
 }
+
+// =============================================================================
+// ResourceServer
+// =============================================================================
+
+namespace {
+
+app::resources::ResourceServer make_server(std::string_view data) {
+    return app::resources::ResourceServer(
+        [data](std::string_view path) -> std::optional<app::resources::Asset> {
+            if (path != "/index.html" && path != "/assets/app.js") {
+                return std::nullopt;
+            }
+            return app::resources::Asset{path, data, "\"abc\""};
+        });
+}
+
+app::resources::Request get(std::string_view path,
+                            std::string_view range = {},
+                            std::string_view if_none_match = {}) {
+    app::resources::Request request;
+    request.path = path;
+    request.range = range;
+    request.if_none_match = if_none_match;
+    return request;
+}
+
+} // namespace
+
+TEST(ResourceServerTest, MapsRootToIndexHtml) {
+    const auto server = make_server("<html></html>");
+    const auto res = server.serve(get("/"));
+    EXPECT_EQ(res.status, 200);
+    EXPECT_EQ(res.mime, "text/html; charset=utf-8");
+    EXPECT_EQ(res.body, "<html></html>");
+}
+
+TEST(ResourceServerTest, RejectsTraversalAndUnknownPaths) {
+    const auto server = make_server("x");
+    EXPECT_EQ(server.serve(get("/../secret")).status, 404);
+    EXPECT_EQ(server.serve(get("/missing.js")).status, 404);
+}
+
+TEST(ResourceServerTest, ReturnsNotModifiedForMatchingEtag) {
+    const auto server = make_server("x");
+    const auto res = server.serve(get("/index.html", {}, "\"abc\""));
+    EXPECT_EQ(res.status, 304);
+    EXPECT_TRUE(res.body.empty());
+}
+
+TEST(ResourceServerTest, HashedAssetsAreImmutable) {
+    const auto server = make_server("x");
+    const auto res = server.serve(get("/assets/app.js"));
+    bool immutable = false;
+    for (const auto &[name, value] : res.headers) {
+        if (name == "Cache-Control") {
+            immutable = value.find("immutable") != std::string::npos;
+        }
+    }
+    EXPECT_TRUE(immutable);
+}
+
+TEST(ResourceServerTest, ServesSatisfiableRange) {
+    const auto server = make_server("0123456789");
+    const auto res = server.serve(get("/index.html", "bytes=2-4"));
+    EXPECT_EQ(res.status, 206);
+    EXPECT_EQ(res.body, "234");
+}
+
+TEST(ResourceServerTest, ParsesSuffixAndOpenRanges) {
+    using app::resources::parse_range;
+    using app::resources::RangeKind;
+    const auto suffix = parse_range("bytes=-3", 10);
+    EXPECT_EQ(suffix.kind, RangeKind::Satisfiable);
+    EXPECT_EQ(suffix.range.first, 7U);
+    const auto open = parse_range("bytes=8-", 10);
+    EXPECT_EQ(open.range.last, 9U);
+    EXPECT_EQ(parse_range("bytes=20-", 10).kind, RangeKind::Unsatisfiable);
+    EXPECT_EQ(parse_range("bytes=1-2,4-5", 10).kind, RangeKind::None);
+}
+
+TEST(ResourceServerTest, AddsIsolationHeadersWhenEnabled) {
+    app::resources::ServerOptions options;
+    options.cross_origin_isolated = true;
+    const app::resources::ResourceServer server(
+        [](std::string_view) { return std::optional<app::resources::Asset>{}; },
+        options);
+    const auto res = server.serve(get("/index.html"));
+    int isolation_headers = 0;
+    for (const auto &[name, value] : res.headers) {
+        if (name == "Cross-Origin-Opener-Policy" ||
+            name == "Cross-Origin-Embedder-Policy") {
+            ++isolation_headers;
+        }
+    }
+    EXPECT_EQ(isolation_headers, 2);
+}
+
+TEST(WindowGeometryIndexTest, TopmostWindowWinsOverlap) {
+    app::WindowGeometryIndex index;
+    index.update("main", {0, 0, 800, 600});
+    index.update("w1", {400, 300, 400, 300});
+    ASSERT_NE(index.hit_test(500, 400), nullptr);
+    EXPECT_EQ(index.hit_test(500, 400)->id, "w1");
+    EXPECT_EQ(index.hit_test(100, 100)->id, "main");
+    EXPECT_EQ(index.hit_test(900, 100), nullptr);
+}
+
+TEST(WindowGeometryIndexTest, RaiseChangesStackingOrder) {
+    app::WindowGeometryIndex index;
+    index.update("main", {0, 0, 800, 600});
+    index.update("w1", {400, 300, 400, 300});
+    EXPECT_TRUE(index.raise("main"));
+    EXPECT_EQ(index.hit_test(500, 400)->id, "main");
+    EXPECT_FALSE(index.raise("main"));
+}
+
+TEST(WindowGeometryIndexTest, UpdatesAndRemovalsRebuildIndex) {
+    app::WindowGeometryIndex index;
+    index.update("w1", {0, 0, 100, 100});
+    EXPECT_FALSE(index.update("w1", {0, 0, 100, 100}));
+    EXPECT_TRUE(index.update("w1", {200, 0, 100, 100}));
+    EXPECT_EQ(index.hit_test(50, 50), nullptr);
+    EXPECT_EQ(index.hit_test(250, 50)->id, "w1");
+    // Borda direita é exclusiva
+    EXPECT_EQ(index.hit_test(300, 50), nullptr);
+    EXPECT_TRUE(index.remove("w1"));
+    EXPECT_EQ(index.hit_test(250, 50), nullptr);
+}
+
+TEST(DragEventsTest, CompleteEventSplicesSharedPayload) {
+    const nlohmann::json layout = {{"panels", {{{"id", "p1"}}}}};
+    const auto payload = app::drag::share_payload(layout);
+    const auto event = nlohmann::json::parse(
+        app::drag::complete_event(7, "main", "w2", payload));
+    EXPECT_EQ(event["type"], "dock.dragComplete");
+    EXPECT_EQ(event["payload"]["dragId"], 7);
+    EXPECT_EQ(event["payload"]["targetWindowId"], "w2");
+    EXPECT_EQ(event["payload"]["dragPayload"], layout);
+}
+
+TEST(DragEventsTest, HoverEventCarriesOnlyIds) {
+    const auto event = nlohmann::json::parse(
+        app::drag::hover_event("dock.dragHover", 3, "main", "w\"1"));
+    EXPECT_EQ(event["payload"]["originWindowId"], "main");
+    EXPECT_EQ(event["payload"]["targetWindowId"], "w\"1");
+    EXPECT_FALSE(event["payload"].contains("dragPayload"));
+    EXPECT_EQ(app::drag::share_payload(nullptr), nullptr);
+}
+
+TEST(DropZonesTest, ResolvesEdgesAndCenter) {
+    using app::dock::DropZone;
+    const std::vector<app::dock::DropTarget> targets = {
+        {"p1", {0, 0, 400, 200}}};
+    EXPECT_EQ(app::dock::compute_drop_zone(targets, 10, 100).zone,
+              DropZone::Left);
+    EXPECT_EQ(app::dock::compute_drop_zone(targets, 390, 100).zone,
+              DropZone::Right);
+    EXPECT_EQ(app::dock::compute_drop_zone(targets, 200, 5).zone,
+              DropZone::Top);
+    EXPECT_EQ(app::dock::compute_drop_zone(targets, 200, 190).zone,
+              DropZone::Bottom);
+    EXPECT_EQ(app::dock::compute_drop_zone(targets, 200, 100).zone,
+              DropZone::Center);
+    EXPECT_EQ(app::dock::compute_drop_zone(targets, 500, 100).target, nullptr);
+}
+
+TEST(DropZonesTest, LaterTargetsAreOnTop) {
+    const std::vector<app::dock::DropTarget> targets = {
+        {"docked", {0, 0, 400, 400}}, {"floating", {100, 100, 100, 100}}};
+    const auto hit = app::dock::compute_drop_zone(targets, 150, 150);
+    ASSERT_NE(hit.target, nullptr);
+    EXPECT_EQ(hit.target->id, "floating");
+    EXPECT_EQ(app::dock::to_string(hit.zone), "center");
+}
+
+TEST(ShutdownCoordinatorTest, RunsPhasesInOrderAndTimesOutWaits) {
+    using namespace std::chrono_literals;
+    auto now = app::ShutdownCoordinator::Clock::time_point{};
+    app::ShutdownCoordinator shutdown(100ms, [&now] { return now; });
+    std::vector<std::string> order;
+    bool acked = false;
+    shutdown.add_phase({"stop-calls", [&] { order.push_back("stop"); }});
+    shutdown.add_phase({"persist-state", [&] { order.push_back("persist"); },
+                        [&] { return acked; }});
+    shutdown.add_phase({"never", {}, [] { return false; }, 20ms});
+
+    EXPECT_FALSE(shutdown.step());
+    now += 10ms;
+    acked = true;
+    EXPECT_FALSE(shutdown.step()); // "never" começa agora
+    now += 25ms;
+    EXPECT_TRUE(shutdown.step());
+
+    EXPECT_EQ(order, (std::vector<std::string>{"stop", "persist"}));
+    const auto &report = shutdown.report();
+    ASSERT_EQ(report.size(), 3u);
+    EXPECT_EQ(report[1].duration, 10ms);
+    EXPECT_FALSE(report[1].timed_out);
+    EXPECT_TRUE(report[2].timed_out);
+    EXPECT_NE(shutdown.summary().find("never 25.0ms (timeout)"),
+              std::string::npos);
+}
+
+TEST(ShutdownCoordinatorTest, GateRejectsCallsOnceClosed) {
+    app::CallGate gate;
+    {
+        auto ticket = gate.try_enter();
+        ASSERT_TRUE(ticket);
+        gate.close();
+        EXPECT_EQ(gate.in_flight(), 1u);
+        EXPECT_FALSE(gate.try_enter());
+    }
+    EXPECT_EQ(gate.in_flight(), 0u);
+    EXPECT_TRUE(gate.wait_idle(std::chrono::steady_clock::now()));
+}
+
+TEST(DevServerTest, ParsesViteLocalLine) {
+    EXPECT_FALSE(dev::parse_vite_ready_line("  VITE v5.4.0  ready in 312 ms"));
+    const auto info = dev::parse_vite_ready_line(
+        "  \x1b[32m➜\x1b[39m  \x1b[1mLocal\x1b[22m:   "
+        "\x1b[36mhttp://127.0.0.1:\x1b[1m5174\x1b[22m/\x1b[39m");
+    ASSERT_TRUE(info);
+    EXPECT_EQ(info->url, "http://127.0.0.1:5174");
+    EXPECT_EQ(info->host, "127.0.0.1");
+    EXPECT_EQ(info->port, 5174);
+
+    const auto ipv6 =
+        dev::parse_vite_ready_line("  ➜  Local:   http://[::1]:5173/");
+    ASSERT_TRUE(ipv6);
+    EXPECT_EQ(ipv6->host, "[::1]");
+    EXPECT_EQ(ipv6->port, 5173);
+}
+
+TEST(StartupProfilerTest, DisabledProfilerRecordsNothing) {
+    app::StartupProfiler profiler;
+    {
+        app::StartupProfiler::Scope span(&profiler, "create-webview");
+    }
+    profiler.mark("navigate");
+    EXPECT_EQ(profiler.size(), 0u);
+}
+
+TEST(StartupProfilerTest, ExportsSortedChromeTrace) {
+    using namespace std::chrono_literals;
+    const auto origin = app::StartupProfiler::Clock::now();
+    app::StartupProfiler profiler(true, origin);
+    profiler.span("dev-server", origin + 1ms, origin + 9ms,
+                  app::StartupProfiler::DevServer);
+    profiler.span("create-webview", origin, origin + 3ms);
+
+    const auto entries = profiler.entries();
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].name, "create-webview");
+
+    const auto trace = nlohmann::json::parse(app::trace::to_chrome_trace(
+        profiler.chrome_events(), app::StartupProfiler::thread_names()));
+    const auto &events = trace["traceEvents"];
+    ASSERT_EQ(events.size(), 5u); // 3 nomes de thread + 2 spans
+    EXPECT_EQ(events[3]["ph"], "X");
+    EXPECT_EQ(events[4]["name"], "dev-server");
+    EXPECT_EQ(events[4]["ts"], 1000);
+    EXPECT_EQ(events[4]["dur"], 8000);
+    EXPECT_EQ(events[4]["tid"], 2);
+}
+
+// =============================================================================
+// Tracing
+// =============================================================================
+
+namespace {
+
+std::vector<app::trace::ChromeEvent>
+trace_events(std::string_view category) {
+    std::vector<app::trace::ChromeEvent> found;
+    for (auto &event : app::trace::snapshot()) {
+        if (event.category == category) {
+            found.push_back(std::move(event));
+        }
+    }
+    return found;
+}
+
+} // namespace
+
+TEST(TracingTest, RecordsSpansAndCountersOnlyWhenEnabled) {
+    { APP_TRACE_SPAN("test.off", "ignored"); }
+    app::trace::counter("test.off", "ignored", 1);
+    EXPECT_TRUE(trace_events("test.off").empty());
+
+    app::trace::set_enabled(true);
+    std::thread([] {
+        app::trace::set_thread_name("worker");
+        { APP_TRACE_SPAN("test.on", "span"); }
+        app::trace::counter("test.on", "queue", 7);
+    }).join();
+    app::trace::set_enabled(false);
+
+    const auto events = trace_events("test.on");
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].phase, 'X');
+    EXPECT_EQ(events[0].name, "span");
+    EXPECT_EQ(events[1].phase, 'C');
+    EXPECT_EQ(events[1].args["value"], 7);
+
+    app::trace::ThreadNames names;
+    (void)app::trace::snapshot(&names);
+    EXPECT_NE(std::find(names.begin(), names.end(),
+                        std::make_pair(events[0].tid, std::string("worker"))),
+              names.end());
+}
+
+TEST(TracingTest, RingKeepsMostRecentEvents) {
+    app::trace::set_enabled(true);
+    std::thread([] {
+        for (std::size_t i = 0; i < app::trace::RING_CAPACITY + 10; ++i) {
+            app::trace::counter("test.ring", "i",
+                                static_cast<std::int64_t>(i));
+        }
+    }).join();
+    app::trace::set_enabled(false);
+
+    const auto events = trace_events("test.ring");
+    // O slot mais antigo é descartado: poderia estar sendo reescrito
+    ASSERT_EQ(events.size(), app::trace::RING_CAPACITY - 1);
+    EXPECT_EQ(events.back().args["value"],
+              app::trace::RING_CAPACITY + 9);
+}
+
+// =============================================================================
+// Metrics
+// =============================================================================
+
+TEST(MetricsTest, HistogramPercentilesWithinBucketPrecision) {
+    app::metrics::LatencyHistogram histogram;
+    for (std::uint64_t us = 1; us <= 1000; ++us) {
+        histogram.record(std::chrono::microseconds(us));
+    }
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.max(), 1'000'000u);
+
+    // Limite superior do bucket: nunca abaixo do valor exato, no máximo ~3%
+    // acima dele
+    const auto p50 = static_cast<double>(histogram.percentile(0.50));
+    const auto p99 = static_cast<double>(histogram.percentile(0.99));
+    EXPECT_GE(p50, 500'000.0);
+    EXPECT_LE(p50, 500'000.0 * 1.04);
+    EXPECT_GE(p99, 990'000.0);
+    EXPECT_LE(p99, 990'000.0 * 1.04);
+    EXPECT_EQ(histogram.percentile(1.0), 1'000'000u);
+    EXPECT_EQ(app::metrics::LatencyHistogram{}.percentile(0.5), 0u);
+}
+
+TEST(MetricsTest, BindingMetricsCountErrorsByCode) {
+    app::metrics::Registry registry;
+    auto &binding = registry.binding("openFile");
+    binding.calls.add(3);
+    binding.request_bytes.add(42);
+    binding.record_error(400);
+    binding.record_error(500);
+    binding.record_error(400);
+    binding.latency.record(std::chrono::microseconds(250));
+    EXPECT_EQ(&registry.binding("openFile"), &binding);
+
+    const auto json = registry.to_json()["bindings"]["openFile"];
+    EXPECT_EQ(json["calls"], 3);
+    EXPECT_EQ(json["errors"], 3);
+    EXPECT_EQ(json["errorsByCode"]["400"], 2);
+    EXPECT_EQ(json["errorsByCode"]["500"], 1);
+    EXPECT_EQ(json["requestBytes"], 42);
+
+    const std::string text = registry.to_text();
+    EXPECT_NE(text.find("binding_errors{binding=\"openFile\",code=\"400\"} 2"),
+              std::string::npos);
+    EXPECT_NE(text.find("binding_latency_us_count{binding=\"openFile\"} 1"),
+              std::string::npos);
+}
+
+// =============================================================================
+// StallWatchdog
+// =============================================================================
+
+TEST(StallWatchdogTest, AttributesStallToRunningTask) {
+    using namespace std::chrono_literals;
+    app::StallWatchdog watchdog(100ms);
+    const auto t0 = app::StallWatchdog::Clock::now();
+    EXPECT_FALSE(watchdog.check(t0 + 1s)); // sem heartbeat: desarmado
+
+    watchdog.heartbeat(t0);
+    EXPECT_FALSE(watchdog.check(t0 + 80ms));
+    {
+        app::watchdog::TaskScope outer("dispatch");
+        app::watchdog::TaskScope inner("openFile");
+        EXPECT_TRUE(watchdog.check(t0 + 150ms));
+        EXPECT_FALSE(watchdog.check(t0 + 300ms)); // mesmo travamento
+    }
+    EXPECT_EQ(app::watchdog::current_task.load(), nullptr);
+    watchdog.heartbeat(t0 + 400ms);
+
+    const auto stalls = watchdog.stalls();
+    ASSERT_EQ(stalls.size(), 1u);
+    EXPECT_EQ(stalls[0].task, "openFile");
+    EXPECT_FALSE(stalls[0].ongoing);
+    EXPECT_EQ(stalls[0].duration, 400ms);
+
+    // Gap de frame sobreposto ao travamento herda a tarefa
+    watchdog.record_frame_gap("main", 350.0, t0 + 420ms);
+    watchdog.record_frame_gap("main", 120.0, t0 + 2s);
+    const auto gaps = watchdog.frame_gaps();
+    ASSERT_EQ(gaps.size(), 2u);
+    EXPECT_EQ(gaps[0].task, "openFile");
+    EXPECT_EQ(gaps[1].task, "");
+}
+
+// =============================================================================
+// Log assíncrono
+// =============================================================================
+
+TEST(LogTest, FormatsOnWriterThreadAndRateLimitsPerSite) {
+    std::mutex mu;
+    std::vector<std::string> lines;
+    app::log::set_sink([&](app::log::Level, std::string_view line) {
+        std::lock_guard<std::mutex> lock(mu);
+        lines.emplace_back(line);
+    });
+
+    std::string text = "original";
+    APP_LOG_INFO("TEST", "valor ", 42, " texto ", std::string_view(text));
+    text = "alterado"; // o registro guardou uma cópia
+    APP_LOG_DEBUG("TEST", "abaixo do nível");
+    for (int i = 0; i < 30; ++i) {
+        APP_LOG_WARN("TEST", "repetida ", i);
+    }
+    app::log::flush();
+    app::log::set_sink(nullptr);
+
+    ASSERT_EQ(lines.size(), 1 + app::log::RATE_BURST);
+    EXPECT_EQ(lines[0], "[TEST] valor 42 texto original");
+    EXPECT_EQ(lines[1], "[TEST] repetida 0");
+}
+
+TEST(LogTest, SiteLimiterReportsSuppressedCount) {
+    app::log::SiteLimiter limiter;
+    const std::int64_t second = 1'000'000'000;
+    for (std::uint32_t i = 0; i < app::log::RATE_BURST; ++i) {
+        EXPECT_EQ(limiter.admit(10 * second), 0);
+    }
+    EXPECT_EQ(limiter.admit(10 * second), -1);
+    EXPECT_EQ(limiter.admit(10 * second), -1);
+    EXPECT_EQ(limiter.admit(11 * second), 2); // nova janela
+}
+
+TEST(ExecutorTest, RunsByLanePriorityAndSkipsCancelledTasks) {
+    app::Executor executor(1);
+    std::promise<void> release;
+    auto gate = release.get_future().share();
+    auto blocker = executor.submit(app::Lane::Normal, "blocker",
+                                   [gate] { gate.wait(); });
+
+    std::mutex mu;
+    std::vector<std::string> order;
+    auto record = [&](const char *name) {
+        return [&, name] {
+            std::lock_guard<std::mutex> lock(mu);
+            order.emplace_back(name);
+        };
+    };
+    // Espera o worker pegar o bloqueio antes de enfileirar o resto
+    while (executor.queue_depth(app::Lane::Normal) != 0) {
+        std::this_thread::yield();
+    }
+    auto background = executor.submit(app::Lane::Background, "background",
+                                      record("background"));
+    auto normal =
+        executor.submit(app::Lane::Normal, "normal", record("normal"));
+    auto high = executor.submit(app::Lane::High, "high", record("high"));
+    auto cancelled =
+        executor.submit(app::Lane::High, "cancelled", record("cancelled"));
+    cancelled.cancel();
+    EXPECT_TRUE(cancelled.done());
+
+    release.set_value();
+    background.wait();
+    normal.wait();
+    high.wait();
+    blocker.wait();
+    EXPECT_EQ(order,
+              (std::vector<std::string>{"high", "normal", "background"}));
+}
+
+TEST(ExecutorTest, TimerWheelFiresDelayedAndPeriodicTasks) {
+    using namespace std::chrono_literals;
+    app::Executor executor(2);
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<std::chrono::steady_clock::time_point> fired{};
+    auto delayed = executor.schedule_after(
+        30ms, app::Lane::Normal, "delayed",
+        [&] { fired.store(std::chrono::steady_clock::now()); });
+
+    std::atomic<int> runs{0};
+    auto periodic = executor.schedule_periodic(
+        5ms, app::Lane::Background, "periodic",
+        [&](std::stop_token) -> std::optional<std::chrono::milliseconds> {
+            if (++runs == 3) {
+                return std::nullopt;
+            }
+            return 5ms;
+        });
+
+    std::atomic<int> ticks{0};
+    auto cancelled = executor.schedule_periodic(
+        1ms, app::Lane::High, "until-cancel",
+        [&](std::stop_token) -> std::optional<std::chrono::milliseconds> {
+            ++ticks;
+            return 1ms;
+        });
+
+    delayed.wait();
+    periodic.wait();
+    EXPECT_GE(fired.load() - start, 30ms);
+    EXPECT_EQ(runs.load(), 3);
+
+    EXPECT_GT(ticks.load(), 0);
+    cancelled.cancel();
+    cancelled.wait();
+    const int after_cancel = ticks.load();
+    std::this_thread::sleep_for(10ms);
+    EXPECT_EQ(ticks.load(), after_cancel);
+}
+
+namespace {
+
+// Coleta os eventos jobs.update (thread do pool) por job
+struct JobEvents {
+    std::mutex mu;
+    std::vector<nlohmann::json> batches;
+    std::vector<std::string> windows;
+
+    app::JobManager::Sink sink() {
+        return [this](const std::string &window_id, std::string event) {
+            std::lock_guard<std::mutex> lock(mu);
+            windows.push_back(window_id);
+            batches.push_back(nlohmann::json::parse(event));
+        };
+    }
+
+    std::vector<nlohmann::json> updates_for(const std::string &id) {
+        std::lock_guard<std::mutex> lock(mu);
+        std::vector<nlohmann::json> out;
+        for (const auto &batch : batches) {
+            for (const auto &job : batch["jobs"]) {
+                if (job["id"] == id) {
+                    out.push_back(job);
+                }
+            }
+        }
+        return out;
+    }
+};
+
+void wait_until_idle(app::JobManager &jobs) {
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (jobs.active() != 0 && std::chrono::steady_clock::now() < end) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    jobs.flush();
+}
+
+} // namespace
+
+TEST(JobManagerTest, CoalescesProgressIntoFrameBatches) {
+    app::Executor executor(2);
+    app::JobManager jobs(executor);
+    JobEvents events;
+    jobs.set_sink(events.sink());
+    jobs.register_kind("count", [](const nlohmann::json &params,
+                                   app::JobContext &job) {
+        const int total = params.value("total", 0);
+        for (int i = 1; i <= total; ++i) {
+            job.progress(static_cast<double>(i) / total);
+        }
+        return nlohmann::json{{"counted", total}};
+    });
+    EXPECT_FALSE(jobs.start("main", "unknown", nullptr));
+
+    const auto id = jobs.start("main", "count", {{"total", 100000}});
+    ASSERT_TRUE(id);
+    wait_until_idle(jobs);
+
+    const auto updates = events.updates_for(*id);
+    ASSERT_FALSE(updates.empty());
+    EXPECT_LT(updates.size(), 100u); // um por frame, não por progress()
+    EXPECT_EQ(updates.back()["state"], "completed");
+    EXPECT_EQ(updates.back()["result"]["counted"], 100000);
+    EXPECT_EQ(updates.back()["progress"], 1.0);
+    EXPECT_TRUE(jobs.list().empty()); // terminados saem após o envio
+}
+
+TEST(JobManagerTest, CancelsJobsOfClosedWindow) {
+    app::Executor executor(1);
+    app::JobManager jobs(executor);
+    JobEvents events;
+    jobs.set_sink(events.sink());
+    jobs.register_kind("wait", [](const nlohmann::json &,
+                                  app::JobContext &job) {
+        while (!job.cancelled()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return nlohmann::json();
+    });
+
+    // Com um worker, o segundo job da janela fica na fila
+    const auto running = jobs.start("w1", "wait", nullptr);
+    const auto queued = jobs.start("w1", "wait", nullptr);
+    const auto other = jobs.start("w2", "wait", nullptr);
+    ASSERT_TRUE(running && queued && other);
+    EXPECT_EQ(jobs.list().size(), 3u);
+
+    EXPECT_EQ(jobs.cancel_window("w1"), 2u);
+    EXPECT_TRUE(jobs.cancel(*other));
+    wait_until_idle(jobs);
+    EXPECT_FALSE(jobs.cancel(*other)); // já terminou
+
+    for (const auto &id : {*running, *queued, *other}) {
+        const auto updates = events.updates_for(id);
+        ASSERT_FALSE(updates.empty());
+        EXPECT_EQ(updates.back()["state"], "cancelled");
+    }
+    std::lock_guard<std::mutex> lock(events.mu);
+    for (std::size_t i = 0; i < events.batches.size(); ++i) {
+        for (const auto &job : events.batches[i]["jobs"]) {
+            const bool ours = job["id"] == *other;
+            EXPECT_EQ(events.windows[i] == "w2", ours);
+        }
+    }
+}
+
+#if !defined(_WIN32)
+TEST(FdReactorTest, DeliversEdgeTriggeredReadinessOnMainLoop) {
+    if (!app::has_ui_main_loop()) {
+        GTEST_SKIP() << "sem main loop nesta plataforma";
+    }
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    std::string received;
+    int calls = 0;
+    // Drena tudo a cada aviso (edge-triggered), em reads de 4 bytes
+    auto on_ready = [&](unsigned events) {
+        ++calls;
+        char buffer[4];
+        ssize_t n = 0;
+        while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) {
+            received.append(buffer, static_cast<std::size_t>(n));
+        }
+        return (events & app::FdHangup) == 0;
+    };
+    const auto watch = app::add_fd_watch(fds[0], app::FdReadable, on_ready);
+    ASSERT_NE(watch, 0u);
+
+    const auto pump_until = [](const std::function<bool()> &done) {
+        const auto end =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+        while (!done() && std::chrono::steady_clock::now() < end) {
+            app::drain_ui_queue(std::chrono::steady_clock::now() +
+                                std::chrono::milliseconds(10));
+        }
+    };
+    ASSERT_EQ(write(fds[1], "hello reactor", 13), 13);
+    pump_until([&] { return received.size() == 13; });
+    EXPECT_EQ(received, "hello reactor");
+    EXPECT_EQ(calls, 1);
+
+    // Hangup: o callback retorna false e o watch se desarma
+    close(fds[1]);
+    pump_until([&] { return calls == 2; });
+    EXPECT_EQ(calls, 2);
+    app::remove_fd_watch(watch); // já removido: no-op
+    close(fds[0]);
+}
+#endif
+
+// =============================================================================
+// EventChannel
+// =============================================================================
+
+TEST(EventChannelTest, QueuesCoalescesAndDropsWithoutCredits) {
+    std::vector<std::string> sent;
+    app::EventChannel channel(
+        [&sent](std::string event) { sent.push_back(std::move(event)); }, 2);
+
+    EXPECT_TRUE(channel.push("message", app::EventPolicy::Reliable,
+                             R"({"type":"message","n":1})"));
+    EXPECT_TRUE(channel.push("message", app::EventPolicy::Reliable, "{}"));
+    ASSERT_EQ(sent.size(), 2u);
+    EXPECT_EQ(sent[0], R"({"seq":1,"type":"message","n":1})");
+    EXPECT_EQ(sent[1], R"({"seq":2})");
+
+    // Sem créditos: fila, coalescência (último valor, no fim) e descarte
+    EXPECT_FALSE(
+        channel.push("zone", app::EventPolicy::Coalesce, R"({"z":1})"));
+    EXPECT_FALSE(channel.push("message", app::EventPolicy::Reliable,
+                              R"({"m":3})"));
+    EXPECT_FALSE(
+        channel.push("zone", app::EventPolicy::Coalesce, R"({"z":2})"));
+    EXPECT_FALSE(channel.push("cursor", app::EventPolicy::Drop, R"({"c":1})"));
+    auto stats = channel.stats();
+    EXPECT_EQ(stats.in_flight, 2u);
+    EXPECT_EQ(stats.queued, 2u);
+    EXPECT_EQ(stats.coalesced, 1u);
+    EXPECT_EQ(stats.dropped, 1u);
+    EXPECT_EQ(sent.size(), 2u);
+
+    // Tipo lido só do prefixo dos eventos montados à mão
+    EXPECT_EQ(app::raw_event_type(R"({"type":"dock.dropZone","payload":{}})"),
+              "dock.dropZone");
+    EXPECT_EQ(app::raw_event_type(R"({"jobs":[],"type":"jobs.update"})"), "");
+    EXPECT_EQ(app::event_policy("dock.dragCursor"), app::EventPolicy::Drop);
+}
+
+TEST(EventChannelTest, AcksReleaseQueueInOrderAndRecordLatency) {
+    // Métricas agregadas: compara com o que os outros canais já deixaram
+    auto &queued = app::metrics::registry().gauge("events_queued");
+    auto &acks = app::metrics::registry().histogram("events_ack");
+    const auto queued_before = queued.value();
+    const auto acks_before = acks.count();
+
+    std::vector<std::string> sent;
+    app::EventChannel channel(
+        [&sent](std::string event) { sent.push_back(std::move(event)); }, 1);
+    channel.push("a", app::EventPolicy::Reliable, R"({"v":"a"})");
+    channel.push("b", app::EventPolicy::Reliable, R"({"v":"b"})");
+    channel.push("c", app::EventPolicy::Reliable, R"({"v":"c"})");
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(queued.value(), queued_before + 2);
+
+    EXPECT_EQ(channel.ack(7), 1u); // seq além do enviado: confirma o que há
+    ASSERT_EQ(sent.size(), 2u);
+    EXPECT_EQ(sent[1], R"({"seq":2,"v":"b"})");
+    EXPECT_EQ(channel.ack(1), 0u); // ack velho: nada muda
+
+    // Página recarregada: o em voo se perde e a fila segue
+    EXPECT_EQ(channel.ack(0), 1u);
+    ASSERT_EQ(sent.size(), 3u);
+    EXPECT_EQ(sent[2], R"({"seq":3,"v":"c"})");
+    EXPECT_EQ(channel.stats().acked, 1u);
+    EXPECT_EQ(acks.count(), acks_before + 1);
+    EXPECT_EQ(queued.value(), queued_before);
+}
+
+TEST(EventChannelTest, ClosedChannelLeavesQueuedMetric) {
+    auto &queued = app::metrics::registry().gauge("events_queued");
+    const auto before = queued.value();
+    {
+        app::EventChannel channel([](std::string) {}, 1);
+        channel.push("a", app::EventPolicy::Reliable, R"({"v":"a"})");
+        channel.push("b", app::EventPolicy::Reliable, R"({"v":"b"})");
+        EXPECT_EQ(queued.value(), before + 1);
+    }
+    EXPECT_EQ(queued.value(), before);
+}
+
+// =============================================================================
+// Bindings - Stream
+// =============================================================================
+
+TEST(BindingStreamTest, DeliversRangeInByteBoundedChunks) {
+    app::bindings::StreamRegistry streams;
+    std::vector<int> values(1000);
+    for (int i = 0; i < 1000; ++i) {
+        values[static_cast<std::size_t>(i)] = i;
+    }
+    int generated = 0;
+    auto source = app::bindings::Stream::from_range(std::move(values));
+    app::bindings::Stream counted([&]() {
+        auto item = source.next();
+        generated += item ? 1 : 0;
+        return item;
+    });
+
+    auto first =
+        nlohmann::json::parse(*streams.open(std::move(counted), 64).text);
+    ASSERT_FALSE(first["done"].get<bool>());
+    const auto id = first["stream"].get<std::string>();
+    // Pull sob demanda: só o primeiro bloco foi gerado
+    EXPECT_EQ(static_cast<std::size_t>(generated), first["items"].size());
+    EXPECT_EQ(streams.open_count(), 1u);
+
+    std::vector<int> received = first["items"].get<std::vector<int>>();
+    for (bool done = false; !done;) {
+        auto chunk = nlohmann::json::parse(*streams.pull(id, 512).text);
+        EXPECT_LE(chunk["items"].dump().size(), 512u + 8u);
+        for (const auto &item : chunk["items"]) {
+            received.push_back(item.get<int>());
+        }
+        done = chunk["done"].get<bool>();
+    }
+    ASSERT_EQ(received.size(), 1000u);
+    EXPECT_EQ(received.back(), 999);
+    EXPECT_EQ(streams.open_count(), 0u);
+    EXPECT_THROW((void)streams.pull(id), app::bindings::BindingError);
+}
+
+TEST(BindingStreamTest, SmallResultsFinishInlineAndCloseReleases) {
+    app::bindings::StreamRegistry streams;
+    auto letters = app::bindings::Stream::from_range(
+        std::vector<std::string>{"a", "b"});
+    auto small =
+        nlohmann::json::parse(*streams.open(std::move(letters)).text);
+    EXPECT_TRUE(small["stream"].is_null());
+    EXPECT_TRUE(small["done"].get<bool>());
+    EXPECT_EQ(small["items"], nlohmann::json::array({"a", "b"}));
+
+    auto endless = app::bindings::Stream([n = 0]() mutable {
+        return std::optional<nlohmann::json>(n++);
+    });
+    auto first = nlohmann::json::parse(*streams.open(std::move(endless)).text);
+    EXPECT_FALSE(first["done"].get<bool>());
+    EXPECT_TRUE(streams.close(first["stream"].get<std::string>()));
+    EXPECT_EQ(streams.open_count(), 0u);
+}
+
+// =============================================================================
+// BlobStore
+// =============================================================================
+
+TEST(BlobStoreTest, DedupesContentAndCountsReferencesPerWindow) {
+    app::BlobStore store;
+    const auto a = store.put("w1", "snapshot", "application/json").handle;
+    const auto b = store.put("w2", "snapshot", "text/plain");
+    EXPECT_EQ(b.handle, a); // mesmo conteúdo, mesmo handle
+    EXPECT_EQ(b.mime, "application/json"); // vale o mime do primeiro put
+    EXPECT_NE(store.put("w1", "other").handle, a);
+    EXPECT_EQ(store.stats().blobs, 2u);
+
+    EXPECT_TRUE(store.retain("w3", a));
+    EXPECT_EQ(store.release_owner("w2"), 1u);
+    EXPECT_FALSE(store.release("w2", a)); // w2 não tem mais referência
+    EXPECT_TRUE(store.release("w1", a));
+    EXPECT_TRUE(store.release("w3", a));
+    // Sem referências continua como cache até o LRU
+    auto blob = store.get(a);
+    ASSERT_TRUE(blob);
+    EXPECT_EQ(*blob->data, "snapshot");
+    EXPECT_EQ(blob->mime, "application/json");
+
+    // Servido por app:// sem cópia, com o buffer preso na resposta
+    const std::string path = std::string(app::BLOB_PATH_PREFIX) + a;
+    auto asset = app::blob_asset(store, path);
+    ASSERT_TRUE(asset);
+    EXPECT_EQ(asset->data.data(), blob->data->data());
+    EXPECT_TRUE(asset->immutable);
+    EXPECT_FALSE(app::blob_asset(store, "/__blobs/../index.html"));
+
+    const std::string bytes("\x00\xff binary\x01", 10);
+    EXPECT_EQ(app::base64_decode(app::base64_encode(bytes)), bytes);
+    EXPECT_FALSE(app::base64_decode("not base64!"));
+}
+
+TEST(BlobStoreTest, EvictsUnreferencedThenSpillsReferencedOverCap) {
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("blob-test-" + std::to_string(::getpid()));
+    {
+        app::BlobStore store({.memory_cap = 100, .spill_dir = dir});
+        const auto cached = store.put("w1", std::string(40, 'a')).handle;
+        ASSERT_TRUE(store.release("w1", cached));
+        const auto kept = store.put("w1", std::string(40, 'b')).handle;
+        const auto recent = store.put("w1", std::string(40, 'c')).handle;
+
+        // 120 > 100: o sem referência sai primeiro
+        auto stats = store.stats();
+        EXPECT_EQ(stats.evictions, 1u);
+        EXPECT_EQ(stats.memory_bytes, 80u);
+        EXPECT_FALSE(store.get(cached));
+
+        // Mais um: o referenciado mais antigo vai para o disco
+        store.put("w1", std::string(40, 'd'));
+        stats = store.stats();
+        EXPECT_EQ(stats.spills, 1u);
+        EXPECT_EQ(stats.spilled_bytes, 40u);
+        EXPECT_TRUE(std::filesystem::exists(dir / (kept + ".blob")));
+
+        // E volta no get (empurrando o próximo do LRU)
+        auto blob = store.get(kept);
+        ASSERT_TRUE(blob);
+        EXPECT_EQ(*blob->data, std::string(40, 'b'));
+        stats = store.stats();
+        EXPECT_EQ(stats.loads, 1u);
+        EXPECT_EQ(stats.spilled_blobs, 1u);
+        EXPECT_TRUE(std::filesystem::exists(dir / (recent + ".blob")));
+    }
+    // O destrutor limpa os arquivos de spill
+    EXPECT_TRUE(std::filesystem::is_empty(dir));
+    std::filesystem::remove_all(dir);
+}
+
+// =============================================================================
+// Binary channel
+// =============================================================================
+
+TEST(BinaryChannelTest, Base64MatchesRfcVectorsAndRejectsGarbage) {
+    const std::pair<std::string_view, std::string_view> vectors[] = {
+        {"", ""},         {"f", "Zg=="},         {"fo", "Zm8="},
+        {"foo", "Zm9v"},  {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="},
+        {"foobar", "Zm9vYmFy"}};
+    for (const auto &[plain, encoded] : vectors) {
+        EXPECT_EQ(app::base64_encode(plain), encoded);
+        EXPECT_EQ(app::base64_decode(encoded), std::string(plain));
+    }
+    std::string all(256, '\0');
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        all[i] = static_cast<char>(i);
+    }
+    EXPECT_EQ(app::base64_decode(app::base64_encode(all)), all);
+    EXPECT_FALSE(app::base64_decode("Zm9v!mFy"));
+    EXPECT_FALSE(app::base64_decode("Zm9vY"));
+}
+
+TEST(BinaryChannelTest, SchemeEndpointCallsHandlerWithRawBytes) {
+    app::bindings::binary_registry().add(
+        "testReverse", [](std::span<const std::byte> in) {
+            return std::vector<std::byte>(in.rbegin(), in.rend());
+        });
+    app::resources::ServerOptions options;
+    options.dynamic = &app::bindings::serve_binary;
+    const app::resources::ResourceServer server(
+        [](std::string_view) { return std::nullopt; }, options);
+
+    const std::string body("\x01\x00\xff", 3);
+    app::resources::Request request;
+    request.method = "POST";
+    request.path = "/__binary/testReverse";
+    request.body = body;
+    const auto response = server.serve(request);
+    EXPECT_EQ(response.status, 200);
+    EXPECT_EQ(response.mime, "application/octet-stream");
+    EXPECT_EQ(response.body, std::string("\xff\x00\x01", 3));
+    EXPECT_TRUE(response.owner);
+
+    request.method = "GET";
+    EXPECT_EQ(server.serve(request).status, 405);
+    request.method = "POST";
+    request.path = "/__binary/missing";
+    EXPECT_EQ(server.serve(request).status, 404);
+}
+
+// =============================================================================
+// State store
+// =============================================================================
+
+TEST(StateStoreTest, SubscribersReceivePatchDeltasForTheirPrefixes) {
+    using json = nlohmann::json;
+    app::StateStore store;
+    std::vector<std::pair<std::string, json>> events;
+    store.set_sink([&](const std::string &window, std::string event) {
+        EXPECT_EQ(app::raw_event_type(event), "state.delta");
+        events.emplace_back(window, json::parse(event));
+    });
+    store.set("layout/main", {{"panels", {"a", "b"}}, {"width", 800}});
+    store.set("prefs/theme", "dark");
+
+    const auto snapshot = json::parse(store.subscribe("w1", "layout/"));
+    EXPECT_EQ(snapshot["version"], 2);
+    EXPECT_EQ(snapshot["entries"].size(), 1U);
+    json local = snapshot["entries"]["layout/main"]["value"];
+
+    const json next = {{"panels", {"a", "b", "c"}}, {"width", 800}};
+    EXPECT_EQ(store.set("layout/main", next), 3U);
+    EXPECT_EQ(store.set("layout/main", next), 3U); // sem mudança, sem delta
+    store.set("prefs/theme", "light");             // fora do prefixo
+    EXPECT_EQ(store.get("prefs/theme"), json("light"));
+    EXPECT_FALSE(store.get("prefs/missing"));
+    ASSERT_EQ(events.size(), 1U);
+    const json &delta = events[0].second;
+    EXPECT_EQ(events[0].first, "w1");
+    EXPECT_EQ(delta["base"], 1);
+    EXPECT_EQ(delta["version"], 3);
+    EXPECT_EQ(delta["patch"].size(), 1U); // só o painel novo
+    EXPECT_EQ(local.patch(delta["patch"]), next);
+
+    EXPECT_EQ(store.erase("layout/main"), 5U);
+    ASSERT_EQ(events.size(), 2U);
+    EXPECT_TRUE(events[1].second["deleted"]);
+    store.remove_window("w1");
+    store.set("layout/other", 1);
+    EXPECT_EQ(events.size(), 2U);
+}
+
+TEST(StateStoreTest, ErasePrefixRemovesOnlyItsKeys) {
+    using json = nlohmann::json;
+    app::StateStore store;
+    std::vector<json> events;
+    store.set_sink([&](const std::string &, std::string event) {
+        events.push_back(json::parse(event));
+    });
+    store.set("dock/inbox/w1/a", 1);
+    store.set("dock/inbox/w1/b", 2);
+    store.set("dock/inbox/w10/a", 3);
+    (void)store.subscribe("w1", "dock/inbox/w1/");
+
+    EXPECT_EQ(store.erase_prefix("dock/inbox/w1/"), 2U);
+    ASSERT_EQ(events.size(), 2U);
+    EXPECT_TRUE(events[0]["deleted"]);
+    EXPECT_EQ(events[1]["key"], "dock/inbox/w1/b");
+    EXPECT_EQ(store.stats().keys, 1U);
+    EXPECT_EQ(store.erase_prefix("dock/inbox/w1/"), 0U);
+}
+
+TEST(StateStoreTest, SinceReplaysLogUntilTruncatedThenResyncs) {
+    using json = nlohmann::json;
+    app::StateStore store;
+    store.set("a/x", 1);
+    store.set("b/y", 1);
+    store.set("a/x", 2);
+
+    auto log = json::parse(store.since(1, "a/"));
+    EXPECT_EQ(log["version"], 3);
+    ASSERT_EQ(log["deltas"].size(), 1U);
+    EXPECT_EQ(log["deltas"][0]["version"], 3);
+    EXPECT_EQ(log["deltas"][0]["base"], 1);
+    EXPECT_FALSE(log.contains("resync"));
+
+    for (std::size_t i = 0; i < app::StateStore::LOG_CAPACITY; ++i) {
+        store.set("b/y", static_cast<int>(i) + 2);
+    }
+    log = json::parse(store.since(1, "a/"));
+    EXPECT_TRUE(log["resync"]);
+    EXPECT_EQ(log["entries"]["a/x"]["value"], 2);
+    EXPECT_EQ(store.stats().resyncs, 1U);
+    EXPECT_EQ(store.stats().log_entries, app::StateStore::LOG_CAPACITY);
+}
+
+TEST(StateStoreTest, PatchWritesCheckBaseVersionAndForwardThePatch) {
+    using json = nlohmann::json;
+    app::StateStore store;
+    std::vector<json> events;
+    store.set_sink([&](const std::string &, std::string event) {
+        events.push_back(json::parse(event));
+    });
+    (void)store.subscribe("w1", "");
+    const auto v1 = store.set("doc", {{"a", 1}});
+    const json ops = json::parse(R"([{"op":"add","path":"/b","value":2}])");
+
+    const auto v2 = store.patch("doc", v1, ops);
+    ASSERT_TRUE(v2);
+    EXPECT_FALSE(store.patch("doc", v1, ops)); // base antiga
+    EXPECT_THROW((void)store.patch("doc", *v2,
+                                   json::parse(R"([{"op":"remove",
+                                                    "path":"/zz"}])")),
+                 app::JsonPatchError);
+    ASSERT_EQ(events.size(), 2U);
+    EXPECT_EQ(events[1]["patch"], ops);
+    EXPECT_EQ(events[1]["base"], v1);
+
+    // set depois de um patch: diff contra o valor já patcheado
+    store.set("doc", {{"a", 1}, {"b", 3}});
+    ASSERT_EQ(events.size(), 3U);
+    EXPECT_EQ(events[2]["patch"],
+              json::parse(R"([{"op":"replace","path":"/b","value":3}])"));
+}
+
+// =============================================================================
+// JSON Patch
+// =============================================================================
+
+TEST(JsonPatchTest, DiffDescendsOnlyIntoChangedSubtrees) {
+    using json = nlohmann::json;
+    json a = {{"grid", {{"root", {{"data", json::array()}}}}},
+              {"panels", json::object()}};
+    for (int i = 0; i < 50; ++i) {
+        const std::string id = "p" + std::to_string(i);
+        a["grid"]["root"]["data"].push_back({{"id", id}, {"size", 100}});
+        a["panels"][id] = {{"title", id}, {"params", {{"n", i}}}};
+    }
+    json b = a;
+    auto &data = b["grid"]["root"]["data"];
+    json moved = data[10];
+    data.erase(10);
+    data.insert(data.begin() + 40, std::move(moved)); // aba arrastada
+    b["panels"]["p7"]["title"] = "x/y~z";
+    b["panels"].erase("p8");
+
+    const json patch = app::json_diff(a, b);
+    ASSERT_EQ(patch.size(), 3U);
+    EXPECT_EQ(patch[0], json::parse(R"({"op":"move",
+        "from":"/grid/root/data/10","path":"/grid/root/data/40"})"));
+    EXPECT_EQ(patch[1]["path"], "/panels/p7/title");
+    EXPECT_EQ(patch[2]["op"], "remove");
+    json c = a;
+    app::apply_json_patch(c, patch);
+    EXPECT_EQ(c, b);
+    EXPECT_EQ(a.patch(patch), b); // RFC 6902 de outra implementação
+
+    // 1 e 1.0 são o mesmo valor: nada muda
+    EXPECT_TRUE(app::json_diff(json{{"n", 1}}, json{{"n", 1.0}}).empty());
+    EXPECT_EQ(app::StructuralHash(b).root(), app::StructuralHash(c).root());
+}
+
+TEST(JsonPatchTest, ApplyIsAtomicAndSupportsAllOperations) {
+    using json = nlohmann::json;
+    json doc = {{"a", {1, 2, 3}}, {"b", {{"c", 1}}}};
+    app::apply_json_patch(doc, json::parse(R"([
+        {"op":"move","from":"/a/0","path":"/b/d"},
+        {"op":"copy","from":"/b","path":"/e"},
+        {"op":"test","path":"/e/d","value":1},
+        {"op":"add","path":"/a/-","value":9},
+        {"op":"replace","path":"/a/0","value":7}])"));
+    EXPECT_EQ(doc, json::parse(R"({"a":[7,3,9],"b":{"c":1,"d":1},
+                                   "e":{"c":1,"d":1}})"));
+
+    const json before = doc;
+    EXPECT_THROW(app::apply_json_patch(doc, json::parse(R"([
+        {"op":"remove","path":"/a/0"},
+        {"op":"add","path":"/b/x","value":true},
+        {"op":"move","from":"/e","path":"/e/f"}])")),
+                 app::JsonPatchError);
+    EXPECT_EQ(doc, before);
+    EXPECT_THROW(app::apply_json_patch(doc, json::parse(R"([
+        {"op":"test","path":"/a/0","value":1}])")),
+                 app::JsonPatchError);
+    EXPECT_THROW(app::apply_json_patch(doc, json::parse(R"([
+        {"op":"add","path":"/a/01","value":1}])")),
+                 app::JsonPatchError);
+    EXPECT_EQ(doc, before);
+}
@@ -0,0 +1,214 @@
+// =============================================================================
+// bench_json_diff - Diff/patch de layouts do dock no lado JS (json_patch.js)
+// =============================================================================
+// Uso: node tools/bench_json_diff.mjs [tamanho_mb ...]   (padrão: 1 5 10)
+//
+// Contraparte de bench_json_patch.cpp: mesmos layouts (formato do toJSON do
+// dockview) e mesmas edições, medindo o caminho de syncNativeState:
+//   * diffJson entre o valor local e o novo (o que a janela paga por
+//     escrita, no lugar do JSON.stringify do documento inteiro);
+//   * applyJsonPatch no lugar (o que cada janela paga por delta recebido);
+//   * bytes do documento inteiro contra bytes do patch.
+// Mediana de várias rodadas.
+// =============================================================================
+
+import { applyJsonPatch, diffJson } from '../ui/src/json_patch.js'
+
+const ROUNDS = 7
+const PANELS_PER_GROUP = 6
+
+// PRNG pequeno e determinístico (os valores só dão tamanho ao layout)
+function makeRng(seed) {
+  let state = seed >>> 0
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0
+    let t = state
+    t = Math.imul(t ^ (t >>> 15), t | 1)
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61)
+    return (t ^ (t >>> 14)) >>> 0
+  }
+}
+
+// Estado de um painel: o que domina o tamanho de layouts reais
+function panelParams(rng, index) {
+  const columns = []
+  for (let c = 0; c < 12; c++) {
+    columns.push({
+      field: `col${c}`,
+      width: 80 + (rng() % 120),
+      visible: rng() % 4 !== 0,
+      sort: c === 0 ? 'asc' : null,
+    })
+  }
+  const history = []
+  for (let h = 0; h < 20; h++) {
+    history.push(`command ${rng() % 100000} --flag value-${h}`)
+  }
+  return {
+    path: `/workspace/project/src/module${index}`,
+    scroll: { top: rng() % 5000, left: 0 },
+    filter: { text: '', caseSensitive: false },
+    columns,
+    history,
+    zoom: 1.0,
+  }
+}
+
+// Layout do dock com `groups` grupos em branches de 4
+function makeLayout(groups, rng) {
+  const panels = {}
+  let leaves = []
+  let nextPanel = 0
+  for (let g = 0; g < groups; g++) {
+    const views = []
+    for (let p = 0; p < PANELS_PER_GROUP; p++) {
+      const id = `panel-${nextPanel}`
+      views.push(id)
+      panels[id] = {
+        id,
+        contentComponent: 'InspectorPanel',
+        title: `Panel ${nextPanel}`,
+        params: panelParams(rng, nextPanel),
+      }
+      nextPanel++
+    }
+    leaves.push({
+      type: 'leaf',
+      size: 200 + (rng() % 400),
+      data: { id: String(g), views, activeView: views[0] },
+    })
+  }
+  // Agrupa de 4 em 4 até sobrar a raiz
+  while (leaves.length > 1) {
+    const branches = []
+    for (let i = 0; i < leaves.length; i += 4) {
+      branches.push({ type: 'branch', size: 800, data: leaves.slice(i, i + 4) })
+    }
+    leaves = branches
+  }
+  return {
+    grid: {
+      root: leaves[0],
+      width: 1920,
+      height: 1080,
+      orientation: 'HORIZONTAL',
+    },
+    panels,
+    activeGroup: '0',
+  }
+}
+
+const firstLeaf = (node) =>
+  node.type === 'leaf' ? node : firstLeaf(node.data[0])
+
+const EDITS = [
+  [
+    'resize',
+    (layout) => {
+      const data = layout.grid.root.data
+      data[0].size += 40
+      data[1].size -= 40
+    },
+  ],
+  [
+    'drag-tab',
+    (layout) => {
+      const views = firstLeaf(layout.grid.root).data.views
+      views.push(views.shift())
+    },
+  ],
+  [
+    'rename',
+    (layout) => {
+      layout.panels['panel-3'].title = 'Renamed'
+    },
+  ],
+  [
+    'open-panel',
+    (layout) => {
+      const leaf = firstLeaf(layout.grid.root)
+      leaf.data.views.push('panel-new')
+      leaf.data.activeView = 'panel-new'
+      layout.panels['panel-new'] = {
+        id: 'panel-new',
+        contentComponent: 'ConsolePanel',
+        title: 'New',
+        params: panelParams(makeRng(99), 0),
+      }
+    },
+  ],
+]
+
+// Mediana em ms
+function timeMs(fn) {
+  const samples = []
+  for (let i = 0; i < ROUNDS; i++) {
+    const begin = performance.now()
+    fn()
+    samples.push(performance.now() - begin)
+  }
+  samples.sort((x, y) => x - y)
+  return samples[Math.floor(ROUNDS / 2)]
+}
+
+// Grupos para chegar perto de `mb` MB serializados
+function groupsFor(mb) {
+  const bytesPerGroup = JSON.stringify(makeLayout(8, makeRng(1))).length / 8
+  return Math.max(1, Math.floor((mb * 1024 * 1024) / bytesPerGroup))
+}
+
+function run(mb) {
+  const layout = makeLayout(groupsFor(mb), makeRng(42))
+  const full = JSON.stringify(layout)
+  const stringifyMs = timeMs(() => JSON.stringify(layout))
+  const parseMs = timeMs(() => JSON.parse(full))
+
+  console.log(
+    `\n${(full.length / (1024 * 1024)).toFixed(1)} MB, documento inteiro: ` +
+      `stringify ${stringifyMs.toFixed(2)} ms, parse ${parseMs.toFixed(2)} ms`
+  )
+  console.log(
+    `  ${'edição'.padEnd(11)} ${'diff'.padStart(10)} ` +
+      `${'apply'.padStart(10)} ${'patch B'.padStart(9)} ${'ops'.padStart(6)}`
+  )
+
+  for (const [name, edit] of EDITS) {
+    const next = structuredClone(layout)
+    edit(next)
+
+    let ops = []
+    const diff = timeMs(() => {
+      ops = diffJson(layout, next)
+    })
+
+    // apply no lugar: cada rodada aplica e desfaz com o patch inverso
+    let doc = structuredClone(layout)
+    const undo = diffJson(next, layout)
+    const apply =
+      timeMs(() => {
+        doc = applyJsonPatch(doc, structuredClone(ops))
+        doc = applyJsonPatch(doc, structuredClone(undo))
+      }) / 2
+
+    const check = applyJsonPatch(structuredClone(layout), ops)
+    if (JSON.stringify(check) !== JSON.stringify(next)) {
+      console.error(`patch incorreto em ${name}`)
+      process.exit(1)
+    }
+    console.log(
+      `  ${name.padEnd(11)} ${diff.toFixed(3).padStart(10)} ` +
+        `${apply.toFixed(4).padStart(10)} ` +
+        `${String(JSON.stringify(ops).length).padStart(9)} ` +
+        `${String(ops.length).padStart(6)}`
+    )
+  }
+}
+
+const sizes = process.argv
+  .slice(2)
+  .map(Number)
+  .filter((mb) => mb > 0)
+console.log(`Tempos em ms (mediana de ${ROUNDS} rodadas)`)
+for (const mb of sizes.length ? sizes : [1, 5, 10]) {
+  run(mb)
+}
@@ -0,0 +1,241 @@
+// =============================================================================
+// bench_json_patch - Diff/patch de layouts do dock: json_patch.h x nlohmann
+// =============================================================================
+// Uso: bench_json_patch [tamanho_mb ...]   (padrão: 1 5 10)
+//
+// Gera layouts no formato do toJSON do dockview (grid de branches/leaves +
+// mapa de painéis com params) no tamanho pedido e mede, para edições
+// típicas (redimensionar, arrastar aba, renomear, abrir painel):
+//   * json::diff (nlohmann) contra json_diff, com os dois hashes e com o
+//     hash do documento antigo em cache (o caminho do StateStore::set);
+//   * json::patch (copia o documento) contra apply_json_patch (no lugar);
+//   * bytes do documento inteiro contra bytes do patch, e o parse do
+//     documento inteiro (o que cada janela pagava por mudança).
+// Mediana de várias rodadas; build Release para números representativos.
+// =============================================================================
+
+#include "app/json_patch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+constexpr int ROUNDS = 7;
+constexpr int PANELS_PER_GROUP = 6;
+
+// Estado de um painel: o que domina o tamanho de layouts reais (filtros,
+// colunas, seleção, histórico de console...)
+json panel_params(std::mt19937 &rng, int index) {
+    json columns = json::array();
+    for (int c = 0; c < 12; ++c) {
+        columns.push_back({{"field", "col" + std::to_string(c)},
+                           {"width", 80 + static_cast<int>(rng() % 120)},
+                           {"visible", rng() % 4 != 0},
+                           {"sort", c == 0 ? json("asc") : json()}});
+    }
+    json history = json::array();
+    for (int h = 0; h < 20; ++h) {
+        history.push_back("command " + std::to_string(rng() % 100000) +
+                          " --flag value-" + std::to_string(h));
+    }
+    return {{"path", "/workspace/project/src/module" + std::to_string(index)},
+            {"scroll", {{"top", rng() % 5000}, {"left", 0}}},
+            {"filter", {{"text", ""}, {"caseSensitive", false}}},
+            {"columns", std::move(columns)},
+            {"history", std::move(history)},
+            {"zoom", 1.0}};
+}
+
+// Layout do dock com `groups` grupos em branches de 4
+json make_layout(int groups, std::mt19937 &rng) {
+    json panels = json::object();
+    std::vector<json> leaves;
+    int next_panel = 0;
+    for (int g = 0; g < groups; ++g) {
+        json views = json::array();
+        for (int p = 0; p < PANELS_PER_GROUP; ++p) {
+            const std::string id = "panel-" + std::to_string(next_panel);
+            views.push_back(id);
+            panels[id] = {{"id", id},
+                          {"contentComponent", "InspectorPanel"},
+                          {"title", "Panel " + std::to_string(next_panel)},
+                          {"params", panel_params(rng, next_panel)}};
+            ++next_panel;
+        }
+        leaves.push_back(
+            {{"type", "leaf"},
+             {"size", 200 + static_cast<int>(rng() % 400)},
+             {"data",
+              {{"id", std::to_string(g)},
+               {"views", views},
+               {"activeView", views[0]}}}});
+    }
+    // Agrupa de 4 em 4 até sobrar a raiz
+    while (leaves.size() > 1) {
+        std::vector<json> branches;
+        for (std::size_t i = 0; i < leaves.size(); i += 4) {
+            json data = json::array();
+            for (std::size_t j = i; j < std::min(i + 4, leaves.size()); ++j) {
+                data.push_back(std::move(leaves[j]));
+            }
+            branches.push_back({{"type", "branch"},
+                                {"size", 800},
+                                {"data", std::move(data)}});
+        }
+        leaves = std::move(branches);
+    }
+    return {{"grid",
+             {{"root", std::move(leaves[0])},
+              {"width", 1920},
+              {"height", 1080},
+              {"orientation", "HORIZONTAL"}}},
+            {"panels", std::move(panels)},
+            {"activeGroup", "0"}};
+}
+
+json &first_leaf(json &node) {
+    return node["type"] == "leaf" ? node : first_leaf(node["data"][0]);
+}
+
+struct Edit {
+    const char *name;
+    std::function<void(json &)> apply;
+};
+
+std::vector<Edit> edits() {
+    return {
+        {"resize",
+         [](json &layout) {
+             auto &data = layout["grid"]["root"]["data"];
+             data[0]["size"] = data[0]["size"].get<int>() + 40;
+             data[1]["size"] = data[1]["size"].get<int>() - 40;
+         }},
+        {"drag-tab",
+         [](json &layout) {
+             auto &views = first_leaf(layout["grid"]["root"])["data"]["views"];
+             json moved = views[0];
+             views.erase(0);
+             views.push_back(std::move(moved));
+         }},
+        {"rename",
+         [](json &layout) {
+             layout["panels"]["panel-3"]["title"] = "Renamed";
+         }},
+        {"open-panel",
+         [](json &layout) {
+             std::mt19937 rng(99);
+             auto &leaf = first_leaf(layout["grid"]["root"]);
+             leaf["data"]["views"].push_back("panel-new");
+             leaf["data"]["activeView"] = "panel-new";
+             layout["panels"]["panel-new"] = {
+                 {"id", "panel-new"},
+                 {"contentComponent", "ConsolePanel"},
+                 {"title", "New"},
+                 {"params", panel_params(rng, 0)}};
+         }},
+    };
+}
+
+// Mediana em ms
+double time_ms(const std::function<void()> &fn) {
+    std::vector<double> samples;
+    for (int i = 0; i < ROUNDS; ++i) {
+        const auto begin = Clock::now();
+        fn();
+        samples.push_back(
+            std::chrono::duration<double, std::milli>(Clock::now() - begin)
+                .count());
+    }
+    std::nth_element(samples.begin(), samples.begin() + ROUNDS / 2,
+                     samples.end());
+    return samples[ROUNDS / 2];
+}
+
+// Grupos para chegar perto de `mb` MB serializados
+int groups_for(double mb) {
+    std::mt19937 rng(1);
+    const auto bytes_per_group =
+        static_cast<double>(make_layout(8, rng).dump().size()) / 8.0;
+    return std::max(1, static_cast<int>(mb * 1024 * 1024 / bytes_per_group));
+}
+
+void run(double mb) {
+    std::mt19937 rng(42);
+    const json layout = make_layout(groups_for(mb), rng);
+    const std::string full = layout.dump();
+    const app::StructuralHash cached(layout);
+    json sink; // resultados descartados
+    const double parse_ms = time_ms([&] { sink = json::parse(full); });
+
+    std::printf("\n%.1f MB (%zu nós), parse do documento inteiro: %.2f ms\n",
+                static_cast<double>(full.size()) / (1024 * 1024),
+                cached.nodes(), parse_ms);
+    std::printf("  %-11s %10s %10s %10s %10s %10s %9s %6s\n", "edição",
+                "nl::diff", "diff", "diff+cache", "nl::patch", "apply",
+                "patch B", "ops");
+
+    for (const auto &edit : edits()) {
+        json next = layout;
+        edit.apply(next);
+
+        json ours;
+        const double nl_diff =
+            time_ms([&] { sink = json::diff(layout, next); });
+        const double diff =
+            time_ms([&] { ours = app::json_diff(layout, next); });
+        const double diff_cached = time_ms([&] {
+            const app::StructuralHash hashes(next);
+            sink = app::json_diff(layout, cached, next, hashes);
+        });
+        const json nl_ops = json::diff(layout, next);
+        const double nl_patch =
+            time_ms([&] { sink = layout.patch(nl_ops); });
+
+        // apply no lugar: cada rodada aplica e desfaz com o patch inverso
+        json doc = layout;
+        const json undo = app::json_diff(next, layout);
+        const double apply = time_ms([&] {
+            app::apply_json_patch(doc, ours);
+            app::apply_json_patch(doc, undo);
+        }) / 2;
+
+        json check = layout;
+        app::apply_json_patch(check, ours);
+        if (check != next) {
+            std::fprintf(stderr, "patch incorreto em %s\n", edit.name);
+            std::exit(1);
+        }
+        std::printf("  %-11s %10.3f %10.3f %10.3f %10.3f %10.4f %9zu %6zu\n",
+                    edit.name, nl_diff, diff, diff_cached, nl_patch, apply,
+                    ours.dump().size(), ours.size());
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::vector<double> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::atof(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = {1, 5, 10};
+    }
+    std::printf("Tempos em ms (mediana de %d rodadas)\n", ROUNDS);
+    for (const double mb : sizes) {
+        if (mb > 0) {
+            run(mb);
+        }
+    }
+    return 0;
+}
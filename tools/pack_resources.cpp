@@ -0,0 +1,230 @@
+// =============================================================================
+// pack_resources - Empacota ui/dist num .cpp com arquivo único comprimido
+// =============================================================================
+// Uso: pack_resources <dist_dir> <out.cpp> [--quality <0-11>]
+//
+// Gera um translation unit com:
+//   * archive_data: todos os assets concatenados (Brotli quando reduz o
+//     tamanho, senão bytes crus - ex: imagens/fontes já comprimidas);
+//   * asset_entries: índice ordenado por path (busca binária em
+//     embedded::find_asset), com tamanhos e ETag pré-calculados.
+// Substitui o antigo cmake/EmbedFile.cmake (regex em CMake, um único
+// arquivo, sem compressão).
+// =============================================================================
+
+#include "app/resource_server.h"
+#include "embedded_resources.h"
+#include <algorithm>
+#include <brotli/encode.h>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct PackedAsset {
+    std::string path;
+    std::string stored;
+    std::size_t raw_size = 0;
+    embedded::Encoding encoding = embedded::Encoding::Identity;
+    std::string etag;
+};
+
+bool is_text_asset(std::string_view path) {
+    const std::string_view mime = app::resources::mime_type_for(path);
+    return mime.substr(0, 5) == "text/" || mime == "application/json" ||
+           mime == "image/svg+xml";
+}
+
+std::string read_file(const fs::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in),
+            std::istreambuf_iterator<char>()};
+}
+
+PackedAsset pack(const std::string &path, std::string raw, int quality) {
+    PackedAsset asset;
+    asset.path = path;
+    asset.raw_size = raw.size();
+    asset.etag = app::resources::make_etag(raw);
+
+    std::string compressed(BrotliEncoderMaxCompressedSize(raw.size()), '\0');
+    std::size_t compressed_size = compressed.size();
+    const bool ok =
+        !raw.empty() &&
+        BrotliEncoderCompress(
+            quality, BROTLI_DEFAULT_WINDOW,
+            is_text_asset(path) ? BROTLI_MODE_TEXT : BROTLI_MODE_GENERIC,
+            raw.size(), reinterpret_cast<const std::uint8_t *>(raw.data()),
+            &compressed_size,
+            reinterpret_cast<std::uint8_t *>(compressed.data())) ==
+            BROTLI_TRUE;
+
+    // Só compensa guardar comprimido se economizar pelo menos ~5%
+    if (ok && compressed_size < raw.size() - raw.size() / 20) {
+        compressed.resize(compressed_size);
+        asset.stored = std::move(compressed);
+        asset.encoding = embedded::Encoding::Brotli;
+    } else {
+        asset.stored = std::move(raw);
+    }
+    return asset;
+}
+
+std::vector<PackedAsset> collect(const fs::path &root, int quality) {
+    std::vector<PackedAsset> assets;
+    for (auto it = fs::recursive_directory_iterator(root);
+         it != fs::recursive_directory_iterator(); ++it) {
+        const std::string name = it->path().filename().string();
+        // Ignora metadados do build (ex: .vite/manifest.json)
+        if (!name.empty() && name.front() == '.') {
+            if (it->is_directory()) {
+                it.disable_recursion_pending();
+            }
+            continue;
+        }
+        if (!it->is_regular_file()) {
+            continue;
+        }
+        const std::string rel =
+            "/" + fs::relative(it->path(), root).generic_string();
+        assets.push_back(pack(rel, read_file(it->path()), quality));
+    }
+    std::sort(assets.begin(), assets.end(),
+              [](const PackedAsset &a, const PackedAsset &b) {
+                  return a.path < b.path;
+              });
+    return assets;
+}
+
+// Escapa string para literal C++ (paths e ETags são ASCII simples)
+std::string cpp_literal(std::string_view text) {
+    std::string out = "\"";
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+    return out;
+}
+
+void write_archive(std::ostream &out, const std::vector<PackedAsset> &assets) {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::size_t column = 0;
+    std::string line;
+    for (const auto &asset : assets) {
+        for (const char c : asset.stored) {
+            const auto byte = static_cast<unsigned char>(c);
+            line += "0x";
+            line.push_back(digits[byte >> 4U]);
+            line.push_back(digits[byte & 0xFU]);
+            line += ",";
+            if (++column == 16) {
+                out << "    " << line << "\n";
+                line.clear();
+                column = 0;
+            }
+        }
+    }
+    out << "    " << line << "0x00\n";
+}
+
+void write_output(std::ostream &out, const fs::path &root,
+                  const std::vector<PackedAsset> &assets,
+                  std::size_t raw_total, std::size_t stored_total) {
+    out << "// Auto-generated from: " << root.generic_string() << "\n"
+        << "// Generated by tools/pack_resources.cpp - DO NOT EDIT\n"
+        << "// Assets: " << assets.size() << ", raw: " << raw_total
+        << " bytes, stored: " << stored_total << " bytes\n"
+        << "#include \"embedded_resources.h\"\n\n"
+        << "namespace embedded {\n"
+        << "namespace {\n\n"
+        << "alignas(16) const unsigned char archive_data[] = {\n";
+    write_archive(out, assets);
+    out << "};\n\n"
+        << "} // namespace\n\n"
+        << "// constinit: índice inicializado em tempo de compilação, sem\n"
+        << "// inicialização dinâmica no startup\n"
+        << "constinit const AssetEntry asset_entries[] = {\n";
+
+    std::size_t offset = 0;
+    for (const auto &asset : assets) {
+        out << "    {" << cpp_literal(asset.path) << ", archive_data + "
+            << offset << ", " << asset.stored.size() << ", "
+            << asset.raw_size << ", "
+            << (asset.encoding == embedded::Encoding::Brotli
+                    ? "Encoding::Brotli"
+                    : "Encoding::Identity")
+            << ", " << cpp_literal(asset.etag) << "},\n";
+        offset += asset.stored.size();
+    }
+    out << "};\n\n"
+        << "constinit const std::size_t asset_count = " << assets.size()
+        << ";\n\n"
+        << "} // namespace embedded\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "Uso: pack_resources <dist_dir> <out.cpp> "
+                     "[--quality <0-11>]\n";
+        return 1;
+    }
+
+    const fs::path root = argv[1];
+    const fs::path output = argv[2];
+    int quality = BROTLI_DEFAULT_QUALITY;
+    if (argc >= 5 && std::string_view(argv[3]) == "--quality") {
+        quality = std::clamp(std::atoi(argv[4]), BROTLI_MIN_QUALITY,
+                             BROTLI_MAX_QUALITY);
+    }
+
+    if (!fs::exists(root / "index.html")) {
+        std::cerr << "pack_resources: " << (root / "index.html").string()
+                  << " não encontrado\n";
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto assets = collect(root, quality);
+
+    std::size_t raw_total = 0;
+    std::size_t stored_total = 0;
+    for (const auto &asset : assets) {
+        raw_total += asset.raw_size;
+        stored_total += asset.stored.size();
+    }
+
+    // Escreve num temporário e renomeia: um build interrompido nunca deixa
+    // um .cpp truncado com timestamp novo.
+    fs::create_directories(output.parent_path());
+    const fs::path tmp = output.string() + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        if (!out) {
+            std::cerr << "pack_resources: falha ao abrir " << tmp.string()
+                      << "\n";
+            return 1;
+        }
+        write_output(out, root, assets, raw_total, stored_total);
+    }
+    fs::rename(tmp, output);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << "[pack_resources] " << assets.size() << " assets, "
+              << raw_total << " -> " << stored_total << " bytes (q" << quality
+              << ") em " << elapsed.count() << " ms\n";
+    return 0;
+}
@@ -1,8 +1,12 @@
-import WelcomePanel from './panels/WelcomePanel.vue'
-import InspectorPanel from './panels/InspectorPanel.vue'
-import TimelinePanel from './panels/TimelinePanel.vue'
-import ConsolePanel from './panels/ConsolePanel.vue'
-import ScratchPanel from './panels/ScratchPanel.vue'
+import { defineAsyncComponent } from 'vue'
+
+// Painéis carregados sob demanda: cada um vira um chunk separado no build
+// servido via app://, então uma janela popout só busca o que usa.
+const WelcomePanel = defineAsyncComponent(() => import('./panels/WelcomePanel.vue'))
+const InspectorPanel = defineAsyncComponent(() => import('./panels/InspectorPanel.vue'))
+const TimelinePanel = defineAsyncComponent(() => import('./panels/TimelinePanel.vue'))
+const ConsolePanel = defineAsyncComponent(() => import('./panels/ConsolePanel.vue'))
+const ScratchPanel = defineAsyncComponent(() => import('./panels/ScratchPanel.vue'))
 
 export {
     WelcomePanel,
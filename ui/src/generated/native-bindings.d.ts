@@ -3,7 +3,10 @@ export {};
 declare global {
   function ping(arg0: string | null): any;
   function getVersion(): any;
-  function openFile(arg0: string): any;
+  function listDirectory(arg0: string): any;
+  function echoBinary(arg0: ArrayBuffer): ArrayBuffer;
+  function pullNativeStream(arg0: string): any;
+  function closeNativeStream(arg0: string): boolean;
   function getCounter(): number;
   function getPi(): number;
   function getStatus(): string;
@@ -12,10 +15,35 @@ declare global {
   function createNativeWindow(arg0: any): string;
   function getBootstrap(arg0: string): any;
   function postNativeEvent(arg0: string, arg1: any): void;
+  function getNativeEventStats(arg0: string): any;
   function closeNativeWindow(arg0: string): void;
   function listNativeWindows(): any;
-  function startNativeDrag(arg0: string, arg1: any): void;
+  function startNativeDrag(arg0: string, arg1: any): number;
   function completeNativeDrag(arg0: string): any;
   function stopNativeDrag(): void;
   function completeNativeDragOutside(arg0: string): any;
+  function registerDropTargets(arg0: string, arg1: any): void;
+  function getNativeWindowGeometry(arg0: string): any;
+  function getNativeDragStats(): any;
+  function reportStartupMark(arg0: string, arg1: string, arg2: number): void;
+  function addTraceEvents(arg0: any): void;
+  function reportFrameGap(arg0: string, arg1: number): void;
+  function getStallReports(): any;
+  function getNativeMetrics(): any;
+  function dumpNativeTrace(): string;
+  function startJob(arg0: string, arg1: string, arg2: any): string;
+  function cancelJob(arg0: string): boolean;
+  function listJobs(): any;
+  function putBlob(arg0: string, arg1: string, arg2: any): any;
+  function getBlob(arg0: string, arg1: string | null): any;
+  function retainBlob(arg0: string, arg1: string): boolean;
+  function releaseBlob(arg0: string, arg1: string): boolean;
+  function getBlobStats(): any;
+  function subscribeState(arg0: string, arg1: string): any;
+  function unsubscribeState(arg0: string, arg1: string): boolean;
+  function getStateSince(arg0: number, arg1: string): any;
+  function setState(arg0: string, arg1: any): number;
+  function patchState(arg0: string, arg1: number, arg2: any): number;
+  function deleteState(arg0: string): number;
+  function getStateStats(): any;
 }
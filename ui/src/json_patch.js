@@ -0,0 +1,164 @@
+// JSON Patch (RFC 6902), o formato dos deltas de estado nativos.
+// applyJsonPatch altera `document` no lugar e devolve a raiz (uma
+// operação na raiz a troca); diffJson gera add/remove/replace/move com o
+// mesmo alinhamento de arrays do diff nativo (json_patch.h).
+function parseJsonPointer(path) {
+  if (path === '') return []
+  return path
+    .slice(1)
+    .split('/')
+    .map((token) => token.replace(/~1/g, '/').replace(/~0/g, '~'))
+}
+
+function escapePointerToken(token) {
+  return String(token).replace(/~/g, '~0').replace(/\//g, '~1')
+}
+
+export function applyJsonPatch(document, patch) {
+  let root = document
+  const resolve = (tokens) => {
+    let node = root
+    for (const token of tokens) {
+      if (node === null || typeof node !== 'object' || !(token in node)) {
+        throw new Error(`Patch path not found: /${tokens.join('/')}`)
+      }
+      node = node[token]
+    }
+    return node
+  }
+  const add = (tokens, value) => {
+    if (tokens.length === 0) {
+      root = value
+      return
+    }
+    const parent = resolve(tokens.slice(0, -1))
+    const last = tokens[tokens.length - 1]
+    if (Array.isArray(parent)) {
+      parent.splice(last === '-' ? parent.length : Number(last), 0, value)
+    } else {
+      parent[last] = value
+    }
+  }
+  const remove = (tokens) => {
+    const value = resolve(tokens)
+    const parent = resolve(tokens.slice(0, -1))
+    const last = tokens[tokens.length - 1]
+    if (Array.isArray(parent)) parent.splice(Number(last), 1)
+    else delete parent[last]
+    return value
+  }
+
+  for (const op of patch) {
+    const tokens = parseJsonPointer(op.path)
+    if (op.op === 'add') {
+      add(tokens, op.value)
+    } else if (op.op === 'remove') {
+      remove(tokens)
+    } else if (op.op === 'replace') {
+      resolve(tokens)
+      if (tokens.length === 0) root = op.value
+      else resolve(tokens.slice(0, -1))[tokens.at(-1)] = op.value
+    } else if (op.op === 'move') {
+      add(tokens, remove(parseJsonPointer(op.from)))
+    } else if (op.op === 'copy') {
+      add(tokens, structuredClone(resolve(parseJsonPointer(op.from))))
+    } else if (op.op === 'test') {
+      if (!jsonEqual(resolve(tokens), op.value)) {
+        throw new Error(`Patch test failed: ${op.path}`)
+      }
+    } else {
+      throw new Error(`Unsupported patch op: ${op.op}`)
+    }
+  }
+  return root
+}
+
+// Chaves que o JSON serializa (undefined some)
+function jsonKeys(object) {
+  return Object.keys(object).filter((key) => object[key] !== undefined)
+}
+
+function jsonEqual(a, b) {
+  if (a === b) return true
+  if (a === null || b === null || typeof a !== 'object') return false
+  if (typeof b !== 'object' || Array.isArray(a) !== Array.isArray(b)) {
+    return false
+  }
+  if (Array.isArray(a)) {
+    return a.length === b.length && a.every((v, i) => jsonEqual(v, b[i]))
+  }
+  const keys = jsonKeys(a)
+  if (keys.length !== jsonKeys(b).length) return false
+  return keys.every((key) => jsonEqual(a[key], b[key]))
+}
+
+// Custo: os dois documentos são árvores distintas (o toJSON do dockview
+// gera uma nova a cada mudança), então o diff visita todos os nós. Cada
+// nível refaz o jsonEqual da subárvore até o primeiro nó diferente: pior
+// caso O(n·profundidade), com profundidade ~8 num layout do dock. Em
+// tools/bench_json_diff.mjs, nos layouts de 1-10 MB do bench nativo, custa
+// o mesmo que um JSON.stringify do documento (~8-10 ms/MB), em troca de um
+// patch de centenas de bytes no lugar do documento inteiro.
+export function diffJson(a, b, path = '', ops = []) {
+  const isObject = (v) => v !== null && typeof v === 'object'
+  if (jsonEqual(a, b)) return ops
+  if (Array.isArray(a) && Array.isArray(b)) {
+    let prefix = 0
+    const common = Math.min(a.length, b.length)
+    while (prefix < common && jsonEqual(a[prefix], b[prefix])) prefix++
+    let suffix = 0
+    while (
+      suffix < common - prefix &&
+      jsonEqual(a[a.length - 1 - suffix], b[b.length - 1 - suffix])
+    ) {
+      suffix++
+    }
+    const midA = a.length - prefix - suffix
+    const midB = b.length - prefix - suffix
+    if (midA === midB && midA > 1) {
+      // Um item levado de uma ponta do miolo à outra (aba arrastada)
+      const first = prefix
+      const last = prefix + midA - 1
+      let forward = jsonEqual(a[first], b[last])
+      let backward = jsonEqual(a[last], b[first])
+      for (let i = first; i < last && (forward || backward); i++) {
+        forward = forward && jsonEqual(a[i + 1], b[i])
+        backward = backward && jsonEqual(a[i], b[i + 1])
+      }
+      if (forward || backward) {
+        const [from, to] = forward ? [first, last] : [last, first]
+        ops.push({ op: 'move', from: `${path}/${from}`, path: `${path}/${to}` })
+        return ops
+      }
+    }
+    for (let k = 0; k < Math.min(midA, midB); k++) {
+      diffJson(a[prefix + k], b[prefix + k], `${path}/${prefix + k}`, ops)
+    }
+    for (let k = midA; k < midB; k++) {
+      const value = b[prefix + k]
+      ops.push({ op: 'add', path: `${path}/${prefix + k}`, value })
+    }
+    for (let k = midB; k < midA; k++) {
+      ops.push({ op: 'remove', path: `${path}/${prefix + midB}` })
+    }
+  } else if (
+    isObject(a) &&
+    isObject(b) &&
+    !Array.isArray(a) &&
+    !Array.isArray(b)
+  ) {
+    for (const key of jsonKeys(a)) {
+      if (b[key] === undefined) {
+        ops.push({ op: 'remove', path: `${path}/${escapePointerToken(key)}` })
+      }
+    }
+    for (const key of jsonKeys(b)) {
+      const child = `${path}/${escapePointerToken(key)}`
+      if (a[key] !== undefined) diffJson(a[key], b[key], child, ops)
+      else ops.push({ op: 'add', path: child, value: b[key] })
+    }
+  } else {
+    ops.push({ op: 'replace', path, value: b })
+  }
+  return ops
+}
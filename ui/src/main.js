@@ -1,6 +1,7 @@
 import { createApp } from 'vue'
 import App from './App.vue'
 import { registerDockPanels } from './dock_panels'
+import { applyJsonPatch, diffJson } from './json_patch'
 import 'dockview-vue/dist/styles/dockview.css'
 import './style.css'
 
@@ -126,12 +127,36 @@ function installNativeWindowOpen() {
   }
 }
 
+// Fluxo dos eventos nativos: cada evento traz um seq e o nativo só manda
+// mais quando confirmamos. O ack sai numa tarefa depois dos listeners (uma
+// por rajada): com a página ocupada ele atrasa e o nativo segura a fila.
+function createNativeEventAcker() {
+  if (!window.ackNativeEvents) return () => {}
+  const windowId = currentWindowId()
+  let lastSeq = 0
+  let scheduled = false
+  // Página nova: o que estava em voo para a anterior não volta
+  window.ackNativeEvents(windowId, 0).catch(() => {})
+  return (seq) => {
+    if (!Number.isFinite(seq) || seq <= lastSeq) return
+    lastSeq = seq
+    if (scheduled) return
+    scheduled = true
+    setTimeout(() => {
+      scheduled = false
+      window.ackNativeEvents(windowId, lastSeq).catch(() => {})
+    }, 0)
+  }
+}
+
 function installNativeMessageBridge() {
   if (window.__nativeMessageBridgeInstalled) return
   window.__nativeMessageBridgeInstalled = true
+  const ackNativeEvent = createNativeEventAcker()
   window.addEventListener('native-event', (event) => {
     const detail = event?.detail
     if (!detail) return
+    ackNativeEvent(detail.seq)
 
     if (detail.type === 'message') {
       window.dispatchEvent(
@@ -154,9 +179,436 @@ function installNativeMessageBridge() {
   })
 }
 
+function currentWindowId() {
+  const params = new URLSearchParams(window.location.search)
+  return params.get('wid') || window.__APP_WINDOW_ID__ || 'main'
+}
+
+// --profile-startup: o binding só existe com a flag ativa. O nativo
+// registra a chegada de cada marco na mesma timeline das fases nativas.
+function createStartupReporter() {
+  if (!window.reportStartupMark) return null
+  const windowId = currentWindowId()
+  return (name) => {
+    window.reportStartupMark(windowId, name, performance.now()).catch(() => {})
+  }
+}
+
+// --trace: encaminha performance.mark/measure para a timeline nativa, em
+// lotes para não pagar uma chamada de binding por entrada.
+const TRACE_FLUSH_DELAY_MS = 250
+
+function installNativeTraceForwarding() {
+  if (!window.__APP_TRACING__ || !window.addTraceEvents) return
+  if (typeof PerformanceObserver !== 'function') return
+  let pending = []
+  let timer = null
+
+  const flush = () => {
+    timer = null
+    const batch = pending
+    pending = []
+    window.addTraceEvents(batch).catch(() => {})
+  }
+
+  const observer = new PerformanceObserver((list) => {
+    for (const entry of list.getEntries()) {
+      pending.push({
+        name: entry.name,
+        start: performance.timeOrigin + entry.startTime,
+        duration: entry.entryType === 'mark' ? -1 : entry.duration
+      })
+    }
+    if (pending.length > 0 && timer === null) {
+      timer = setTimeout(flush, TRACE_FLUSH_DELAY_MS)
+    }
+  })
+  observer.observe({ entryTypes: ['mark', 'measure'] })
+}
+
+installNativeTraceForwarding()
+
+// Watchdog do main loop: gaps de requestAnimationFrame acima do limite vão
+// para o nativo, que os cruza com os travamentos que detectou. Janelas
+// ocultas não recebem frames; o gap que atravessa a troca é descartado.
+const FRAME_GAP_THRESHOLD_MS = 100
+
+function installFrameGapReporter() {
+  if (!window.reportFrameGap) return
+  const windowId = currentWindowId()
+  let last = null
+
+  document.addEventListener('visibilitychange', () => {
+    last = null
+  })
+
+  const onFrame = (now) => {
+    if (last !== null && document.visibilityState === 'visible') {
+      const gap = now - last
+      if (gap > FRAME_GAP_THRESHOLD_MS) {
+        window.reportFrameGap(windowId, gap).catch(() => {})
+      }
+    }
+    last = now
+    requestAnimationFrame(onFrame)
+  }
+  requestAnimationFrame(onFrame)
+}
+
+installFrameGapReporter()
+
+// Jobs nativos: startJob devolve o id na hora; progresso e estado final
+// chegam em lotes (no máximo um por frame) no evento jobs.update desta
+// janela. O AbortSignal vira cancelJob.
+const nativeJobs = new Map()
+
+function settleNativeJob(update) {
+  const job = nativeJobs.get(update.id)
+  if (!job) return
+  job.onProgress?.(update)
+  if (update.state === 'completed') {
+    nativeJobs.delete(update.id)
+    job.resolve(update.result)
+  } else if (update.state === 'failed') {
+    nativeJobs.delete(update.id)
+    job.reject(new Error(update.error))
+  } else if (update.state === 'cancelled') {
+    nativeJobs.delete(update.id)
+    job.reject(new DOMException('Job cancelled', 'AbortError'))
+  }
+}
+
+function installNativeJobs() {
+  if (!window.startJob) return
+  window.addEventListener('native-event', (event) => {
+    const detail = event?.detail
+    if (detail?.type !== 'jobs.update') return
+    for (const update of detail.jobs) settleNativeJob(update)
+  })
+
+  window.runNativeJob = async (
+    kind,
+    params = null,
+    { signal, onProgress } = {}
+  ) => {
+    signal?.throwIfAborted()
+    const started = await window.startJob(currentWindowId(), kind, params)
+    if (!started?.ok) {
+      throw new Error(started?.error?.message || 'Could not start job')
+    }
+    const id = started.data
+    const done = new Promise((resolve, reject) => {
+      nativeJobs.set(id, { resolve, reject, onProgress })
+    })
+    const cancel = () => window.cancelJob(id).catch(() => {})
+    if (signal?.aborted) cancel()
+    else signal?.addEventListener('abort', cancel, { once: true })
+    return done
+  }
+}
+
+installNativeJobs()
+
+// Resultados em stream (bindings::Stream): a resposta traz o primeiro bloco
+// e o id; o próximo bloco só é pedido quando o consumidor esgota o atual.
+// Sair do for-await antes do fim libera o stream no nativo.
+async function* iterateNativeStream(resultOrPromise) {
+  const unwrap = (result) => {
+    if (!result?.ok) {
+      throw new Error(result?.error?.message || 'Native stream failed')
+    }
+    return result.data
+  }
+  let chunk = unwrap(await resultOrPromise)
+  const id = chunk.stream
+  try {
+    for (;;) {
+      for (const item of chunk.items) yield item
+      if (chunk.done) return
+      chunk = unwrap(await window.pullNativeStream(id))
+    }
+  } finally {
+    if (id && !chunk?.done) window.closeNativeStream(id).catch(() => {})
+  }
+}
+
+window.iterateNativeStream = iterateNativeStream
+
+// Blobs nativos: as janelas trocam handles (postNativeEvent leva só o
+// handle) e cada uma lê os bytes quando precisa. Com a UI servida por
+// app:// a leitura é um fetch do buffer nativo; fora dele (Vite) os bytes
+// vêm em base64 pelo bridge.
+function bytesToBase64(bytes) {
+  let binary = ''
+  const step = 0x8000
+  for (let i = 0; i < bytes.length; i += step) {
+    binary += String.fromCharCode(...bytes.subarray(i, i + step))
+  }
+  return btoa(binary)
+}
+
+function base64ToBytes(text) {
+  const binary = atob(text)
+  const bytes = new Uint8Array(binary.length)
+  for (let i = 0; i < binary.length; i++) bytes[i] = binary.charCodeAt(i)
+  return bytes
+}
+
+function unwrapNative(result, fallback) {
+  if (!result?.ok) throw new Error(result?.error?.message || fallback)
+  return result.data
+}
+
+function installNativeBlobs() {
+  if (!window.putBlob) return
+  const windowId = currentWindowId()
+
+  // `data`: string (guardada como UTF-8), Blob, ArrayBuffer ou TypedArray
+  window.putNativeBlob = async (data, { type = '' } = {}) => {
+    let payload = data
+    let encoding = 'utf8'
+    if (typeof data !== 'string') {
+      const bytes = ArrayBuffer.isView(data)
+        ? new Uint8Array(data.buffer, data.byteOffset, data.byteLength)
+        : new Uint8Array(data instanceof Blob ? await data.arrayBuffer() : data)
+      payload = bytesToBase64(bytes)
+      encoding = 'base64'
+      type = type || data.type || ''
+    }
+    const result = await window.putBlob(windowId, payload, { encoding, type })
+    return unwrapNative(result, 'putBlob failed')
+  }
+
+  window.readNativeBlob = async (handle) => {
+    if (window.location.protocol === 'app:') {
+      const response = await fetch(`/__blobs/${handle}`)
+      if (response.ok) return response.blob()
+    }
+    const blob = unwrapNative(
+      await window.getBlob(handle, 'base64'),
+      'getBlob failed'
+    )
+    return new Blob([base64ToBytes(blob.data)], { type: blob.type })
+  }
+
+  window.retainNativeBlob = async (handle) =>
+    unwrapNative(await window.retainBlob(windowId, handle), 'retainBlob failed')
+  window.releaseNativeBlob = async (handle) =>
+    unwrapNative(
+      await window.releaseBlob(windowId, handle),
+      'releaseBlob failed'
+    )
+}
+
+installNativeBlobs()
+
+// Estado compartilhado nativo: o nativo é a única autoridade (escritas vão
+// por setState/patchState/deleteState e voltam como delta para as janelas,
+// inclusive a que escreveu). subscribeNativeState traz o snapshot do
+// prefixo; depois chegam só patches (state.delta). Um delta que não parte
+// da versão local da chave (`base`) indica deltas perdidos: pedimos o log
+// desde a última versão sincronizada do prefixo (getStateSince), que só
+// vira snapshot se o nativo já descartou esse trecho.
+function installNativeState() {
+  if (!window.subscribeState) return
+  const windowId = currentWindowId()
+  const entries = new Map() // key -> { value, version, deleted? }
+  const subscriptions = new Map() // prefix -> estado da assinatura
+
+  const notify = (key, value) => {
+    for (const [prefix, sub] of subscriptions) {
+      if (!key.startsWith(prefix)) continue
+      for (const listener of sub.listeners) listener(key, value)
+    }
+  }
+
+  // false = lacuna (a chave não está na versão de onde o delta parte).
+  // Aplicado, o delta avança a versão da assinatura: o que ela já cobre
+  // (snapshot ou delta repetido) é ignorado.
+  const applyDelta = (sub, delta) => {
+    if (delta.version <= sub.version) return true
+    const entry = entries.get(delta.key)
+    if (!entry || delta.version > entry.version) {
+      const local = entry && !entry.deleted ? entry.version : 0
+      if (delta.base !== local) return false
+      if (delta.deleted) {
+        entries.set(delta.key, { version: delta.version, deleted: true })
+        notify(delta.key, undefined)
+      } else {
+        const value = applyJsonPatch(local ? entry.value : null, delta.patch)
+        entries.set(delta.key, { value, version: delta.version })
+        notify(delta.key, value)
+      }
+    }
+    sub.version = delta.version
+    return true
+  }
+
+  const loadSnapshot = (prefix, sub, data) => {
+    for (const [key, entry] of entries) {
+      if (!key.startsWith(prefix) || key in data.entries) continue
+      if (entry.version > data.version) continue
+      entries.delete(key)
+      if (!entry.deleted) notify(key, undefined)
+    }
+    for (const [key, { value, version }] of Object.entries(data.entries)) {
+      if ((entries.get(key)?.version ?? 0) >= version) continue
+      entries.set(key, { value, version })
+      notify(key, value)
+    }
+    sub.version = data.version
+  }
+
+  const resync = async (prefix, sub) => {
+    sub.stale = true
+    if (sub.syncing) return
+    sub.syncing = true
+    try {
+      while (sub.stale && subscriptions.get(prefix) === sub) {
+        sub.stale = false
+        const data = unwrapNative(
+          await window.getStateSince(sub.version, prefix),
+          'getStateSince failed'
+        )
+        if (data.resync) {
+          loadSnapshot(prefix, sub, data)
+          continue
+        }
+        if (!data.deltas.every((delta) => applyDelta(sub, delta))) {
+          // Log inconsistente com o local: snapshot inteiro
+          const snapshot = await window.subscribeState(windowId, prefix)
+          loadSnapshot(prefix, sub, unwrapNative(snapshot, 'resync failed'))
+          continue
+        }
+        sub.version = Math.max(sub.version, data.version)
+      }
+    } finally {
+      sub.syncing = false
+    }
+  }
+
+  window.addEventListener('native-event', (event) => {
+    const delta = event?.detail
+    if (delta?.type !== 'state.delta') return
+    for (const [prefix, sub] of subscriptions) {
+      if (!delta.key.startsWith(prefix)) continue
+      if (sub.buffer) sub.buffer.push(delta)
+      else if (!applyDelta(sub, delta)) {
+        resync(prefix, sub).catch(console.error)
+      }
+    }
+  })
+
+  // listener(key, value): value undefined = chave removida
+  window.subscribeNativeState = async (prefix, listener) => {
+    let sub = subscriptions.get(prefix)
+    if (!sub) {
+      // Deltas que chegam antes do snapshot esperam no buffer
+      sub = { version: 0, listeners: new Set(), buffer: [] }
+      subscriptions.set(prefix, sub)
+      sub.ready = window
+        .subscribeState(windowId, prefix)
+        .then((result) => {
+          const data = unwrapNative(result, 'subscribeState failed')
+          loadSnapshot(prefix, sub, data)
+          const buffered = sub.buffer
+          sub.buffer = null
+          if (!buffered.every((delta) => applyDelta(sub, delta))) {
+            return resync(prefix, sub)
+          }
+        })
+        .catch((error) => {
+          subscriptions.delete(prefix)
+          throw error
+        })
+    }
+    await sub.ready
+    if (listener) {
+      sub.listeners.add(listener)
+      // Quem assina depois recebe o estado atual antes dos deltas
+      for (const [key, entry] of entries) {
+        if (key.startsWith(prefix) && !entry.deleted) listener(key, entry.value)
+      }
+    }
+    return {
+      get: (key) => {
+        const entry = entries.get(key)
+        return entry && !entry.deleted ? entry.value : undefined
+      },
+      unsubscribe: () => {
+        if (listener) sub.listeners.delete(listener)
+        if (sub.listeners.size > 0 || subscriptions.get(prefix) !== sub) {
+          return
+        }
+        subscriptions.delete(prefix)
+        window.unsubscribeState(windowId, prefix).catch(() => {})
+      }
+    }
+  }
+
+  window.setNativeState = async (key, value) =>
+    unwrapNative(await window.setState(key, value), 'setState failed')
+  window.deleteNativeState = async (key) =>
+    unwrapNative(await window.deleteState(key), 'deleteState failed')
+
+  // Documento regravado a cada mudança (ex: layout): só o diff contra o
+  // último valor que esta janela gravou vai pelo bridge, como patch sobre
+  // a versão que o nativo deu a ele. Se outra escrita chegou no meio
+  // (conflito, 409), vai o valor inteiro; qualquer outro erro sobe para
+  // quem chamou. O valor passa a ser referência: não altere depois de
+  // gravar.
+  const STATE_CONFLICT = 409
+  const writes = new Map() // key -> { value, version, pending }
+  window.syncNativeState = (key, value) => {
+    let state = writes.get(key)
+    if (!state) {
+      state = { value: undefined, version: 0, pending: Promise.resolve() }
+      writes.set(key, state)
+    }
+    const write = async () => {
+      if (state.version) {
+        const patch = diffJson(state.value, value)
+        if (patch.length === 0) return state.version
+        const result = await window.patchState(key, state.version, patch)
+        if (result?.error?.code !== STATE_CONFLICT) {
+          state.version = unwrapNative(result, 'patchState failed')
+          state.value = value
+          return state.version
+        }
+      }
+      const result = await window.setState(key, value)
+      state.version = unwrapNative(result, 'setState failed')
+      state.value = value
+      return state.version
+    }
+    const promise = state.pending.then(write)
+    state.pending = promise.catch(() => {})
+    return promise
+  }
+}
+
+installNativeState()
+
+const reportStartup = createStartupReporter()
+if (reportStartup) {
+  // Módulos rodam antes do DOMContentLoaded
+  document.addEventListener(
+    'DOMContentLoaded',
+    () => reportStartup('dom-content-loaded'),
+    { once: true }
+  )
+}
+
 installNativeWindowOpen()
 installNativeMessageBridge()
 
 const app = createApp(App)
 registerDockPanels(app)
 app.mount('#app')
+
+if (reportStartup) {
+  // Dois frames após o mount: o primeiro frame com a UI já foi pintado
+  requestAnimationFrame(() =>
+    requestAnimationFrame(() => reportStartup('first-paint'))
+  )
+}
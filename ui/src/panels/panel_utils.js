@@ -1,11 +1,55 @@
+// Retângulo nativo da janela atual em coordenadas de tela, mantido pelo
+// evento 'native-window.geometry'. No WebKitGTK, window.screenX/screenY nem
+// sempre acompanham o movimento da janela; o nativo vem do configure-event.
+let nativeWindowBounds = null
+let geometryTrackingInstalled = false
+
+function currentWindowId() {
+    const params = new URLSearchParams(window.location.search)
+    return params.get('wid') || window.__APP_WINDOW_ID__ || 'main'
+}
+
+function handleGeometryEvent(event) {
+    const detail = event?.detail
+    if (detail?.type !== 'native-window.geometry') {
+        return
+    }
+    if (detail.payload?.windowId !== currentWindowId()) {
+        return
+    }
+    nativeWindowBounds = detail.payload.bounds || null
+}
+
+export function installNativeGeometryTracking() {
+    if (geometryTrackingInstalled) {
+        return
+    }
+    geometryTrackingInstalled = true
+    window.addEventListener('native-event', handleGeometryEvent)
+
+    if (typeof window.getNativeWindowGeometry !== 'function') {
+        return
+    }
+    Promise.resolve(window.getNativeWindowGeometry(currentWindowId()))
+        .then((bounds) => {
+            // Um evento pode ter chegado antes da resposta: ele é mais novo
+            if (bounds && !nativeWindowBounds) {
+                nativeWindowBounds = bounds
+            }
+        })
+        .catch(() => {})
+}
+
 export function getPanelBounds(element) {
     if (!element) {
         return {}
     }
 
     const rect = element.getBoundingClientRect()
-    const screenX = window.screenX ?? window.screenLeft ?? 0
-    const screenY = window.screenY ?? window.screenTop ?? 0
+    const screenX =
+        nativeWindowBounds?.left ?? window.screenX ?? window.screenLeft ?? 0
+    const screenY =
+        nativeWindowBounds?.top ?? window.screenY ?? window.screenTop ?? 0
     const offsetY = Math.max(0, window.outerHeight - window.innerHeight)
 
     return {
@@ -2,11 +2,25 @@ import { defineConfig } from "vite"
 import { viteSingleFile } from "vite-plugin-singlefile"
 import vue from "@vitejs/plugin-vue"
 
+// O app nativo serve dist/ via app:// (Linux) e aproveita code splitting.
+// Plataformas que ainda usam set_html precisam de um index.html autocontido:
+// o CMake exporta APP_UI_SINGLEFILE=1 nesse caso.
+const singleFile = process.env.APP_UI_SINGLEFILE === "1"
+
+// --cross-origin-isolated: o app exporta APP_CROSS_ORIGIN_ISOLATED=1 ao
+// iniciar o dev server, espelhando os headers servidos via app://
+const crossOriginIsolated = process.env.APP_CROSS_ORIGIN_ISOLATED === "1"
+const isolationHeaders = {
+	"Cross-Origin-Opener-Policy": "same-origin",
+	"Cross-Origin-Embedder-Policy": "require-corp",
+	"Cross-Origin-Resource-Policy": "same-origin",
+}
+
 export default defineConfig(({ mode }) => ({
 	// ============================================================================
 	// Plugins
 	// ============================================================================
-	plugins: [vue(), viteSingleFile()],
+	plugins: singleFile ? [vue(), viteSingleFile()] : [vue()],
 
 	// ============================================================================
 	// Dev Server (para hot reload no WebView)
@@ -15,7 +29,8 @@ export default defineConfig(({ mode }) => ({
 	server: {
 		host: "127.0.0.1",   // WebView acessa fácil
 		port: 5173,
-		strictPort: true,    // falha se porta ocupada (app nativo precisa saber a porta)
+		strictPort: false,   // porta ocupada: o app nativo lê a URL real da linha "Local:"
+		headers: crossOriginIsolated ? isolationHeaders : undefined,
 		watch: {
 			// Ignorar arquivos que não são do frontend
 			ignored: ["**/dist/**", "**/*.h"],